@@ -57,6 +57,7 @@
 #define CFG_MSFS_FILENAME CFG_DIR"/fsaccess_msfs.cfg"
 #define CFG_FGFS_FILENAME CFG_DIR"/fsaccess_fgfs.cfg"
 #define CFG_XPLANE_FILENAME CFG_DIR"/fsaccess_xplane.cfg"
+#define CFG_XPLANE_REPLAY_FILENAME CFG_DIR"/fsaccess_xplane_replay.cfg"
 #define CFG_NAVDATA_FILENAME CFG_DIR"/navdata.cfg"
 #define CFG_NAVDATA_INDEX_FILENAME CFG_DIR"/navdata_index.cfg"
 #define CFG_AUTOPILOT_FILENAME CFG_DIR"/autopilot.cfg"
@@ -93,6 +94,7 @@
 #define CFG_STARTUP_COUNTER "startup_counter"
 #define CFG_FS_ACCESS_TYPE "fs_access_type"
 #define CFG_LOGFILE_NAME "vasfmc.log"
+#define METRICS_EXPORT_FILENAME "vasfmc_metrics.csv"
 #define CFG_PERSISTANCE_FILE "persistence_file"
 #define SPLASHSCREEN_FILE "graphics/vasfmc-splash.png"
 #define SPLASH_SHOW_TIME_MS 3000
@@ -122,6 +124,7 @@
 
 #define FS_ACCESS_TYPE_MSFS "msfs"
 #define FS_ACCESS_TYPE_XPLANE "xplane"
+#define FS_ACCESS_TYPE_XPLANE_REPLAY "xplane_replay"
 #define FS_ACCESS_TYPE_FGFS "fgfs"
 
 #define FS_TIME_SYNC_MAX_DIFF_SEC 60
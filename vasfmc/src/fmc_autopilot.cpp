@@ -31,6 +31,7 @@
 #include "fsaccess.h"
 #include "flight_mode_tracker.h"
 #include "aircraft_data.h"
+#include "delta_sync.h"
 
 #include "defines.h"
 #include "fmc_autopilot.h"
@@ -74,11 +75,11 @@ FMCAutopilot::FMCAutopilot(ConfigWidgetProvider* config_widget_provider,
 
     // mode stuff
 
-    m_lateral_mode_calc_timer = QTime::currentTime().addSecs(-60);
-    m_lateral_mode_active_changed_time = QTime::currentTime().addSecs(-60);
+    m_lateral_mode_calc_timer.setElapsed(60000);
+    m_lateral_mode_active_changed_time.setElapsed(60000);
 
-    m_vertical_mode_calc_timer = QTime::currentTime().addSecs(-60);
-    m_vertical_mode_active_changed_time = QTime::currentTime().addSecs(-60);
+    m_vertical_mode_calc_timer.setElapsed(60000);
+    m_vertical_mode_active_changed_time.setElapsed(60000);
 
     // takeoff stuff
 
@@ -157,19 +158,7 @@ void FMCAutopilot::slotRefresh()
         m_ils_mode = ILS_MODE_NONE;
     }
 
-    // FBW processing
-
-    if (m_fmc_control->fbwEnabled())
-    {
-        m_fmc_control->bankController()->execBankRate(m_fmc_control->fsAccess());
-        m_fmc_control->pitchController()->execPitchRate(m_fmc_control->fsAccess());
-    }
-    else
-    {
-        m_fmc_control->fsAccess().freeControlAxes();
-        m_fmc_control->bankController()->reset();
-        m_fmc_control->pitchController()->reset();
-    }
+    // the FBW controllers run in their own scheduler task, see FMCControl::execFBW()
     
     // flight director and autopilot checks
 
@@ -1949,19 +1938,19 @@ void FMCAutopilot::slotToggleAutopilot()
 
 /////////////////////////////////////////////////////////////////////////////
 
-void FMCAutopilot::operator>>(QDataStream& out) const
+void FMCAutopilot::writeSyncValues(DeltaSyncFields& out) const
 {
     out << (qint16) m_ils_mode
         << (qint16) m_lateral_mode_active
         << (qint16) m_lateral_mode_armed
-        << lateralModeActiveChangeTimeMs()
+        << qMin(lateralModeActiveChangeTimeMs(), (uint)DELTA_SYNC_ELAPSED_LIMIT_MS)
         << isNAVCoupled()
         << m_last_nav_calculated_heading
         << isNAVHoldActive()
         << isHeadingHoldActive()
         << (qint16) m_vertical_mode_active
         << (qint16) m_vertical_mode_armed
-        << verticalModeActiveChangeTimeMs()
+        << qMin(verticalModeActiveChangeTimeMs(), (uint)DELTA_SYNC_ELAPSED_LIMIT_MS)
         << isVsModeEnabled()
         << isFlightPathModeEnabled()
         << isVsModeActive()
@@ -1981,6 +1970,34 @@ void FMCAutopilot::operator>>(QDataStream& out) const
 
 /////////////////////////////////////////////////////////////////////////////
 
+void FMCAutopilot::operator>>(QDataStream& out) const
+{
+    DeltaSyncFields fields;
+    writeSyncValues(fields);
+    fields.writeTo(out);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCAutopilot::syncFields(QList<QByteArray>& fields) const
+{
+    DeltaSyncFields sync_fields;
+    writeSyncValues(sync_fields);
+    fields = sync_fields.fields();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCAutopilot::setSyncFields(const QList<QByteArray>& fields)
+{
+    QByteArray data = DeltaSyncFields::join(fields);
+    QDataStream ds(data);
+    *this << ds;
+    MYASSERT(ds.atEnd());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 void FMCAutopilot::operator<<(QDataStream& in)
 {
     qint16 ils_mode, lateral_mode_active, lateral_mode_armed, vertical_mode_active, vertical_mode_armed;
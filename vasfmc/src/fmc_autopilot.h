@@ -29,12 +29,14 @@
 #include <QTime>
 #include <QTimer>
 
+#include "clock.h"
 #include "config.h"
 #include "serialization_iface.h"
 
 #include "fmc_autopilot_defines.h"
 
 class FMCControl;
+class DeltaSyncFields;
 class FMCData;
 class FlightStatus;
 class Waypoint;
@@ -94,6 +96,12 @@ public:
     virtual void operator<<(QDataStream& in);
     virtual void operator>>(QDataStream& out) const;
 
+    //! splits the state into one field per value for the delta sync to the slave FMCs
+    void syncFields(QList<QByteArray>& fields) const;
+
+    //! sets the state from the fields of syncFields()
+    void setSyncFields(const QList<QByteArray>& fields);
+
     //----- ILS mode
 
     ILS_MODE ilsMode() const { return m_ils_mode; }
@@ -174,6 +182,9 @@ public slots:
 
 protected:
 
+    //! streams the synced values, one field each
+    void writeSyncValues(DeltaSyncFields& out) const;
+
     void setupDefaultConfig();
 
     //! init
@@ -218,17 +229,17 @@ protected:
 
     ILS_MODE m_ils_mode;
 
-    QTime m_refresh_detector;
+    ClockTimer m_refresh_detector;
 
-    QTime m_lateral_mode_calc_timer;
+    ClockTimer m_lateral_mode_calc_timer;
     LATERAL_MODE m_lateral_mode_active;
     LATERAL_MODE m_lateral_mode_armed;
-    QTime m_lateral_mode_active_changed_time;
+    ClockTimer m_lateral_mode_active_changed_time;
 
-    QTime m_vertical_mode_calc_timer;
+    ClockTimer m_vertical_mode_calc_timer;
     VERTICAL_MODE m_vertical_mode_active;
     VERTICAL_MODE m_vertical_mode_armed;
-    QTime m_vertical_mode_active_changed_time;
+    ClockTimer m_vertical_mode_active_changed_time;
 
     double m_flightpath_angle;
     int m_vertical_speed;
@@ -250,7 +261,7 @@ protected:
     double m_takeoff_lateral_target_track;
 
     double m_takeoff_vertical_speed_hold_kts;
-    QTime m_takeoff_vertical_speed_hold_engaged_dt;
+    ClockTimer m_takeoff_vertical_speed_hold_engaged_dt;
 
     QTimer m_lateral_fd_source_reset_timer;
     QTimer m_vertical_fd_source_reset_timer;
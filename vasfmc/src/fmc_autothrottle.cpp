@@ -30,6 +30,7 @@
 #include "flightstatus.h"
 #include "fsaccess.h"
 #include "aircraft_data.h"
+#include "delta_sync.h"
 
 
 #include "defines.h"
@@ -90,8 +91,8 @@ FMCAutothrottle::FMCAutothrottle(ConfigWidgetProvider* config_widget_provider,
 
     // mode stuff
 
-    m_speed_mode_calc_timer = QTime::currentTime().addSecs(-60);
-    m_speed_mode_active_changed_time = QTime::currentTime().addSecs(-60);
+    m_speed_mode_calc_timer.setElapsed(60000);
+    m_speed_mode_active_changed_time.setElapsed(60000);
     m_idle_thrust_timer_triggered = false;
 
     // climb thrust
@@ -1158,7 +1159,7 @@ uint FMCAutothrottle::airbusDetentCount(AIRBUS_THROTTLE_MODE prev_mode, AIRBUS_T
 
 /////////////////////////////////////////////////////////////////////////////
 
-void FMCAutothrottle::operator>>(QDataStream& out) const
+void FMCAutothrottle::writeSyncValues(DeltaSyncFields& out) const
 {
     out << isAPThrottleArmed()
         << isAPThrottleEngaged()
@@ -1169,7 +1170,7 @@ void FMCAutothrottle::operator>>(QDataStream& out) const
         << getAPThrottleN1Target()
         << (qint16)m_speed_mode_active
         << (qint16)m_speed_mode_armed
-        << speedModeActiveChangeTimeMs()
+        << qMin(speedModeActiveChangeTimeMs(), (uint)DELTA_SYNC_ELAPSED_LIMIT_MS)
         << m_current_climb_thrust
         << m_more_drag_necessary
         << (qint8)m_use_airbus_throttle_mode
@@ -1178,6 +1179,34 @@ void FMCAutothrottle::operator>>(QDataStream& out) const
 
 /////////////////////////////////////////////////////////////////////////////
 
+void FMCAutothrottle::operator>>(QDataStream& out) const
+{
+    DeltaSyncFields fields;
+    writeSyncValues(fields);
+    fields.writeTo(out);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCAutothrottle::syncFields(QList<QByteArray>& fields) const
+{
+    DeltaSyncFields sync_fields;
+    writeSyncValues(sync_fields);
+    fields = sync_fields.fields();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCAutothrottle::setSyncFields(const QList<QByteArray>& fields)
+{
+    QByteArray data = DeltaSyncFields::join(fields);
+    QDataStream ds(data);
+    *this << ds;
+    MYASSERT(ds.atEnd());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 void FMCAutothrottle::operator<<(QDataStream& in)
 {
     qint16 speed_mode_active, speed_mode_armed, current_airbus_throttle_mode;
@@ -27,6 +27,7 @@
 
 #include <QObject>
 
+#include "clock.h"
 #include "config.h"
 #include "serialization_iface.h"
 #include "flight_mode_tracker.h"
@@ -37,6 +38,7 @@
 #include "fmc_autothrottle_defines.h"
 
 class FMCControl;
+class DeltaSyncFields;
 class FMCData;
 class FlightStatus;
 class Waypoint;
@@ -83,6 +85,12 @@ public:
     virtual void operator<<(QDataStream& in);
     virtual void operator>>(QDataStream& out) const;
 
+    //! splits the state into one field per value for the delta sync to the slave FMCs
+    void syncFields(QList<QByteArray>& fields) const;
+
+    //! sets the state from the fields of syncFields()
+    void setSyncFields(const QList<QByteArray>& fields);
+
     //----- getter
 
     bool isAPThrottleArmed() const;
@@ -142,6 +150,9 @@ protected slots:
 
 protected:
 
+    //! streams the synced values, one field each
+    void writeSyncValues(DeltaSyncFields& out) const;
+
     void setupDefaultConfig();
 
     //! calculates and sets the autothrottle
@@ -181,25 +192,25 @@ protected:
 
     bool m_was_acceleration_set;
 
-    QTime m_speed_mode_calc_timer;
+    ClockTimer m_speed_mode_calc_timer;
     SPEED_MODE m_speed_mode_active;
     SPEED_MODE m_speed_mode_armed;
-    QTime m_speed_mode_active_changed_time;
+    ClockTimer m_speed_mode_active_changed_time;
 
     bool m_idle_thrust_timer_triggered;
-    QTime m_idle_thrust_timer;
+    ClockTimer m_idle_thrust_timer;
 
     double m_current_takeoff_thrust;
     double m_current_flex_thrust;
     double m_current_max_continous_thrust;
-    QTime m_climb_thrust_calculate_timer;
+    ClockTimer m_climb_thrust_calculate_timer;
     double m_current_climb_thrust;
 
     bool m_more_drag_necessary;
     bool m_more_drag_necessary_timer_started;
-    QTime m_more_drag_necessary_timer;
+    ClockTimer m_more_drag_necessary_timer;
     bool m_more_drag_necessary_end_timer_started;
-    QTime m_more_drag_necessary_end_timer;
+    ClockTimer m_more_drag_necessary_end_timer;
 
     bool m_use_airbus_throttle_mode;
     AIRBUS_THROTTLE_MODE m_current_airbus_throttle_mode;
@@ -29,6 +29,7 @@
 #include "fly_by_wire.h"
 #include "flight_mode_tracker.h"
 #include "checklist.h"
+#include "metrics.h"
 
 #include "fmc_data.h"
 #include "fmc_control.h"
@@ -53,8 +54,10 @@ const QString FMCCDUPageStyleAMenu::SYSTEM_CHECKLIST = "CHECKLIST";
 const QString FMCCDUPageStyleAMenu::SYSTEM_INTERFACES = "INTERFACES";
 const QString FMCCDUPageStyleAMenu::SYSTEM_DISPLAY1 = "DISPLAY1";
 const QString FMCCDUPageStyleAMenu::SYSTEM_DISPLAY2 = "DISPLAY2";
+const QString FMCCDUPageStyleAMenu::SYSTEM_DIAGNOSTICS = "DIAGNOSTICS";
 
 #define MAX_CHECKLIST_ITEMS_PER_PAGE 10
+#define MAX_DIAGNOSTICS_ENTRIES_PER_PAGE 5
 
 /////////////////////////////////////////////////////////////////////////////
 
@@ -106,6 +109,7 @@ void FMCCDUPageStyleAMenu::paintPage(QPainter& painter) const
         drawTextLeft(painter, 1, 7, "<SQUAWKBOX");
         if (fmcControl().isMSFSActive()) drawTextLeft(painter, 1, 9, "<PUSHBACK");
         drawTextLeft(painter, 1, 11, "<CHECKLIST");
+        drawTextLeft(painter, 1, 13, "<DIAGNOSTICS");
 
         drawTextRight(painter, 1, 3, "SETTINGS>");
         drawTextRight(painter, 1, 5, "FBW BANK>");
@@ -621,6 +625,32 @@ void FMCCDUPageStyleAMenu::paintPage(QPainter& painter) const
         drawTextRight(painter, 1, 5, fmcControl().useCPFlight() ? "ON ->" : "OFF ->", CYAN);
 #endif
     }
+    else if (m_selected_system == SYSTEM_DIAGNOSTICS)
+    {
+        setFont(painter, NORM_FONT, QFont::Bold);
+        drawTextCenter(painter, 1, "DIAGNOSTICS");
+
+        QStringList name_list;
+        QStringList info_list;
+        QStringList value_list;
+        getDiagnosticsEntries(name_list, info_list, value_list);
+
+        int line = 2;
+        for(int index = m_vertical_scroll_offset; 
+            index < name_list.count() && line < 2 + 2*MAX_DIAGNOSTICS_ENTRIES_PER_PAGE; ++index)
+        {
+            setFont(painter, SMALL_FONT);
+            drawTextLeft(painter, 2, line, name_list[index]);
+            drawTextRight(painter, 2, line, info_list[index]);
+
+            setFont(painter, NORM_FONT);
+            drawTextLeft(painter, 1, line+1, value_list[index], GREEN);
+            line += 2;
+        }
+
+        drawTextLeft(painter, 1, 13, "<RESET", CYAN);
+        drawTextRight(painter, 1, 13, "EXPORT>", CYAN);
+    }
     else if (m_selected_system == SYSTEM_DISPLAY1)
     {
         setFont(painter, NORM_FONT, QFont::Bold);
@@ -776,6 +806,10 @@ void FMCCDUPageStyleAMenu::processAction(const QString& action)
                 setDrawHorizontalScrollPageCounter(false);
                 slotSetVerticalScrollOffsetForChecklist();
                 break;
+            case(6):
+                m_selected_system = SYSTEM_DIAGNOSTICS;
+                m_vertical_scroll_offset = 0;
+                break;
         }
 
         switch(rlsk_index)
@@ -1638,6 +1672,28 @@ void FMCCDUPageStyleAMenu::processAction(const QString& action)
 #endif
         }
     }
+    else if (m_selected_system == SYSTEM_DIAGNOSTICS)
+    {
+        if (llsk_index == 6)
+        {
+            MetricsRegistry::registry()->reset();
+        }
+        else if (rlsk_index == 6)
+        {
+            QString filename = 
+                fmcControl().mainConfig().getValue(CFG_VASFMC_DIR)+"/"+METRICS_EXPORT_FILENAME;
+
+            if (MetricsRegistry::registry()->exportToFile(filename))
+            {
+                Logger::log(QString("FMCCDUPageStyleAMenu:processAction: exported metrics to (%1)").arg(filename));
+                m_page_manager->scratchpad().setOverrideText("METRICS EXPORTED");
+            }
+            else
+            {
+                m_page_manager->scratchpad().setOverrideText("EXPORT FAILED");
+            }
+        }
+    }
     else if (m_selected_system == SYSTEM_INTERFACES)
     {
         bool convok = false;
@@ -1718,6 +1774,46 @@ void FMCCDUPageStyleAMenu::clearICAORoute()
 
 /////////////////////////////////////////////////////////////////////////////
 
+void FMCCDUPageStyleAMenu::getDiagnosticsEntries(QStringList& name_list, 
+                                                 QStringList& info_list, 
+                                                 QStringList& value_list) const
+{
+    const MetricsRegistry* registry = MetricsRegistry::registry();
+
+    QStringList histogram_name_list = registry->histogramNames();
+    QStringList::const_iterator iter = histogram_name_list.begin();
+    for(; iter != histogram_name_list.end(); ++iter)
+    {
+        const LatencyHistogram* histogram = registry->histogram(*iter);
+        MYASSERT(histogram != 0);
+
+        name_list.append(*iter);
+        info_list.append("P50/P99/MAX");
+        value_list.append(QString("%1/%2/%3 MS").
+                          arg(histogram->percentileUs(50.0) / 1000.0, 0, 'f', 2).
+                          arg(histogram->percentileUs(99.0) / 1000.0, 0, 'f', 2).
+                          arg(histogram->maxUs() / 1000.0, 0, 'f', 2));
+    }
+
+    QStringList counter_name_list = registry->counterNames();
+    for(iter = counter_name_list.begin(); iter != counter_name_list.end(); ++iter)
+    {
+        name_list.append(*iter);
+        info_list.append("COUNT");
+        value_list.append(QString::number(registry->counter(*iter)));
+    }
+
+    QStringList gauge_name_list = registry->gaugeNames();
+    for(iter = gauge_name_list.begin(); iter != gauge_name_list.end(); ++iter)
+    {
+        name_list.append(*iter);
+        info_list.append("VALUE");
+        value_list.append(QString::number(registry->gauge(*iter)));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 void FMCCDUPageStyleAMenu::slotGotWeather(const QString& airport, const QString& date_string, const QString& weather_string)
 {
     m_vertical_scroll_offset = 0;
@@ -1822,6 +1918,13 @@ uint FMCCDUPageStyleAMenu::maxVerticalScrollOffset() const
         return qMax(0, fmcControl().checklistManager().currentChecklist().count() - MAX_CHECKLIST_ITEMS_PER_PAGE);
     }
 
+    if (m_selected_system == SYSTEM_DIAGNOSTICS)
+    {
+        const MetricsRegistry* registry = MetricsRegistry::registry();
+        return qMax(0, registry->histogramNames().count() + registry->counterNames().count() + 
+                    registry->gaugeNames().count() - MAX_DIAGNOSTICS_ENTRIES_PER_PAGE);
+    }
+
     return 0;
 }
 
@@ -59,6 +59,7 @@ public:
     static const QString SYSTEM_INTERFACES;
     static const QString SYSTEM_DISPLAY1;
     static const QString SYSTEM_DISPLAY2;
+    static const QString SYSTEM_DIAGNOSTICS;
 
     FMCCDUPageStyleAMenu(const QString& page_name, FMCCDUPageManager* page_manager);
     virtual ~FMCCDUPageStyleAMenu();
@@ -86,6 +87,10 @@ protected:
 
     void clearICAORoute();
 
+    //! fills one entry per metric of the metrics registry into the lists:
+    //! the name, what the value is and the value
+    void getDiagnosticsEntries(QStringList& name_list, QStringList& info_list, QStringList& value_list) const;
+
 protected:
 
     QString m_selected_system;
@@ -32,6 +32,7 @@
 #include "config.h"
 #include "assert.h"
 #include "logger.h"
+#include "metrics.h"
 #include "pushbutton.h"
 #include "vas_path.h"
 
@@ -665,6 +666,8 @@ bool FMCCDUStyleA::eventFilter(QObject * watched_object, QEvent* event)
 
 void FMCCDUStyleA::paintMe(QPainter& painter)
 {
+    MetricsScope metrics_scope("CD.PAINT");
+
     if (!isVisible() || (m_fmc_control->flightStatus()->isValid() && !m_fmc_control->flightStatus()->battery_on)) 
     {
         painter.setBackground(QBrush(BLACK));
@@ -28,12 +28,14 @@
 #include "assert.h"
 #include "config.h"
 #include "logger.h"
+#include "metrics.h"
 #include "vas_path.h"
 
 #include "navcalc.h"
 #include "airway.h"
 #include "holding.h"
 #include "fsaccess_xplane.h"
+#include "fsaccess_xplane_replay.h"
 #include "projection.h"
 #include "geodata.h"
 #include "aircraft_data.h"
@@ -75,7 +77,7 @@ FMCControl::FMCControl(ConfigWidgetProvider* config_widget_provider,
     m_fmc_data(0), m_flight_mode_tracker(0), m_fmc_sounds_handler(0),
     m_flightstatus(new FlightStatus(cfg->getIntValue(CFG_FLIGHTSTATUS_SMOOTHING_DELAY_MS))),
     m_fs_access(0), m_flight_status_checker(0), m_last_flight_status_checker_style(-1),
-    m_navdata(0), m_pbd_counter(0), m_declination_calc(cfg->getValue(CFG_DECLINATION_DATAFILE)),
+    m_scheduler(FMC_SCHEDULER_TICK_BUDGET_MS), m_navdata(0), m_pbd_counter(0), m_declination_calc(cfg->getValue(CFG_DECLINATION_DATAFILE)),
     m_aircraft_data(new AircraftData(m_flightstatus)), m_aircraft_data_confirmed(false),
     m_checklist_manager(0),
     m_cdu_left_handler(0), m_cdu_right_handler(0),
@@ -93,7 +95,6 @@ FMCControl::FMCControl(ConfigWidgetProvider* config_widget_provider,
     m_date_time_sync_timer.start();
     MYASSERT(Declination::globalDeclination() != 0);
     MYASSERT(m_aircraft_data != 0);
-    m_fmc_connect_master_mode_sync_timer.start();
 
     m_fmc_data = new FMCData(cfg, m_flightstatus);
     MYASSERT(m_fmc_data != 0);
@@ -147,6 +148,8 @@ FMCControl::FMCControl(ConfigWidgetProvider* config_widget_provider,
 
     MYASSERT(m_pitch_controller != 0);
 
+    m_fbw_was_enabled = true;
+
     // init aircraft data
 
     Logger::log("setup aircraft data");
@@ -205,22 +208,12 @@ FMCControl::FMCControl(ConfigWidgetProvider* config_widget_provider,
 
     m_pfdnd_refresh_timer.start();
     m_ecam_refresh_timer.start();
-    m_ap_athr_refresh_timer.start();
-    m_cdufcu_refresh_timer.start();
-    m_fsctrl_poll_timer.start();
 
-    m_pfdnd_refresh_ms = 1000;
-    m_ecam_refresh_ms = 1000;
-    m_ap_athr_refresh_ms = 1000;
-    m_cdufcu_refresh_ms = 1000;
+    recalcRefreshTimes();
 
     m_pfdnd_refresh_index = 0;
-    m_ap_athr_refresh_index = 0;
-    m_cdufcu_refresh_index = 0;
-    m_fsctrl_poll_index = 0;
 
-    // setup control timer
-    m_control_timer.start();
+    setupScheduler();
 
     MYASSERT(connect(&m_pushback_timer, SIGNAL(timeout()), this, SLOT(slotPushBackTimer())));
 
@@ -523,6 +516,11 @@ void FMCControl::setupFsAccess()
         Logger::log("Switching to XPLANE access");
         m_fs_access = new FSAccessXPlane(m_config_widget_provider, CFG_XPLANE_FILENAME, m_flightstatus);
     }
+    else if (m_main_config->getValue(CFG_FS_ACCESS_TYPE) == FS_ACCESS_TYPE_XPLANE_REPLAY)
+    {
+        Logger::log("Switching to XPLANE replay");
+        m_fs_access = new FSAccessXPlaneReplay(m_config_widget_provider, CFG_XPLANE_REPLAY_FILENAME, m_flightstatus);
+    }
 
     //switchToXPlane();
 
@@ -551,81 +549,151 @@ void FMCControl::recalcFlightstatus()
 
 /////////////////////////////////////////////////////////////////////////////
 
-void FMCControl::slotCentralTimer()
+void FMCControl::recalcRefreshTimes()
 {
-    QTime overall_timer;
-    overall_timer.start();
-
-    //TODO implement load balancing
-    slotControlTimer();
+    m_ap_athr_refresh_ms = Navcalc::round(m_main_config->getIntValue(CFG_FLIGHTSTATUS_SMOOTHING_DELAY_MS)/8.0);
+    m_pfdnd_refresh_ms = Navcalc::round(m_control_cfg->getIntValue(CFG_PFDND_REFRESH_PERIOD_MS) / 2.0);
+    m_ecam_refresh_ms = Navcalc::round(m_control_cfg->getIntValue(CFG_ECAM_REFRESH_PERIOD_MS) / 1.0);
+    m_cdufcu_refresh_ms = Navcalc::round(m_control_cfg->getIntValue(CFG_CDUFCU_REFRESH_PERIOD_MS) / 2.0);
+}
 
-    if (m_fmc_processor != 0) m_fmc_processor->slotRefresh(false);
-    if (m_cpflight_serial != 0) m_cpflight_serial->slotWriteValues(false);
-    if (m_fmc_sounds_handler->fmcSounds() != 0) m_fmc_sounds_handler->fmcSounds()->slotCheckSoundsTimer();
+/////////////////////////////////////////////////////////////////////////////
 
-    m_flight_mode_tracker->slotCheckAndSetFlightMode();
+void FMCControl::setupScheduler()
+{
+    // the autopilot and the autothrottle run alternating, the periods
+    // depending on the config are updated by slotControlTimer()
+
+    m_scheduler.addTask(SCHEDULER_TASK_CONTROL, "CTRL", FMCScheduler::TASK_CRITICAL,
+                        FMC_SCHEDULER_CONTROL_PERIOD_MS, FMC_SCHEDULER_CONTROL_PERIOD_MS, 1,
+                        FMC_SCHEDULER_CONTROL_PERIOD_MS);
+    m_scheduler.addTask(SCHEDULER_TASK_SYNC, "SYNC", FMCScheduler::TASK_CRITICAL,
+                        FMC_CONNECT_SYNC_PERIOD_MS, FMC_CONNECT_SYNC_PERIOD_MS, 1);
+    m_scheduler.addTask(SCHEDULER_TASK_PROCESSOR, "PROC", FMCScheduler::TASK_CRITICAL,
+                        FMC_SCHEDULER_PROCESSOR_PERIOD_MS, FMC_SCHEDULER_PROCESSOR_PERIOD_MS, 2);
+    m_scheduler.addTask(SCHEDULER_TASK_FLIGHT_MODE, "MODE", FMCScheduler::TASK_CRITICAL,
+                        FMC_SCHEDULER_FLIGHT_MODE_PERIOD_MS, FMC_SCHEDULER_FLIGHT_MODE_PERIOD_MS, 1);
+    m_scheduler.addTask(SCHEDULER_TASK_CDU_INPUT, "CDUIN", FMCScheduler::TASK_CRITICAL,
+                        FMC_SCHEDULER_CDU_INPUT_PERIOD_MS, FMC_SCHEDULER_CDU_INPUT_PERIOD_MS, 1);
+    m_scheduler.addTask(SCHEDULER_TASK_FBW, "FBW", FMCScheduler::TASK_CRITICAL,
+                        FMC_SCHEDULER_FBW_PERIOD_MS, FMC_SCHEDULER_FBW_PERIOD_MS, 1);
+    m_scheduler.addTask(SCHEDULER_TASK_AUTOPILOT, "AP", FMCScheduler::TASK_CRITICAL,
+                        2*m_ap_athr_refresh_ms, m_ap_athr_refresh_ms, 1);
+    m_scheduler.addTask(SCHEDULER_TASK_AUTOTHROTTLE, "ATHR", FMCScheduler::TASK_CRITICAL,
+                        2*m_ap_athr_refresh_ms, m_ap_athr_refresh_ms, 1, m_ap_athr_refresh_ms);
+    m_scheduler.addTask(SCHEDULER_TASK_CDU_REFRESH, "CDU", FMCScheduler::TASK_DEFERRABLE,
+                        2*m_cdufcu_refresh_ms, 2*m_cdufcu_refresh_ms, 5);
+    m_scheduler.addTask(SCHEDULER_TASK_CPFLIGHT, "CPF", FMCScheduler::TASK_DEFERRABLE,
+                        FMC_SCHEDULER_CPFLIGHT_PERIOD_MS, FMC_SCHEDULER_CPFLIGHT_PERIOD_MS, 1);
+    m_scheduler.addTask(SCHEDULER_TASK_SOUNDS, "SND", FMCScheduler::TASK_DEFERRABLE,
+                        FMC_SCHEDULER_SOUNDS_PERIOD_MS, FMC_SCHEDULER_SOUNDS_PERIOD_MS, 1);
+}
 
-    //----- process FS CTRL input
+/////////////////////////////////////////////////////////////////////////////
 
-    if (m_fsctrl_poll_timer.elapsed() > 50)
+void FMCControl::runSchedulerTask(int task_id)
+{
+    switch(task_id)
     {
-        switch(m_fsctrl_poll_index)
-        {
-            case(3): {
-                if (m_cdu_left_handler != 0 && m_cdu_left_handler->fmcCduBase() != 0) 
-                    m_cdu_left_handler->fmcCduBase()->slotProcessInput();
-                if (m_cdu_right_handler != 0 && m_cdu_right_handler->fmcCduBase() != 0) 
-                    m_cdu_right_handler->fmcCduBase()->slotProcessInput();
-                break;
-            }
+        case(SCHEDULER_TASK_CONTROL): {
+            slotControlTimer();
+            break;
+        }
+        case(SCHEDULER_TASK_SYNC): {
+            syncStateToSlaves();
+            break;
+        }
+        case(SCHEDULER_TASK_PROCESSOR): {
+            if (m_fmc_processor != 0) m_fmc_processor->slotRefresh(false);
+            break;
+        }
+        case(SCHEDULER_TASK_FLIGHT_MODE): {
+            m_flight_mode_tracker->slotCheckAndSetFlightMode();
+            break;
+        }
+        case(SCHEDULER_TASK_CDU_INPUT): {
+            if (m_cdu_left_handler != 0 && m_cdu_left_handler->fmcCduBase() != 0) 
+                m_cdu_left_handler->fmcCduBase()->slotProcessInput();
+            if (m_cdu_right_handler != 0 && m_cdu_right_handler->fmcCduBase() != 0) 
+                m_cdu_right_handler->fmcCduBase()->slotProcessInput();
+            break;
+        }
+        case(SCHEDULER_TASK_FBW): {
+            execFBW();
+            break;
+        }
+        case(SCHEDULER_TASK_AUTOPILOT): {
+            m_fmc_autopilot->slotRefresh();
+            break;
+        }
+        case(SCHEDULER_TASK_AUTOTHROTTLE): {
+            m_fmc_autothrottle->slotRefresh();
+            break;
+        }
+        case(SCHEDULER_TASK_CDU_REFRESH): {
+            if (m_cdu_left_handler != 0 && m_cdu_left_handler->fmcCduBase() != 0) 
+                m_cdu_left_handler->fmcCduBase()->slotRefresh();
+            if (m_cdu_right_handler != 0 && m_cdu_right_handler->fmcCduBase() != 0) 
+                m_cdu_right_handler->fmcCduBase()->slotRefresh();
+            break;
+        }
+        case(SCHEDULER_TASK_CPFLIGHT): {
+            if (m_cpflight_serial != 0) m_cpflight_serial->slotWriteValues(false);
+            break;
+        }
+        case(SCHEDULER_TASK_SOUNDS): {
+            if (m_fmc_sounds_handler->fmcSounds() != 0) m_fmc_sounds_handler->fmcSounds()->slotCheckSoundsTimer();
+            break;
         }
-
-        m_fsctrl_poll_timer.start();
-        m_fsctrl_poll_index = ++m_fsctrl_poll_index % 5;
     }
+}
 
-    //----- either call the CDU or FCU in one run
+/////////////////////////////////////////////////////////////////////////////
 
-    if (m_cdufcu_refresh_timer.elapsed() >= m_cdufcu_refresh_ms)
-    {
-        switch(m_cdufcu_refresh_index)
-        {
-            case(0): {
-                if (m_cdu_left_handler != 0 && m_cdu_left_handler->fmcCduBase() != 0) 
-                    m_cdu_left_handler->fmcCduBase()->slotRefresh();
-                if (m_cdu_right_handler != 0 && m_cdu_right_handler->fmcCduBase() != 0) 
-                    m_cdu_right_handler->fmcCduBase()->slotRefresh();
-                break;
-            }
-        }
+void FMCControl::execFBW()
+{
+    if (m_fs_access == 0 || isFMCConnectModeSlave()) return;
 
-        m_cdufcu_refresh_index = 1 - m_cdufcu_refresh_index;
-        m_cdufcu_refresh_timer.start();
+    if (fbwEnabled())
+    {
+        m_bank_controller->execBankRate(*m_fs_access);
+        m_pitch_controller->execPitchRate(*m_fs_access);
+        m_fbw_was_enabled = true;
+    }
+    else if (m_fbw_was_enabled)
+    {
+        m_fs_access->freeControlAxes();
+        m_bank_controller->reset();
+        m_pitch_controller->reset();
+        m_fbw_was_enabled = false;
     }
+}
 
-    //----- either call the AP or ATHR in one run
+/////////////////////////////////////////////////////////////////////////////
 
-    if (m_ap_athr_refresh_timer.elapsed() >= m_ap_athr_refresh_ms)
-    {
-        switch(m_ap_athr_refresh_index)
-        {
-            case(0): {
-                m_fmc_autopilot->slotRefresh();
-                break;
-            }
-            case(1): {
-                m_fmc_autothrottle->slotRefresh();
-                break;
-            }
-        }
+void FMCControl::slotCentralTimer()
+{
+    QElapsedTimer overall_timer;
+    overall_timer.start();
+
+    // apply the data received since the last cycle before anything reads the flightstatus
+    if (m_fs_access != 0) m_fs_access->processReceivedData();
 
-        m_ap_athr_refresh_index = 1 - m_ap_athr_refresh_index;
-        m_ap_athr_refresh_timer.start();
+    m_scheduler.beginTick();
+
+    int task_id = -1;
+    while((task_id = m_scheduler.nextTask()) >= 0)
+    {
+        runSchedulerTask(task_id);
+        m_scheduler.finishTask(task_id);
     }
+
+    m_scheduler.endTick();
     
     if (overall_timer.elapsed() > 100) 
         Logger::log(QString("FMCControl:slotCentralTimer: elapsed = %1ms").arg(overall_timer.elapsed()));
 
+    MetricsRegistry::registry()->recordLatency("CT", overall_timer.nsecsElapsed() / 1000);
     emit signalTimeUsed("CT", overall_timer.elapsed());
 }
 
@@ -633,9 +701,6 @@ void FMCControl::slotCentralTimer()
 
 void FMCControl::slotControlTimer()
 {
-    if (m_control_timer.elapsed() < 250) return;
-    m_control_timer.start();
-
 #if DO_TIMER_LOGGING
     QTime overall_timer;
     overall_timer.start();
@@ -645,10 +710,15 @@ void FMCControl::slotControlTimer()
 
     // recalc refresh times
 
-    m_ap_athr_refresh_ms = Navcalc::round(m_main_config->getIntValue(CFG_FLIGHTSTATUS_SMOOTHING_DELAY_MS)/8.0);
-    m_pfdnd_refresh_ms = Navcalc::round(m_control_cfg->getIntValue(CFG_PFDND_REFRESH_PERIOD_MS) / 2.0);
-    m_ecam_refresh_ms = Navcalc::round(m_control_cfg->getIntValue(CFG_ECAM_REFRESH_PERIOD_MS) / 1.0);
-    m_cdufcu_refresh_ms = Navcalc::round(m_control_cfg->getIntValue(CFG_CDUFCU_REFRESH_PERIOD_MS) / 2.0);
+    recalcRefreshTimes();
+
+    if (m_scheduler.setPeriod(SCHEDULER_TASK_AUTOPILOT, 2*m_ap_athr_refresh_ms, m_ap_athr_refresh_ms))
+    {
+        // keep the autothrottle half a period after the autopilot
+        m_scheduler.setPeriod(SCHEDULER_TASK_AUTOTHROTTLE, 2*m_ap_athr_refresh_ms, m_ap_athr_refresh_ms);
+        m_scheduler.setPhase(SCHEDULER_TASK_AUTOTHROTTLE, SCHEDULER_TASK_AUTOPILOT, m_ap_athr_refresh_ms);
+    }
+    m_scheduler.setPeriod(SCHEDULER_TASK_CDU_REFRESH, 2*m_cdufcu_refresh_ms, 2*m_cdufcu_refresh_ms);
 
     // check FMC connection mode
 
@@ -658,6 +728,8 @@ void FMCControl::slotControlTimer()
         m_fmc_connect_master_tcp_server = 0;
         delete m_fmc_connect_slave_tcp_client;
         m_fmc_connect_slave_tcp_client = 0;
+        m_sync_sender_map.clear();
+        m_sync_receiver_map.clear();
 
         Logger::log(QString("FMCControl:slotControlTimer: FMC connect mode changed to %1").arg(getFMCConnectMode()));
 
@@ -696,27 +768,6 @@ void FMCControl::slotControlTimer()
 
     m_last_fmc_connect_mode = getFMCConnectMode();
 
-    // sync status to slave FMCs
-
-    if (isFMCConnectModeMaster() &&
-        getFMCConnectModeMasterNrClients() > 0 &&
-        m_fmc_connect_master_mode_sync_timer.elapsed() >= 500)
-    {
-        m_fmc_connect_master_mode_sync_timer.start();
-
-        QByteArray data;
-
-        // sync autothrottle state
-        QDataStream ds1(&data, QIODevice::WriteOnly);
-        *m_fmc_autothrottle >> ds1;
-        m_fmc_connect_master_tcp_server->sendData(SYNC_DATA_TYPE_AUTOTHROTTLE, data);
-
-        data.clear();
-        QDataStream ds2(&data, QIODevice::WriteOnly);
-        *m_fmc_autopilot >> ds2;
-        m_fmc_connect_master_tcp_server->sendData(SYNC_DATA_TYPE_AUTOPILOT, data);
-    }
-
     // process FS controls
 
     while(!m_flightstatus->fsctrl_fmc_list.isEmpty())
@@ -977,42 +1028,32 @@ void FMCControl::slotDataChanged(const QString& flag, bool direct_change, const
     if ((m_fmc_connect_master_tcp_server != 0 && getFMCConnectModeMasterNrClients() > 0) ||
         (m_fmc_connect_slave_tcp_client != 0 && direct_change))
     {
-        QByteArray data;
-        QDataStream ds(&data, QIODevice::WriteOnly);
-        int data_type = 0;
-
         if (flag == Route::FLAG_NORMAL)
         {
-            m_fmc_data->normalRoute() >> ds;
-            data_type = SYNC_DATA_TYPE_NORMAL_ROUTE;
+            sendSyncData(SYNC_DATA_TYPE_NORMAL_ROUTE, false);
         }
         else if (flag == Route::FLAG_TEMPORARY)
         {
-            m_fmc_data->temporaryRoute() >> ds;
-            data_type = SYNC_DATA_TYPE_TEMPORARY_ROUTE;
+            sendSyncData(SYNC_DATA_TYPE_TEMPORARY_ROUTE, false);
         }
         else if (flag == Route::FLAG_ALTERNATE)
         {
-            m_fmc_data->alternateRoute() >> ds;
-            data_type = SYNC_DATA_TYPE_ALTERNATE_ROUTE;
+            sendSyncData(SYNC_DATA_TYPE_ALTERNATE_ROUTE, false);
         }
         else if (flag == Route::FLAG_SECONDARY)
         {
-            m_fmc_data->secondaryRoute() >> ds;
-            data_type = SYNC_DATA_TYPE_SECONDARY_ROUTE;
+            sendSyncData(SYNC_DATA_TYPE_SECONDARY_ROUTE, false);
         }
         else if (flag == FMCData::CHANGE_FLAG_FMC_DATA)
         {
+            QByteArray data;
+            QDataStream ds(&data, QIODevice::WriteOnly);
             *m_fmc_data >> ds;
-            data_type = SYNC_DATA_TYPE_FMCDATA;
-        }
 
-        if (data.count() > 0 && data_type != 0)
-        {
             if (m_fmc_connect_master_tcp_server != 0)
-                m_fmc_connect_master_tcp_server->sendData(data_type, data);
+                m_fmc_connect_master_tcp_server->sendData(SYNC_DATA_TYPE_FMCDATA, data);
             else if (m_fmc_connect_slave_tcp_client != 0)
-                m_fmc_connect_slave_tcp_client->sendData(data_type, data);
+                m_fmc_connect_slave_tcp_client->sendData(SYNC_DATA_TYPE_FMCDATA, data);
         }
     }
 }
@@ -1731,29 +1772,18 @@ void FMCControl::slotRemoteFMCConnected()
 {
     if (m_fmc_connect_master_tcp_server != 0)
     {
+        // the new slave needs keyframes of everything, the others apply them as well
+
+        sendSyncData(SYNC_DATA_TYPE_NORMAL_ROUTE, true);
+        sendSyncData(SYNC_DATA_TYPE_TEMPORARY_ROUTE, true);
+        sendSyncData(SYNC_DATA_TYPE_ALTERNATE_ROUTE, true);
+        sendSyncData(SYNC_DATA_TYPE_SECONDARY_ROUTE, true);
+        m_sync_sender_map[SYNC_DATA_TYPE_AUTOTHROTTLE].requestKeyframe();
+        m_sync_sender_map[SYNC_DATA_TYPE_AUTOPILOT].requestKeyframe();
+
         QByteArray data;
-        QDataStream ds1(&data, QIODevice::ReadWrite);
-        m_fmc_data->normalRoute() >> ds1;
-        m_fmc_connect_master_tcp_server->sendData(SYNC_DATA_TYPE_NORMAL_ROUTE, data);
-
-        data.clear();
-        QDataStream ds2(&data, QIODevice::ReadWrite);
-        m_fmc_data->temporaryRoute() >> ds2;
-        m_fmc_connect_master_tcp_server->sendData(SYNC_DATA_TYPE_TEMPORARY_ROUTE, data);
-
-        data.clear();
-        QDataStream ds3(&data, QIODevice::ReadWrite);
-        m_fmc_data->alternateRoute() >> ds3;
-        m_fmc_connect_master_tcp_server->sendData(SYNC_DATA_TYPE_ALTERNATE_ROUTE, data);
-
-        data.clear();
-        QDataStream ds4(&data, QIODevice::ReadWrite);
-        m_fmc_data->secondaryRoute() >> ds4;
-        m_fmc_connect_master_tcp_server->sendData(SYNC_DATA_TYPE_SECONDARY_ROUTE, data);
-
-        data.clear();
-        QDataStream ds5(&data, QIODevice::ReadWrite);
-        *m_fmc_data >> ds5;
+        QDataStream ds(&data, QIODevice::ReadWrite);
+        *m_fmc_data >> ds;
         m_fmc_connect_master_tcp_server->sendData(SYNC_DATA_TYPE_FMCDATA, data);
     }
 }
@@ -1767,39 +1797,45 @@ void FMCControl::slotReceivedRemoteFMCData(qint16 data_type, QByteArray& data)
     switch(data_type)
     {
         case(SYNC_DATA_TYPE_NORMAL_ROUTE): {
-            m_fmc_data->normalRoute() << ds;
-            MYASSERT(ds.atEnd());
-            Logger::log("FMCControl:slotReceivedRemoteFMCData: got primary route from remote FMC");
+            if (receiveSyncData(data_type, data))
+                Logger::log("FMCControl:slotReceivedRemoteFMCData: got primary route from remote FMC");
             break;
         }
         case(SYNC_DATA_TYPE_TEMPORARY_ROUTE): {
-            m_fmc_data->temporaryRoute() << ds;
-            MYASSERT(ds.atEnd());
-            Logger::log("FMCControl:slotReceivedRemoteFMCData: got temporary route from remote FMC");
+            if (receiveSyncData(data_type, data))
+                Logger::log("FMCControl:slotReceivedRemoteFMCData: got temporary route from remote FMC");
             break;
         }
         case(SYNC_DATA_TYPE_ALTERNATE_ROUTE): {
-            m_fmc_data->alternateRoute() << ds;
-            MYASSERT(ds.atEnd());
-            Logger::log("FMCControl:slotReceivedRemoteFMCData: got alternate route from remote FMC");
+            if (receiveSyncData(data_type, data))
+                Logger::log("FMCControl:slotReceivedRemoteFMCData: got alternate route from remote FMC");
             break;
         }
         case(SYNC_DATA_TYPE_SECONDARY_ROUTE): {
-            m_fmc_data->secondaryRoute() << ds;
-            MYASSERT(ds.atEnd());
-            Logger::log("FMCControl:slotReceivedRemoteFMCData: got secondary route from remote FMC");
+            if (receiveSyncData(data_type, data))
+                Logger::log("FMCControl:slotReceivedRemoteFMCData: got secondary route from remote FMC");
             break;
         }
         case(SYNC_DATA_TYPE_AUTOTHROTTLE): {
             if (!isFMCConnectModeSlave()) return;
-            *m_fmc_autothrottle << ds;
-            MYASSERT(ds.atEnd());
+            receiveSyncData(data_type, data);
             break;
         }
         case(SYNC_DATA_TYPE_AUTOPILOT): {
             if (!isFMCConnectModeSlave()) return;
-            *m_fmc_autopilot << ds;
-            MYASSERT(ds.atEnd());
+            receiveSyncData(data_type, data);
+            break;
+        }
+        case(SYNC_DATA_TYPE_KEYFRAME_REQUEST): {
+            if (!isFMCConnectModeMaster()) return;
+            qint16 requested_type;
+            ds >> requested_type;
+            Logger::log(QString("FMCControl:slotReceivedRemoteFMCData: remote FMC requested keyframe of type %1").
+                        arg(requested_type));
+            // routes are only sent on changes, so their keyframe goes out now
+            if (syncedRoute(requested_type) != 0) sendSyncData(requested_type, true);
+            else if (requested_type == SYNC_DATA_TYPE_AUTOTHROTTLE || requested_type == SYNC_DATA_TYPE_AUTOPILOT)
+                m_sync_sender_map[requested_type].requestKeyframe();
             break;
         }
         case(SYNC_DATA_TYPE_FMCDATA): {
@@ -1817,6 +1853,98 @@ void FMCControl::slotReceivedRemoteFMCData(qint16 data_type, QByteArray& data)
 
 /////////////////////////////////////////////////////////////////////////////
 
+void FMCControl::syncStateToSlaves()
+{
+    if (!isFMCConnectModeMaster() ||
+        getFMCConnectModeMasterNrClients() <= 0) return;
+
+    sendSyncData(SYNC_DATA_TYPE_AUTOTHROTTLE, false);
+    sendSyncData(SYNC_DATA_TYPE_AUTOPILOT, false);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FlightRoute* FMCControl::syncedRoute(int data_type)
+{
+    switch(data_type)
+    {
+        case(SYNC_DATA_TYPE_NORMAL_ROUTE): return &m_fmc_data->normalRoute();
+        case(SYNC_DATA_TYPE_TEMPORARY_ROUTE): return &m_fmc_data->temporaryRoute();
+        case(SYNC_DATA_TYPE_ALTERNATE_ROUTE): return &m_fmc_data->alternateRoute();
+        case(SYNC_DATA_TYPE_SECONDARY_ROUTE): return &m_fmc_data->secondaryRoute();
+    }
+
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCControl::sendSyncData(int data_type, bool keyframe)
+{
+    QList<QByteArray> fields;
+    FlightRoute* route = syncedRoute(data_type);
+
+    if (route != 0) route->syncFields(fields);
+    else if (data_type == SYNC_DATA_TYPE_AUTOTHROTTLE) m_fmc_autothrottle->syncFields(fields);
+    else if (data_type == SYNC_DATA_TYPE_AUTOPILOT) m_fmc_autopilot->syncFields(fields);
+    else
+    {
+        Logger::log(QString("FMCControl:sendSyncData: type %1 is not synced").arg(data_type));
+        return;
+    }
+
+    // the master receives the changes of all slaves and can not tell them
+    // apart, so the slaves only send keyframes
+
+    if (m_fmc_connect_slave_tcp_client != 0) keyframe = true;
+
+    QByteArray data = m_sync_sender_map[data_type].encode(fields, keyframe);
+    if (data.isEmpty()) return;
+
+    if (m_fmc_connect_master_tcp_server != 0)
+        m_fmc_connect_master_tcp_server->sendData(data_type, data);
+    else if (m_fmc_connect_slave_tcp_client != 0)
+        m_fmc_connect_slave_tcp_client->sendData(data_type, data);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FMCControl::receiveSyncData(int data_type, const QByteArray& data)
+{
+    DeltaSyncReceiver& receiver = m_sync_receiver_map[data_type];
+
+    if (!receiver.decode(data))
+    {
+        if (m_fmc_connect_slave_tcp_client != 0 && receiver.shouldRequestKeyframe())
+        {
+            Logger::log(QString("FMCControl:receiveSyncData: missed changes of type %1 - requesting keyframe").
+                        arg(data_type));
+
+            QByteArray request;
+            QDataStream ds(&request, QIODevice::WriteOnly);
+            ds << (qint16)data_type;
+            m_fmc_connect_slave_tcp_client->sendData(SYNC_DATA_TYPE_KEYFRAME_REQUEST, request);
+        }
+        return false;
+    }
+
+    FlightRoute* route = syncedRoute(data_type);
+
+    if (route != 0)
+    {
+        if (route->setSyncFields(receiver.fields())) return true;
+        Logger::log(QString("FMCControl:receiveSyncData: could not read route of type %1").arg(data_type));
+        return false;
+    }
+    else if (data_type == SYNC_DATA_TYPE_AUTOTHROTTLE) m_fmc_autothrottle->setSyncFields(receiver.fields());
+    else if (data_type == SYNC_DATA_TYPE_AUTOPILOT) m_fmc_autopilot->setSyncFields(receiver.fields());
+    else return false;
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 bool FMCControl::isFMCConnectRemoteConnected() const
 {
     if (m_fmc_connect_slave_tcp_client != 0 && m_fmc_connect_slave_tcp_client->isConnected()) return true;
@@ -27,7 +27,9 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QMap>
 
+#include "clock.h"
 #include "navdata.h"
 #include "waypoint.h"
 #include "sid.h"
@@ -35,10 +37,12 @@
 #include "flightstatus.h"
 #include "fsaccess.h"
 #include "declination.h"
+#include "delta_sync.h"
 
 #include "fmc_control_defines.h"
 #include "fmc_data.h"
 #include "fmc_processor.h"
+#include "fmc_scheduler.h"
 
 #include "info_server.h"
 
@@ -73,13 +77,17 @@ class FMCControl : public QObject, FlightStatusProvider, FSAccessProvider
 
 public:
 
-    enum SYNC_DATA_TYPE { SYNC_DATA_TYPE_NORMAL_ROUTE = 1,
-                          SYNC_DATA_TYPE_TEMPORARY_ROUTE = 2,
-                          SYNC_DATA_TYPE_ALTERNATE_ROUTE = 3,
-                          SYNC_DATA_TYPE_SECONDARY_ROUTE = 4,
-                          SYNC_DATA_TYPE_AUTOTHROTTLE = 100,
-                          SYNC_DATA_TYPE_AUTOPILOT = 200,
-                          SYNC_DATA_TYPE_FMCDATA = 300
+    //! the routes, the autothrottle and the autopilot are sent as delta sync
+    //! messages (see DeltaSyncSender), their types were renumbered for it so
+    //! FMCs with the former full sync discard them.
+    enum SYNC_DATA_TYPE { SYNC_DATA_TYPE_NORMAL_ROUTE = 11,
+                          SYNC_DATA_TYPE_TEMPORARY_ROUTE = 12,
+                          SYNC_DATA_TYPE_ALTERNATE_ROUTE = 13,
+                          SYNC_DATA_TYPE_SECONDARY_ROUTE = 14,
+                          SYNC_DATA_TYPE_AUTOTHROTTLE = 101,
+                          SYNC_DATA_TYPE_AUTOPILOT = 201,
+                          SYNC_DATA_TYPE_FMCDATA = 300,
+                          SYNC_DATA_TYPE_KEYFRAME_REQUEST = 400
     };
 
     //! Standard Constructor
@@ -638,6 +646,31 @@ protected slots:
 
 protected:
 
+    //! tasks of the central timer scheduler, see FMCScheduler
+    enum SCHEDULER_TASK { SCHEDULER_TASK_CONTROL = 0,
+                          SCHEDULER_TASK_SYNC,
+                          SCHEDULER_TASK_PROCESSOR,
+                          SCHEDULER_TASK_FLIGHT_MODE,
+                          SCHEDULER_TASK_CDU_INPUT,
+                          SCHEDULER_TASK_FBW,
+                          SCHEDULER_TASK_AUTOPILOT,
+                          SCHEDULER_TASK_AUTOTHROTTLE,
+                          SCHEDULER_TASK_CDU_REFRESH,
+                          SCHEDULER_TASK_CPFLIGHT,
+                          SCHEDULER_TASK_SOUNDS
+    };
+
+    void setupScheduler();
+
+    //! recalcs the refresh times from the config
+    void recalcRefreshTimes();
+
+    //! runs the given scheduler task
+    void runSchedulerTask(int task_id);
+
+    //! executes the bank and pitch controllers when FBW is enabled
+    void execFBW();
+
     void setupDefaultConfig();
 
     //! Checks if the given waypoint ID specifies an overfly waypoint.
@@ -650,6 +683,19 @@ protected:
 
     void calcNoiseLimits();
 
+    //! sends the changed autothrottle and autopilot values to the slave FMCs
+    void syncStateToSlaves();
+
+    //! returns the route synced with the given type, 0 for other types
+    FlightRoute* syncedRoute(int data_type);
+
+    //! sends the changes of the object synced with the given type to the remote FMCs
+    void sendSyncData(int data_type, bool keyframe);
+
+    //! applies the given delta sync message, requests a keyframe from the
+    //! master if changes were missed. returns false if nothing was applied.
+    bool receiveSyncData(int data_type, const QByteArray& data);
+
 protected:
     
     //! the global opengl font
@@ -689,8 +735,8 @@ protected:
     //! triggers processing for all submodules
     QTimer m_central_timer;
     
-    //! triggers control processing
-    QTime m_control_timer;
+    //! schedules the processing of the submodules per central timer tick
+    FMCScheduler m_scheduler;
 
     //! navdata access
     Navdata* m_navdata;    
@@ -709,9 +755,9 @@ protected:
 
     uint m_pbd_counter;
 
-    QTime m_sbox_transponder_timer;
+    ClockTimer m_sbox_transponder_timer;
 
-    QTime m_date_time_sync_timer;
+    ClockTimer m_date_time_sync_timer;
 
     QList<int> m_nd_possible_ranges_nm_list;
 
@@ -721,6 +767,9 @@ protected:
     BankController* m_bank_controller;
     PitchController* m_pitch_controller;
 
+    //! true when the controllers ran in the last FBW task
+    bool m_fbw_was_enabled;
+
     AircraftData *m_aircraft_data;
     bool m_aircraft_data_confirmed;
 
@@ -758,28 +807,21 @@ protected:
     QString m_last_fmc_connect_mode;
     TransportLayerTCPClient* m_fmc_connect_slave_tcp_client;
     TransportLayerTCPServer* m_fmc_connect_master_tcp_server;
-    QTime m_fmc_connect_master_mode_sync_timer;
+    QMap<int, DeltaSyncSender> m_sync_sender_map;
+    QMap<int, DeltaSyncReceiver> m_sync_receiver_map;
 
     //----- refresh timer
 
-    QTime m_pfdnd_refresh_timer;
+    ClockTimer m_pfdnd_refresh_timer;
     int m_pfdnd_refresh_ms;
     int m_pfdnd_refresh_index;
 
-    QTime m_ecam_refresh_timer;
+    ClockTimer m_ecam_refresh_timer;
     int m_ecam_refresh_ms;
     //TODOint m_ecam_refresh_index;
 
-    QTime m_ap_athr_refresh_timer;
     int m_ap_athr_refresh_ms;
-    int m_ap_athr_refresh_index;
-
-    QTime m_cdufcu_refresh_timer;
     int m_cdufcu_refresh_ms;
-    int m_cdufcu_refresh_index;
-
-    QTime m_fsctrl_poll_timer;
-    int m_fsctrl_poll_index;
 
     // used to gather 
     FMCStatusData m_fmc_status_data;
@@ -790,7 +832,7 @@ protected:
     NoiseGenerator* m_vor2_noise_generator;
     NoiseGenerator* m_ils1_noise_generator;
     NoiseGenerator* m_ils2_noise_generator;
-    QTime m_noise_limit_update_timer;
+    ClockTimer m_noise_limit_update_timer;
     Damping m_noise_damping;
     uint m_noise_calc_index;
 
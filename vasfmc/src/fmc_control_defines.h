@@ -140,6 +140,18 @@
 #define CFG_FMC_CONNECT_MODE_MASTER "master"
 #define CFG_FMC_CONNECT_MODE_SLAVE "slave"
 
+#define FMC_CONNECT_SYNC_PERIOD_MS 100
+
+#define FMC_SCHEDULER_TICK_BUDGET_MS 10
+#define FMC_SCHEDULER_REPORT_PERIOD_MS 10000
+#define FMC_SCHEDULER_CONTROL_PERIOD_MS 250
+#define FMC_SCHEDULER_PROCESSOR_PERIOD_MS 10
+#define FMC_SCHEDULER_FLIGHT_MODE_PERIOD_MS 20
+#define FMC_SCHEDULER_CDU_INPUT_PERIOD_MS 250
+#define FMC_SCHEDULER_FBW_PERIOD_MS 20
+#define FMC_SCHEDULER_CPFLIGHT_PERIOD_MS 50
+#define FMC_SCHEDULER_SOUNDS_PERIOD_MS 20
+
 #define CFG_TCAS_OFF 0
 #define CFG_TCAS_STDBY 1
 #define CFG_TCAS_ON 2
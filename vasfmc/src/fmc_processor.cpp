@@ -34,10 +34,7 @@
 #include "projection_greatcircle.h"
 #include "flightstatus.h"
 
-#ifdef Q_OS_WIN32
-#include "code_timer.h"
-#define DO_PROFILING 0
-#endif
+#include "metrics.h"
 
 #include "fmc_data.h"
 #include "fmc_control.h"
@@ -158,7 +155,7 @@ void FMCProcessor::slotRefresh(bool force)
     if (!force && m_refresh_timer.elapsed() < m_processor_cfg->getIntValue(CFG_PROCESSOR_REFRESH_PERIOD_MS)) return;
     m_refresh_timer.start();
 
-    QTime overall_timer;
+    QElapsedTimer overall_timer;
     overall_timer.start();
 
     clearCalculatedValues();
@@ -407,10 +404,7 @@ void FMCProcessor::slotRefresh(bool force)
           qAbs(vs - m_last_toc_eod_vs_ftmin) > 50 ||
           qAbs(m_flightstatus->ground_speed_kts - m_last_toc_eod_ground_speed_kts) > 10)))
     {
-#if DO_PROFILING
-        CodeTimer timer;
-        timer.Tick();
-#endif
+        MetricsScope metrics_scope("PR.ALTREACH");
         normal_route.altReachWpt() = Waypoint();
         
         if (qAbs(ap_diff_alt) > 500 && 
@@ -475,10 +469,6 @@ void FMCProcessor::slotRefresh(bool force)
         m_last_toc_eod_ground_speed_kts = m_flightstatus->ground_speed_kts;
         m_last_toc_eod_vs_ftmin = vs;
         m_last_toc_eod_ap_diff_alt = ap_diff_alt;
-
-#if DO_PROFILING
-        Logger::log(QString("FMCProcessor:alt_reach=%1").arg(timer.Tock()));
-#endif
     }
 
     //----- calc descent estimate and TOD
@@ -659,10 +649,8 @@ void FMCProcessor::slotRefresh(bool force)
     // we do not recalc the projection at each cycle, instead we use a current
     // position correction X/Y calculation, see drawRouteNormalMode() in FMCNavdisplayStyleA/B
 
-#if DO_PROFILING
-    CodeTimer timer;
-    timer.Tick();
-#endif
+    QElapsedTimer projection_timer;
+    projection_timer.start();
 
     double dist_to_projection_center = 0.0;
     Waypoint view_center;
@@ -833,9 +821,7 @@ void FMCProcessor::slotRefresh(bool force)
     if (m_project_recalc_ndbs >= 0) --m_project_recalc_ndbs;
     if (m_project_recalc_geo >= 0) --m_project_recalc_geo;
 
-#if DO_PROFILING
-    Logger::log(QString("FMCProcessor:proj_recalc=%1").arg(timer.Tock()));
-#endif
+    MetricsRegistry::registry()->recordLatency("PR.PROJ", projection_timer.nsecsElapsed() / 1000);
 
     //----- always process tuned VOR1/2 locations
 
@@ -845,6 +831,7 @@ void FMCProcessor::slotRefresh(bool force)
     m_data_changed = false;
     m_normal_route_view_wpt_index = normal_route.viewWptIndex();
 
+    MetricsRegistry::registry()->recordLatency("PR", overall_timer.nsecsElapsed() / 1000);
     emit signalTimeUsed("PR", overall_timer.elapsed());
 
 //     Logger::log(QString("FMCProcessor: act=%1/%2nm/%3h, prev=%4/%5nm, xtrack=%6").
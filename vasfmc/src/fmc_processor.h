@@ -28,6 +28,8 @@
 #include <QObject>
 #include <QTime>
 
+#include "clock.h"
+
 class FMCData;
 class FlightStatus;
 class ProjectionBase;
@@ -82,14 +84,14 @@ protected:
 
     bool m_flightstatus_was_valid_once;
 
-    QTime  m_refresh_timer;
+    ClockTimer m_refresh_timer;
 
-    QTime  m_descent_estimate_recalc_timer;
+    ClockTimer m_descent_estimate_recalc_timer;
 
-    QTime  m_wpt_times_recalc_timer;
+    ClockTimer m_wpt_times_recalc_timer;
     int    m_wpt_times_recalc_wpt_index;
 
-    QTime  m_alt_reach_recalc_timer;
+    ClockTimer m_alt_reach_recalc_timer;
     bool   m_data_changed;
 
     double m_last_toc_eod_ground_speed_kts;
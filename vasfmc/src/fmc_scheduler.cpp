@@ -0,0 +1,244 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    fmc_scheduler.cpp
+    \author  vasFMC contributors
+*/
+
+#include "assert.h"
+#include "logger.h"
+#include "metrics.h"
+
+#include "fmc_control_defines.h"
+#include "fmc_scheduler.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+FMCScheduler::FMCScheduler(int tick_budget_ms) :
+    m_tick_budget_ms(tick_budget_ms), m_tick_start_ms(0), m_task_start_ms(0)
+{
+    m_report_timer.start();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCScheduler::addTask(int task_id, const QString& name, TASK_CLASS task_class, 
+                           int period_ms, int deadline_ms, int cost_ms, int phase_ms)
+{
+    MYASSERT(task_id == m_task_list.count());
+    MYASSERT(period_ms > 0);
+
+    Task task;
+    task.name = name;
+    task.metrics_name = "SCHED." + name;
+    task.task_class = task_class;
+    task.period_ms = period_ms;
+    task.deadline_ms = qMax(1, deadline_ms);
+    task.cost_ms = cost_ms;
+    task.release_ms = Clock::current()->msecs() + phase_ms;
+    m_task_list.append(task);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FMCScheduler::setPeriod(int task_id, int period_ms, int deadline_ms)
+{
+    MYASSERT(task_id >= 0 && task_id < m_task_list.count());
+    Task& task = m_task_list[task_id];
+    task.deadline_ms = qMax(1, deadline_ms);
+
+    period_ms = qMax(1, period_ms);
+    if (period_ms == task.period_ms) return false;
+
+    qint64 now_ms = Clock::current()->msecs();
+    if (task.release_ms > now_ms)
+        task.release_ms = qMax(now_ms, task.release_ms - task.period_ms + period_ms);
+    task.period_ms = period_ms;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCScheduler::setPhase(int task_id, int reference_task_id, int offset_ms)
+{
+    MYASSERT(task_id >= 0 && task_id < m_task_list.count());
+    MYASSERT(reference_task_id >= 0 && reference_task_id < m_task_list.count());
+    m_task_list[task_id].release_ms = m_task_list[reference_task_id].release_ms + offset_ms;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCScheduler::beginTick()
+{
+    m_tick_start_ms = Clock::current()->msecs();
+
+    QList<Task>::iterator iter = m_task_list.begin();
+    for(; iter != m_task_list.end(); ++iter)
+    {
+        (*iter).ran_in_tick = false;
+        (*iter).deferred_in_tick = false;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FMCScheduler::canRunDeferrable(const Task& task, qint64 now_ms) const
+{
+    // do not put off a task for more than one period
+    if (now_ms - task.release_ms >= task.period_ms) return true;
+
+    if (now_ms - m_tick_start_ms + task.cost_ms > m_tick_budget_ms) return false;
+
+    QList<Task>::const_iterator iter = m_task_list.begin();
+    for(; iter != m_task_list.end(); ++iter)
+    {
+        const Task& critical_task = *iter;
+        if (critical_task.task_class != TASK_CRITICAL) continue;
+
+        if (now_ms + task.cost_ms > critical_task.absoluteDeadline() - critical_task.cost_ms) return false;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+int FMCScheduler::nextTask()
+{
+    qint64 now_ms = Clock::current()->msecs();
+
+    while(true)
+    {
+        int next_task_id = -1;
+
+        for(int task_id = 0; task_id < m_task_list.count(); ++task_id)
+        {
+            const Task& task = m_task_list[task_id];
+            if (task.ran_in_tick || task.deferred_in_tick || now_ms < task.release_ms) continue;
+
+            if (next_task_id < 0) 
+            {
+                next_task_id = task_id;
+                continue;
+            }
+
+            const Task& next_task = m_task_list[next_task_id];
+            if (task.absoluteDeadline() < next_task.absoluteDeadline() ||
+                (task.absoluteDeadline() == next_task.absoluteDeadline() && task.task_class < next_task.task_class))
+                next_task_id = task_id;
+        }
+
+        if (next_task_id < 0) return -1;
+
+        Task& next_task = m_task_list[next_task_id];
+        if (next_task.task_class == TASK_DEFERRABLE && !canRunDeferrable(next_task, now_ms))
+        {
+            next_task.deferred_in_tick = true;
+            ++next_task.defer_count;
+            ++next_task.report_defer_count;
+            MetricsRegistry::registry()->incCounter(next_task.metrics_name + ".DEFER");
+            continue;
+        }
+
+        next_task.ran_in_tick = true;
+        m_task_start_ms = now_ms;
+        m_task_timer.start();
+        return next_task_id;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCScheduler::finishTask(int task_id)
+{
+    MYASSERT(task_id >= 0 && task_id < m_task_list.count());
+    Task& task = m_task_list[task_id];
+
+    qint64 now_ms = Clock::current()->msecs();
+    int used_ms = (int)(now_ms - m_task_start_ms);
+
+    MetricsRegistry::registry()->recordLatency(task.metrics_name, m_task_timer.nsecsElapsed() / 1000);
+
+    if (used_ms > task.cost_ms) task.cost_ms = used_ms;
+    else task.cost_ms = (7.0 * task.cost_ms + used_ms) / 8.0;
+
+    if (now_ms > task.absoluteDeadline())
+    {
+        ++task.miss_count;
+        ++task.report_miss_count;
+        MetricsRegistry::registry()->incCounter(task.metrics_name + ".MISS");
+    }
+
+    // releases missed by more than a period are dropped instead of run in a row
+    task.release_ms += task.period_ms;
+    if (task.release_ms <= now_ms) task.release_ms = now_ms + task.period_ms;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCScheduler::endTick()
+{
+    if (m_report_timer.elapsed() < FMC_SCHEDULER_REPORT_PERIOD_MS) return;
+    m_report_timer.start();
+    logReport();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FMCScheduler::logReport()
+{
+    QString report;
+
+    QList<Task>::iterator iter = m_task_list.begin();
+    for(; iter != m_task_list.end(); ++iter)
+    {
+        Task& task = *iter;
+        if (task.report_miss_count == 0 && task.report_defer_count == 0) continue;
+
+        report += QString(" %1: %2 missed, %3 deferred (cost %4ms);").
+                  arg(task.name).arg(task.report_miss_count).arg(task.report_defer_count).
+                  arg(task.cost_ms, 0, 'f', 1);
+
+        task.report_miss_count = 0;
+        task.report_defer_count = 0;
+    }
+
+    if (!report.isEmpty())
+        Logger::log(QString("FMCScheduler:logReport: last %1s:%2").
+                    arg(FMC_SCHEDULER_REPORT_PERIOD_MS / 1000).arg(report));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+uint FMCScheduler::missCount(int task_id) const
+{
+    MYASSERT(task_id >= 0 && task_id < m_task_list.count());
+    return m_task_list[task_id].miss_count;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+uint FMCScheduler::deferCount(int task_id) const
+{
+    MYASSERT(task_id >= 0 && task_id < m_task_list.count());
+    return m_task_list[task_id].defer_count;
+}
+
+// End of file
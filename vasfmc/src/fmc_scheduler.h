@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    fmc_scheduler.h
+    \author  vasFMC contributors
+*/
+
+#ifndef __FMC_SCHEDULER_H__
+#define __FMC_SCHEDULER_H__
+
+#include <QString>
+#include <QList>
+#include <QElapsedTimer>
+
+#include "clock.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! cooperative earliest deadline first scheduler for the central timer.
+/*! Each task is released every period and should be finished within its
+    deadline after the release. Per tick the released task with the earliest
+    deadline is run first. Critical tasks always run when released.
+    Deferrable tasks (e.g. CDU repaints, sounds, serial output) are put off
+    to a later tick when their estimated cost does not fit into the budget
+    of the tick or would make a critical task miss its deadline, but at most
+    for one period. Deadline misses and deferrals are logged periodically.
+    The run times of the tasks are recorded in the metrics registry as
+    "SCHED.<name>", the misses and deferrals as counters.
+
+    Usage per tick:
+
+    scheduler.beginTick();
+    int task_id;
+    while((task_id = scheduler.nextTask()) >= 0)
+    {
+        ...run the task...
+        scheduler.finishTask(task_id);
+    }
+    scheduler.endTick();
+ */
+class FMCScheduler
+{
+public:
+
+    enum TASK_CLASS { TASK_CRITICAL = 0,
+                      TASK_DEFERRABLE
+    };
+
+    //! Standard Constructor
+    FMCScheduler(int tick_budget_ms);
+
+    //! Destructor
+    virtual ~FMCScheduler() {};
+
+    //! adds a task, the IDs must be given in ascending order starting with 0.
+    //! The first release of the task is phase_ms after now.
+    void addTask(int task_id, const QString& name, TASK_CLASS task_class, 
+                 int period_ms, int deadline_ms, int cost_ms, int phase_ms = 0);
+
+    //! changes the period and deadline of the given task, a pending next
+    //! release is moved to the new period after the last one.
+    //! Returns true when the period changed.
+    bool setPeriod(int task_id, int period_ms, int deadline_ms);
+
+    //! moves the next release of the given task to offset_ms after the
+    //! next release of the reference task
+    void setPhase(int task_id, int reference_task_id, int offset_ms);
+
+    //! starts a new tick
+    void beginTick();
+
+    //! returns the ID of the next task to run in the current tick or -1 when
+    //! no (more) task shall run in this tick
+    int nextTask();
+
+    //! must be called when the task returned by nextTask() has finished
+    void finishTask(int task_id);
+
+    //! ends the current tick and logs the deadline misses and deferrals when due
+    void endTick();
+
+    //! returns the number of deadline misses of the given task since the start
+    uint missCount(int task_id) const;
+
+    //! returns the number of deferrals of the given task since the start
+    uint deferCount(int task_id) const;
+
+protected:
+
+    //! scheduler task
+    class Task
+    {
+    public:
+        Task() : task_class(TASK_CRITICAL), period_ms(0), deadline_ms(0), cost_ms(0.0),
+                 release_ms(0), ran_in_tick(false), deferred_in_tick(false),
+                 miss_count(0), defer_count(0), report_miss_count(0), report_defer_count(0) {};
+
+        inline qint64 absoluteDeadline() const { return release_ms + deadline_ms; }
+
+        QString name;
+        QString metrics_name;
+        TASK_CLASS task_class;
+        int period_ms;
+        int deadline_ms;
+        //! cost estimate, raised at once and lowered slowly
+        double cost_ms;
+        //! time of the current (or next) release
+        qint64 release_ms;
+        bool ran_in_tick;
+        bool deferred_in_tick;
+        uint miss_count;
+        uint defer_count;
+        uint report_miss_count;
+        uint report_defer_count;
+    };
+
+    //! returns true when the given deferrable task fits into the tick budget
+    //! and leaves the critical tasks enough time to meet their deadlines
+    bool canRunDeferrable(const Task& task, qint64 now_ms) const;
+
+    void logReport();
+
+protected:
+
+    QList<Task> m_task_list;
+
+    int m_tick_budget_ms;
+    qint64 m_tick_start_ms;
+    qint64 m_task_start_ms;
+    QElapsedTimer m_task_timer;
+
+    ClockTimer m_report_timer;
+
+private:
+    //! Hidden copy-constructor
+    FMCScheduler(const FMCScheduler&);
+    //! Hidden assignment operator
+    const FMCScheduler& operator = (const FMCScheduler&);
+};
+
+#endif /* __FMC_SCHEDULER_H__ */
+
+// End of file
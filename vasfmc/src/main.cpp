@@ -26,6 +26,7 @@
 #include "assert.h"
 #include "config.h"
 #include "logger.h"
+#include "metrics.h"
 
 #include "fmc_console.h"
 
@@ -93,6 +94,11 @@ int main(int argc, char **argv)
     Logger::log("     ----- Shutting down -----");
     delete console;
 
+    QStringList metrics_report_list = MetricsRegistry::registry()->reportList();
+    QStringList::const_iterator iter = metrics_report_list.begin();
+    for(; iter != metrics_report_list.end(); ++iter) Logger::log(QString("Metrics: %1").arg(*iter));
+    MetricsRegistry::finish();
+
     // store config 
     Logger::log("     ----- Shutdown finished -----");
     Logger::finish();
@@ -58,6 +58,8 @@ else {
     PRE_TARGETDEPS += ../../vaslib/lib/libvaslib.a
     DEFINES += VASFMC_GAUGE=0
     LIBS += -lvaslib
+    # shm_open of the X-Plane shared memory ring
+    !macx:LIBS += -lrt
 
     ARCH = $$(CPU)
     contains(ARCH,x86_64) {
@@ -181,6 +183,7 @@ HEADERS	+= \
     fmc_autothrottle.h \
     fmc_autothrottle_defines.h \
     fmc_processor.h \
+    fmc_scheduler.h \
     gldraw.h \
     opengltext.h \
     lfontrenderer.h \
@@ -222,6 +225,7 @@ SOURCES	+= \
     fmc_autopilot.cpp \
     fmc_autothrottle.cpp \
     fmc_processor.cpp \
+    fmc_scheduler.cpp \
     gldraw.cpp \
     opengltext.cpp \
     lfontrenderer.cpp \
@@ -16,8 +16,14 @@
 // Node service request codes
 enum AS_NodeService {
     IDS = 0,
-    STS = 7
+    STS = 7,
     // others not implemented in plugin
+    // user defined: request to send batched frames (see canAS_frame_header_t), uChar[0] = frame version
+    BFS = 100,
+    // user defined: request to send state vectors (see canAS_state_header_t), uChar[0] = state vector version
+    SVS = 101,
+    // user defined: the receiver reads the datagrams from the shared memory ring (see canAS_shm_ring_t), uChar[0] = ring version
+    SHS = 102
 };
 
 //
@@ -88,4 +94,127 @@ typedef struct can_t {
     //uint8_t     total_count;
 } can_t;
 
+
+//! Batched frame mode: many can_t records in one UDP datagram.
+//
+//! A frame is a canAS_frame_header_t followed by count can_t records. Frames are
+//! only sent after the receiver requested them with the BFS node service, peers
+//! without frame support keep getting one can_t per datagram. The frame size is
+//! never sizeof(can_t), so both modes can be told apart by the datagram size.
+#define CANAS_FRAME_MAGIC 0x43415346    // "CASF"
+#define CANAS_FRAME_VERSION 1
+//! Maximum frame size, fits into an ethernet MTU without IP fragmentation.
+#define CANAS_FRAME_MAX_BYTES 1472
+#define CANAS_FRAME_MAX_RECORDS ((CANAS_FRAME_MAX_BYTES - sizeof(canAS_frame_header_t)) / sizeof(can_t))
+
+//! Header of a batched frame, all fields in network byte order.
+typedef struct canAS_frame_header_t {
+    uint32_t    magic;      //!< CANAS_FRAME_MAGIC
+    uint16_t    count;      //!< Number of can_t records following the header.
+    uint16_t    sequence;   //!< Frame sequence number, incremented per frame.
+} canAS_frame_header_t;
+
+
+//! State vector mode: position and attitude in one compact datagram.
+//
+//! Instead of one message each for LAT, LON, TALT, THDG, PITCH and BANK, the
+//! plugin sends a keyframe with the full precision doubles of the position
+//! from time to time and quantised deltas to the last keyframe at a high rate
+//! in between. State vectors are only sent after the receiver requested them
+//! with the SVS node service. Their datagrams are told apart from batched
+//! frames by the magic.
+#define CANAS_STATE_MAGIC 0x43415356    // "CASV"
+#define CANAS_STATE_VERSION 1
+
+#define CANAS_STATE_KEYFRAME 1
+#define CANAS_STATE_DELTA 2
+
+//! Quantisation of the state vector fields.
+#define CANAS_STATE_LATLON_QUANTUM 1e-7     // deg, about 1 cm
+#define CANAS_STATE_ALT_QUANTUM 0.01        // ft
+#define CANAS_STATE_ANGLE_QUANTUM 0.01      // deg
+
+//! Header of a state vector, all fields in network byte order.
+typedef struct canAS_state_header_t {
+    uint32_t    magic;      //!< CANAS_STATE_MAGIC
+    uint8_t     type;       //!< CANAS_STATE_KEYFRAME or CANAS_STATE_DELTA
+    uint8_t     keyframe;   //!< Sequence number of the keyframe (of the one the delta refers to).
+    uint16_t    sequence;   //!< State vector sequence number, incremented per state vector.
+} canAS_state_header_t;
+
+//! Attitude of a state vector, quantised by CANAS_STATE_ANGLE_QUANTUM.
+typedef struct canAS_state_attitude_t {
+    uint16_t    heading;    //!< True heading 0..360 deg
+    int16_t     pitch;
+    int16_t     bank;
+    uint16_t    reserved;
+} canAS_state_attitude_t;
+
+//! Keyframe, a double is sent as two 32 bit words (high word first) in network byte order.
+typedef struct canAS_state_keyframe_t {
+    canAS_state_header_t    header;
+    uint32_t                lat[2];     //!< deg
+    uint32_t                lon[2];     //!< deg
+    uint32_t                alt[2];     //!< True altitude ft
+    canAS_state_attitude_t  attitude;
+} canAS_state_keyframe_t;
+
+//! Delta to the keyframe given in the header.
+typedef struct canAS_state_delta_t {
+    canAS_state_header_t    header;
+    int32_t                 lat;        //!< CANAS_STATE_LATLON_QUANTUM
+    int32_t                 lon;        //!< CANAS_STATE_LATLON_QUANTUM
+    int32_t                 alt;        //!< CANAS_STATE_ALT_QUANTUM
+    canAS_state_attitude_t  attitude;
+} canAS_state_delta_t;
+
+
+//! Shared memory mode: a receiver on the host of the simulator reads the
+//! datagrams (single messages, batched frames and state vectors) from a
+//! single producer/single consumer ring in POSIX shared memory instead of
+//! from the UDP socket (linux only).
+//
+//! The plugin creates the ring, the receiver maps it, claims it with its
+//! pid and requests the SHS node service. An other receiver on the host
+//! finds the ring claimed and keeps using UDP. The plugin then writes into
+//! the ring as long as the receiver keeps up and increments its heartbeat,
+//! otherwise it falls back to UDP. The node services themselves always go
+//! over UDP, the other datagrams the receiver may get over UDP while the
+//! ring is active (multicast, subscribers sharing the port) are duplicates.
+#define CANAS_SHM_NAME "/vasfmc_canas"
+#define CANAS_SHM_MAGIC 0x43415352      // "CASR"
+#define CANAS_SHM_VERSION 2
+
+//! Bytes of records following the ring header, a power of two.
+#define CANAS_SHM_CAPACITY (256*1024)
+//! Records start at multiples of the alignment.
+#define CANAS_SHM_ALIGN 8
+//! Bytes of the record of a datagram with the given size.
+#define CANAS_SHM_RECORD_BYTES(size) ((sizeof(uint32_t) + (size) + CANAS_SHM_ALIGN - 1) & ~(CANAS_SHM_ALIGN - 1))
+//! Size of a record marking the end of the ring, the next record starts at offset 0.
+#define CANAS_SHM_WRAP 0xffffffff
+//! Max. time the reader waits for the writer before it increments its heartbeat again.
+#define CANAS_SHM_WAIT_MS 100
+
+//! Header of the ring in host byte order, followed by CANAS_SHM_CAPACITY
+//! bytes of records. A record is the uint32_t size of a datagram followed by
+//! the datagram, padded to CANAS_SHM_ALIGN. Head and tail are byte counts
+//! which only grow, the writer only changes head, the reader only tail.
+typedef struct canAS_shm_ring_t {
+    uint32_t    magic;              //!< CANAS_SHM_MAGIC, set after the header is complete
+    uint32_t    version;            //!< CANAS_SHM_VERSION
+    uint32_t    capacity;           //!< CANAS_SHM_CAPACITY
+    uint32_t    writer_pid;
+    uint32_t    wakeup;             //!< Futex word, incremented by the writer after new records.
+    uint32_t    reader_waiting;     //!< 1 while the reader waits on the futex word.
+    uint32_t    reader_heartbeat;   //!< Incremented by the reader at least every CANAS_SHM_WAIT_MS.
+    uint32_t    ring_active;        //!< 1 while the writer writes the datagrams into the ring.
+    uint32_t    reader_pid;         //!< Receiver which claimed the ring, 0 for none.
+    uint8_t     pad0[28];
+    uint64_t    head;               //!< Bytes written, on its own cache line.
+    uint8_t     pad1[56];
+    uint64_t    tail;               //!< Bytes read, on its own cache line.
+    uint8_t     pad2[56];
+} canAS_shm_ring_t;
+
 #endif // CANAS_H
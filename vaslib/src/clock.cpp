@@ -0,0 +1,66 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    clock.cpp
+    \author  vasFMC contributors
+*/
+
+#include "clock.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+Clock* Clock::m_current = 0;
+
+/////////////////////////////////////////////////////////////////////////////
+
+Clock* Clock::systemClock()
+{
+    static SystemClock system_clock;
+    return &system_clock;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+ScaledClock::ScaledClock(double speed_factor, const Clock* source) :
+    m_source(source != 0 ? source : Clock::systemClock()), m_speed_factor(speed_factor)
+{
+    MYASSERT(m_speed_factor > 0.0);
+    m_source_anchor_ms = m_source->msecs();
+    m_anchor_ms = m_source_anchor_ms;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+qint64 ScaledClock::msecs() const
+{
+    return m_anchor_ms + (qint64)((m_source->msecs() - m_source_anchor_ms) * m_speed_factor);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void ScaledClock::setSpeedFactor(double speed_factor)
+{
+    MYASSERT(speed_factor > 0.0);
+    m_anchor_ms = msecs();
+    m_source_anchor_ms = m_source->msecs();
+    m_speed_factor = speed_factor;
+}
+
+// End of file
@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    clock.h
+    \author  vasFMC contributors
+*/
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+
+#include "assert.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Time source for smoothing, controllers, the flightstatus and the FMC
+//! timers. The system clock is used unless an other clock was set with
+//! setCurrent(), e.g. a scaled clock to replay a recorded flight faster than
+//! real time or a manual clock to step through a replay deterministically.
+class Clock
+{
+public:
+    //! Standard Constructor
+    Clock() {};
+
+    //! Destructor
+    virtual ~Clock() {};
+
+    //! returns the current time in ms, the epoch is arbitrary but fixed
+    virtual qint64 msecs() const = 0;
+
+    //! returns how much faster than the real time the clock runs
+    virtual double speedFactor() const { return 1.0; }
+
+    //-----
+
+    //! returns the clock used by all clock timers
+    static Clock* current()
+    {
+        if (m_current == 0) return systemClock();
+        return m_current;
+    }
+
+    //! sets the clock used by all clock timers, 0 switches back to the
+    //! system clock. The caller keeps the ownership of the given clock.
+    //! Running timers keep their start time and measure against the new
+    //! clock from now on. A clock set while timers are running should
+    //! therefore continue from the time of the clock it replaces (like a
+    //! ScaledClock with the current clock as source does), otherwise their
+    //! elapsed time jumps by the difference of both clocks. E.g. switching
+    //! back from a faster scaled clock to the system clock makes the running
+    //! timers elapse less (or even negative) until they are restarted.
+    static void setCurrent(Clock* clock) { m_current = clock; }
+
+    //! returns the real time clock
+    static Clock* systemClock();
+
+protected:
+
+    static Clock* m_current;
+
+private:
+    //! Hidden copy-constructor
+    Clock(const Clock&);
+    //! Hidden assignment operator
+    const Clock& operator = (const Clock&);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! monotonic real time clock
+class SystemClock : public Clock
+{
+public:
+
+    SystemClock() { m_timer.start(); }
+    virtual ~SystemClock() {}
+
+    virtual qint64 msecs() const { return m_timer.elapsed(); }
+
+protected:
+
+    QElapsedTimer m_timer;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! clock running with a multiple of the speed of a source clock
+class ScaledClock : public Clock
+{
+public:
+
+    //! when source is 0, the system clock will be used
+    ScaledClock(double speed_factor, const Clock* source = 0);
+    virtual ~ScaledClock() {}
+
+    virtual qint64 msecs() const;
+    virtual double speedFactor() const { return m_speed_factor; }
+
+    //! changes the speed, the time continues from the current value
+    void setSpeedFactor(double speed_factor);
+
+protected:
+
+    const Clock* m_source;
+    double m_speed_factor;
+    qint64 m_source_anchor_ms;
+    qint64 m_anchor_ms;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! clock which only advances when told so
+class ManualClock : public Clock
+{
+public:
+
+    ManualClock(qint64 start_ms = 0) : m_now_ms(start_ms) {}
+    virtual ~ManualClock() {}
+
+    virtual qint64 msecs() const { return m_now_ms; }
+
+    void setMsecs(qint64 now_ms) { MYASSERT(now_ms >= m_now_ms); m_now_ms = now_ms; }
+    void advanceMsecs(qint64 delta_ms) { MYASSERT(delta_ms >= 0); m_now_ms += delta_ms; }
+
+protected:
+
+    qint64 m_now_ms;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! replacement for QTime::start()/elapsed() based timers, reads the
+//! current clock. A timer which was never started is treated as started
+//! long ago.
+class ClockTimer
+{
+public:
+
+    ClockTimer() : m_started(false), m_start_ms(0) {}
+
+    inline void start()
+    {
+        m_started = true;
+        m_start_ms = Clock::current()->msecs();
+    }
+
+    //! starts the timer as if it was started the given ms ago
+    inline void setElapsed(int elapsed_ms)
+    {
+        start();
+        m_start_ms -= elapsed_ms;
+    }
+
+    //! returns the ms since the timer was started
+    inline int elapsed() const
+    {
+        if (!m_started) return LONG_AGO_MS;
+        return (int)qMin(Clock::current()->msecs() - m_start_ms, (qint64)LONG_AGO_MS);
+    }
+
+    //! restarts the timer and returns the ms elapsed before
+    inline int restart()
+    {
+        int elapsed_ms = elapsed();
+        start();
+        return elapsed_ms;
+    }
+
+    inline bool isStarted() const { return m_started; }
+
+protected:
+
+    //! elapsed value returned for timers which were not started (~24 days)
+    static const int LONG_AGO_MS = 0x7fffffff / 1000 * 1000;
+
+    bool m_started;
+    qint64 m_start_ms;
+};
+
+#endif /* CLOCK_H */
+
+// End of file
@@ -25,8 +25,7 @@
 #ifndef __CONTROLLER_BASE_H__
 #define __CONTROLLER_BASE_H__
 
-#include <QTime>
-
+#include "clock.h"
 #include "flightstatus.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -66,7 +65,7 @@ protected:
     double m_max_output;
     double m_output;
 
-    QTime m_last_call_dt;
+    ClockTimer m_last_call_dt;
 
 private:
     //! Hidden copy-constructor
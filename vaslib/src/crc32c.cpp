@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    crc32c.cpp
+    \author  vasFMC contributors
+*/
+
+
+#include <string.h>
+
+#include "crc32c.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC32C_SSE42 1
+#define CRC32C_TARGET_SSE42 __attribute__((target("sse4.2")))
+#include <cpuid.h>
+#include <nmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CRC32C_SSE42 1
+#define CRC32C_TARGET_SSE42
+#include <intrin.h>
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#define CRC32C_ARMV8 1
+#include <arm_acle.h>
+#endif
+
+//! reversed Castagnoli polynomial
+#define CRC32C_POLYNOMIAL 0x82f63b78
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! the tables for slicing-by-8, table[k][i] is the CRC of byte i followed by k zero bytes
+class Crc32cTables
+{
+public:
+
+    Crc32cTables()
+    {
+        for (int index=0; index < 256; ++index)
+        {
+            quint32 crc = index;
+            for (int bit=0; bit < 8; ++bit) crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+            table[0][index] = crc;
+        }
+
+        for (int index=0; index < 256; ++index)
+            for (int slice=1; slice < 8; ++slice)
+                table[slice][index] = (table[slice-1][index] >> 8) ^ table[0][table[slice-1][index] & 0xff];
+    }
+
+    quint32 table[8][256];
+};
+
+static const Crc32cTables crc32c_tables;
+
+/////////////////////////////////////////////////////////////////////////////
+
+static inline quint32 readLittleEndian32(const uchar* data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((quint32)data[3] << 24);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+static quint32 crc32cSlicingBy8(const uchar* data, int length, quint32 crc)
+{
+    const quint32 (*table)[256] = crc32c_tables.table;
+
+    while (length >= 8)
+    {
+        quint32 low = readLittleEndian32(data) ^ crc;
+        quint32 high = readLittleEndian32(data + 4);
+
+        crc = table[7][low & 0xff] ^ table[6][(low >> 8) & 0xff] ^
+              table[5][(low >> 16) & 0xff] ^ table[4][low >> 24] ^
+              table[3][high & 0xff] ^ table[2][(high >> 8) & 0xff] ^
+              table[1][(high >> 16) & 0xff] ^ table[0][high >> 24];
+
+        data += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0) crc = table[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+#if CRC32C_SSE42
+
+CRC32C_TARGET_SSE42 static quint32 crc32cSse42(const uchar* data, int length, quint32 crc)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    while (length >= 8)
+    {
+        quint64 value;
+        memcpy(&value, data, sizeof(value));
+        crc = (quint32)_mm_crc32_u64(crc, value);
+        data += 8;
+        length -= 8;
+    }
+#endif
+
+    while (length >= 4)
+    {
+        quint32 value;
+        memcpy(&value, data, sizeof(value));
+        crc = _mm_crc32_u32(crc, value);
+        data += 4;
+        length -= 4;
+    }
+
+    while (length-- > 0) crc = _mm_crc32_u8(crc, *data++);
+    return crc;
+}
+
+static bool cpuHasSse42()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx & bit_SSE4_2) != 0;
+#endif
+}
+
+static const bool crc32c_use_sse42 = cpuHasSse42();
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+
+#if CRC32C_ARMV8
+
+static quint32 crc32cArmv8(const uchar* data, int length, quint32 crc)
+{
+    while (length >= 8)
+    {
+        quint64 value;
+        memcpy(&value, data, sizeof(value));
+        crc = __crc32cd(crc, value);
+        data += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0) crc = __crc32cb(crc, *data++);
+    return crc;
+}
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+
+quint32 Crc32c::checksum(const char* data, int length, quint32 crc)
+{
+    const uchar* bytes = (const uchar*)data;
+    crc = ~crc;
+
+#if CRC32C_SSE42
+    if (crc32c_use_sse42) return ~crc32cSse42(bytes, length, crc);
+#elif CRC32C_ARMV8
+    return ~crc32cArmv8(bytes, length, crc);
+#endif
+
+    return ~crc32cSlicingBy8(bytes, length, crc);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool Crc32c::isHardwareAccelerated()
+{
+#if CRC32C_SSE42
+    return crc32c_use_sse42;
+#elif CRC32C_ARMV8
+    return true;
+#else
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+// End of file
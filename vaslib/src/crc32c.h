@@ -0,0 +1,54 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    crc32c.h
+    \author  vasFMC contributors
+*/
+
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <QtGlobal>
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! CRC-32C (Castagnoli) checksum. Uses the CRC instructions of SSE4.2 (x86,
+//! detected at runtime) or ARMv8 (when compiled for them) and falls back to
+//! slicing-by-8 tables on other CPUs.
+class Crc32c
+{
+public:
+
+    //! returns the checksum of the given data, a checksum over several
+    //! blocks is calculated by passing the result of the previous block.
+    static quint32 checksum(const char* data, int length, quint32 crc = 0);
+
+    //! returns true if the CRC instructions of the CPU are used
+    static bool isHardwareAccelerated();
+
+private:
+    //! Hidden constructor
+    Crc32c();
+};
+
+#endif /* CRC32C_H */
+
+// End of file
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    datagram_recorder.cpp
+    \author  vasFMC contributors
+*/
+
+#include "assert.h"
+#include "logger.h"
+
+#include "datagram_recorder.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+DatagramRecorder::DatagramRecorder() : m_record_count(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+DatagramRecorder::~DatagramRecorder()
+{
+    close();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool DatagramRecorder::open(const QString& filename)
+{
+    close();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        Logger::log(QString("DatagramRecorder:open: could not open file (%1)").arg(filename));
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_4_0);
+    m_stream << MAGIC << VERSION << (quint16)0;
+
+    m_record_count = 0;
+    m_start_timer.start();
+    Logger::log(QString("DatagramRecorder:open: recording to (%1)").arg(filename));
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void DatagramRecorder::close()
+{
+    if (!m_file.isOpen()) return;
+    m_stream.setDevice(0);
+    m_file.close();
+    Logger::log(QString("DatagramRecorder:close: recorded %1 datagrams").arg(m_record_count));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool DatagramRecorder::record(const char* data, uint size)
+{
+    if (!m_file.isOpen()) return false;
+    MYASSERT(size <= 0xffff);
+
+    m_stream << (quint32)m_start_timer.elapsed() << (quint16)size;
+    if (m_stream.writeRawData(data, size) != (int)size)
+    {
+        Logger::log("DatagramRecorder:record: write error, stopping recording");
+        close();
+        return false;
+    }
+
+    ++m_record_count;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+DatagramRecordReader::DatagramRecordReader() : m_record_count(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+DatagramRecordReader::~DatagramRecordReader()
+{
+    close();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool DatagramRecordReader::open(const QString& filename)
+{
+    close();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        Logger::log(QString("DatagramRecordReader:open: could not open file (%1)").arg(filename));
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_4_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 reserved = 0;
+    m_stream >> magic >> version >> reserved;
+
+    if (magic != DatagramRecorder::MAGIC || version != DatagramRecorder::VERSION)
+    {
+        Logger::log(QString("DatagramRecordReader:open: (%1) is not a datagram record file "
+                            "or has an unsupported version (%2)").arg(filename).arg(version));
+        close();
+        return false;
+    }
+
+    m_record_count = 0;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void DatagramRecordReader::close()
+{
+    if (!m_file.isOpen()) return;
+    m_stream.setDevice(0);
+    m_file.close();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool DatagramRecordReader::next(quint32& timestamp_ms, QByteArray& data)
+{
+    if (atEnd()) return false;
+
+    quint16 size = 0;
+    m_stream >> timestamp_ms >> size;
+    data.resize(size);
+    if (m_stream.status() != QDataStream::Ok || m_stream.readRawData(data.data(), size) != size)
+    {
+        Logger::log("DatagramRecordReader:next: truncated record, stopping");
+        close();
+        return false;
+    }
+
+    ++m_record_count;
+    return true;
+}
+
+// End of file
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    datagram_recorder.h
+    \author  vasFMC contributors
+*/
+
+#ifndef DATAGRAM_RECORDER_H
+#define DATAGRAM_RECORDER_H
+
+#include <QFile>
+#include <QDataStream>
+#include <QString>
+#include <QByteArray>
+
+#include "clock.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Records raw datagrams (e.g. the CAN messages from the X-Plane plugin)
+//! with a timestamp to a compact binary file.
+//! File layout (big endian): magic "VFDR", quint16 version, quint16 reserved,
+//! then one record per datagram: quint32 ms since start, quint16 size, data.
+class DatagramRecorder
+{
+public:
+
+    //! Standard Constructor
+    DatagramRecorder();
+
+    //! Destructor
+    virtual ~DatagramRecorder();
+
+    //! opens (and truncates) the given file, returns true on success
+    bool open(const QString& filename);
+
+    //! flushes and closes the file
+    void close();
+
+    inline bool isOpen() const { return m_file.isOpen(); }
+    inline uint recordCount() const { return m_record_count; }
+
+    //! appends the given datagram to the file
+    bool record(const char* data, uint size);
+
+    static const quint32 MAGIC = 0x56464452; // "VFDR"
+    static const quint16 VERSION = 1;
+
+protected:
+
+    QFile m_file;
+    QDataStream m_stream;
+    ClockTimer m_start_timer;
+    uint m_record_count;
+
+private:
+    //! Hidden copy-constructor
+    DatagramRecorder(const DatagramRecorder&);
+    //! Hidden assignment operator
+    const DatagramRecorder& operator = (const DatagramRecorder&);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Reads the datagrams written by the DatagramRecorder.
+class DatagramRecordReader
+{
+public:
+
+    //! Standard Constructor
+    DatagramRecordReader();
+
+    //! Destructor
+    virtual ~DatagramRecordReader();
+
+    //! opens the given file and checks the header, returns true on success
+    bool open(const QString& filename);
+
+    void close();
+
+    inline bool isOpen() const { return m_file.isOpen(); }
+    inline bool atEnd() const { return !m_file.isOpen() || m_stream.atEnd(); }
+    inline uint recordCount() const { return m_record_count; }
+
+    //! reads the next record, the data buffer is reused. Returns false at
+    //! the end of the file or when the record is corrupt.
+    bool next(quint32& timestamp_ms, QByteArray& data);
+
+protected:
+
+    QFile m_file;
+    QDataStream m_stream;
+    uint m_record_count;
+
+private:
+    //! Hidden copy-constructor
+    DatagramRecordReader(const DatagramRecordReader&);
+    //! Hidden assignment operator
+    const DatagramRecordReader& operator = (const DatagramRecordReader&);
+};
+
+#endif /* DATAGRAM_RECORDER_H */
+
+// End of file
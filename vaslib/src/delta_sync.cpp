@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    delta_sync.cpp
+    \author  vasFMC contributors
+*/
+
+
+#include "assert.h"
+#include "logger.h"
+
+#include "delta_sync.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! message layout, all counts and indices are quint16:
+//! version (quint8), type (quint8), sequence (quint32), field count,
+//! keyframe: all fields
+//! delta: unchanged head count, unchanged tail count, changed field count,
+//!        index and value of every changed field
+//! fields are written with a quint8 length, 0xff is followed by a quint32 length.
+
+#define LONG_FIELD_MARKER 0xff
+
+static void writeField(QDataStream& out, const QByteArray& field)
+{
+    if (field.size() < LONG_FIELD_MARKER) out << (quint8)field.size();
+    else out << (quint8)LONG_FIELD_MARKER << (quint32)field.size();
+    out.writeRawData(field.constData(), field.size());
+}
+
+static bool readField(QDataStream& in, QByteArray& field)
+{
+    quint8 short_size;
+    in >> short_size;
+    quint32 size = short_size;
+    if (short_size == LONG_FIELD_MARKER) in >> size;
+    if (in.status() != QDataStream::Ok || size > (quint32)in.device()->bytesAvailable()) return false;
+
+    field.resize(size);
+    return in.readRawData(field.data(), size) == (int)size;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void DeltaSyncFields::writeTo(QDataStream& out) const
+{
+    for (int index=0; index < m_fields.count(); ++index)
+        out.writeRawData(m_fields.at(index).constData(), m_fields.at(index).size());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+QByteArray DeltaSyncFields::join(const QList<QByteArray>& fields)
+{
+    QByteArray data;
+    for (int index=0; index < fields.count(); ++index) data += fields.at(index);
+    return data;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+DeltaSyncSender::DeltaSyncSender(int keyframe_interval_ms) :
+    m_keyframe_interval_ms(keyframe_interval_ms), m_keyframe_requested(false), m_sequence(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+QByteArray DeltaSyncSender::encode(const QList<QByteArray>& fields, bool keyframe)
+{
+    MYASSERT(fields.count() <= 0xffff);
+
+    if (keyframe || m_keyframe_requested || m_sequence == 0 ||
+        m_keyframe_timer.elapsed() >= m_keyframe_interval_ms)
+        return encodeKeyframe(fields);
+
+    if (fields == m_sent_fields) return QByteArray();
+    return encodeDelta(fields);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+QByteArray DeltaSyncSender::encodeKeyframe(const QList<QByteArray>& fields)
+{
+    QByteArray message;
+    QDataStream ds(&message, QIODevice::WriteOnly);
+    ds << (quint8)DELTA_SYNC_VERSION << (quint8)MESSAGE_KEYFRAME << ++m_sequence << (quint16)fields.count();
+    for (int index=0; index < fields.count(); ++index) writeField(ds, fields.at(index));
+
+    m_sent_fields = fields;
+    m_keyframe_requested = false;
+    m_keyframe_timer.start();
+    return message;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+QByteArray DeltaSyncSender::encodeDelta(const QList<QByteArray>& fields)
+{
+    int old_count = m_sent_fields.count();
+    int new_count = fields.count();
+
+    // skip the unchanged head and tail, so inserted or removed fields only
+    // send the fields in between
+
+    int head = 0;
+    while (head < old_count && head < new_count && m_sent_fields.at(head) == fields.at(head)) ++head;
+
+    int tail = 0;
+    while (tail < old_count - head && tail < new_count - head &&
+           m_sent_fields.at(old_count - 1 - tail) == fields.at(new_count - 1 - tail)) ++tail;
+
+    // fields in between which are still at their old index and did not
+    // change are kept by the receiver
+
+    QList<int> changed_list;
+    for (int index=head; index < new_count - tail; ++index)
+        if (index >= old_count - tail || m_sent_fields.at(index) != fields.at(index))
+            changed_list.append(index);
+
+    QByteArray message;
+    QDataStream ds(&message, QIODevice::WriteOnly);
+    ds << (quint8)DELTA_SYNC_VERSION << (quint8)MESSAGE_DELTA << ++m_sequence
+       << (quint16)new_count << (quint16)head << (quint16)tail << (quint16)changed_list.count();
+
+    for (int index=0; index < changed_list.count(); ++index)
+    {
+        ds << (quint16)changed_list.at(index);
+        writeField(ds, fields.at(changed_list.at(index)));
+    }
+
+    m_sent_fields = fields;
+    return message;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+DeltaSyncReceiver::DeltaSyncReceiver() : m_valid(false), m_sequence(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool DeltaSyncReceiver::decode(const QByteArray& message)
+{
+    QDataStream ds(message);
+
+    quint8 version, type;
+    quint32 sequence;
+    quint16 count;
+    ds >> version >> type >> sequence >> count;
+
+    if (ds.status() != QDataStream::Ok) return false;
+
+    if (version != DELTA_SYNC_VERSION)
+    {
+        Logger::log(QString("DeltaSyncReceiver:decode: got version %1, expected %2 - discarding").
+                    arg(version).arg(DELTA_SYNC_VERSION));
+        return false;
+    }
+
+    QList<QByteArray> fields;
+
+    if (type == DeltaSyncSender::MESSAGE_KEYFRAME)
+    {
+        QByteArray field;
+        for (int index=0; index < count; ++index)
+        {
+            if (!readField(ds, field)) return false;
+            fields.append(field);
+        }
+    }
+    else if (type == DeltaSyncSender::MESSAGE_DELTA)
+    {
+        if (!m_valid || sequence != m_sequence + 1)
+        {
+            m_valid = false;
+            return false;
+        }
+
+        quint16 head, tail, changed_count;
+        ds >> head >> tail >> changed_count;
+
+        int old_count = m_fields.count();
+        if (ds.status() != QDataStream::Ok || head + tail > old_count || head + tail > count)
+        {
+            m_valid = false;
+            return false;
+        }
+
+        fields = m_fields.mid(0, head);
+
+        // the changed fields come in ascending order, the others are kept
+
+        int next_changed = -1;
+        int changed_read = 0;
+        QByteArray field;
+
+        for (int index=head; index < count - tail; ++index)
+        {
+            if (next_changed < index && changed_read < changed_count)
+            {
+                quint16 changed_index;
+                ds >> changed_index;
+                if (!readField(ds, field) || changed_index < index || changed_index >= count - tail)
+                {
+                    m_valid = false;
+                    return false;
+                }
+                next_changed = changed_index;
+                ++changed_read;
+            }
+
+            if (next_changed == index) fields.append(field);
+            else if (index < old_count - tail) fields.append(m_fields.at(index));
+            else
+            {
+                m_valid = false;
+                return false;
+            }
+        }
+
+        if (changed_read != changed_count)
+        {
+            m_valid = false;
+            return false;
+        }
+
+        fields += m_fields.mid(old_count - tail);
+    }
+    else
+    {
+        Logger::log(QString("DeltaSyncReceiver:decode: got unknown message type %1 - discarding").arg(type));
+        return false;
+    }
+
+    m_fields = fields;
+    m_sequence = sequence;
+    m_valid = true;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool DeltaSyncReceiver::shouldRequestKeyframe()
+{
+    if (m_valid) return false;
+    if (m_keyframe_request_timer.elapsed() < DELTA_SYNC_KEYFRAME_REQUEST_MS) return false;
+
+    m_keyframe_request_timer.start();
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+// End of file
@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    delta_sync.h
+    \author  vasFMC contributors
+*/
+
+
+#ifndef DELTA_SYNC_H
+#define DELTA_SYNC_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QList>
+
+#include "clock.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! version of the delta sync messages, a receiver discards other versions
+#define DELTA_SYNC_VERSION 1
+
+//! a full keyframe goes out at least that often
+#define DELTA_SYNC_KEYFRAME_MS 5000
+
+//! a receiver missing a keyframe asks for it at most that often
+#define DELTA_SYNC_KEYFRAME_REQUEST_MS 1000
+
+//! elapsed times are synced up to that limit, so they stop changing their field
+#define DELTA_SYNC_ELAPSED_LIMIT_MS 60000
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Collects every value streamed into it as a seperate field, used by the
+//! objects synced to remote FMCs to split their state for DeltaSyncSender.
+class DeltaSyncFields
+{
+public:
+
+    DeltaSyncFields() {};
+
+    template <class T> DeltaSyncFields& operator<<(const T& value)
+    {
+        QByteArray field;
+        QDataStream ds(&field, QIODevice::WriteOnly);
+        ds << value;
+        m_fields.append(field);
+        return *this;
+    }
+
+    inline const QList<QByteArray>& fields() const { return m_fields; }
+
+    //! writes the fields to the given stream as if the values were streamed into it
+    void writeTo(QDataStream& out) const;
+
+    //! returns the given fields joined in one array which reads like the stream of writeTo()
+    static QByteArray join(const QList<QByteArray>& fields);
+
+protected:
+
+    QList<QByteArray> m_fields;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Encodes the fields of a synced object into delta sync messages. Every
+//! message carrying changes gets the next sequence number, a delta only
+//! carries the fields which changed since the previous message and names the
+//! sequence number it is based on. Fields inserted or removed in the middle
+//! (e.g. route legs) only send the fields in between the unchanged head and
+//! tail. A keyframe with all fields goes out every DELTA_SYNC_KEYFRAME_MS or
+//! when requested.
+class DeltaSyncSender
+{
+public:
+
+    enum MESSAGE_TYPE { MESSAGE_KEYFRAME = 0,
+                        MESSAGE_DELTA = 1
+    };
+
+    //! Standard Constructor
+    DeltaSyncSender(int keyframe_interval_ms = DELTA_SYNC_KEYFRAME_MS);
+
+    //! returns the message for the given fields, an empty array if there is
+    //! nothing to send because no field changed and no keyframe is due
+    QByteArray encode(const QList<QByteArray>& fields, bool keyframe = false);
+
+    //! the next call to encode() returns a keyframe
+    inline void requestKeyframe() { m_keyframe_requested = true; }
+
+    inline quint32 sequence() const { return m_sequence; }
+
+protected:
+
+    QByteArray encodeKeyframe(const QList<QByteArray>& fields);
+    QByteArray encodeDelta(const QList<QByteArray>& fields);
+
+protected:
+
+    int m_keyframe_interval_ms;
+    ClockTimer m_keyframe_timer;
+    bool m_keyframe_requested;
+
+    quint32 m_sequence;
+    QList<QByteArray> m_sent_fields;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Decodes the messages of a DeltaSyncSender. Deltas which are not based on
+//! the sequence number received last are discarded until the next keyframe.
+class DeltaSyncReceiver
+{
+public:
+
+    //! Standard Constructor
+    DeltaSyncReceiver();
+
+    //! applies the given message, returns false if it was discarded
+    bool decode(const QByteArray& message);
+
+    //! returns true while we wait for a keyframe and did not ask for it
+    //! within the last DELTA_SYNC_KEYFRAME_REQUEST_MS
+    bool shouldRequestKeyframe();
+
+    inline bool isValid() const { return m_valid; }
+    inline quint32 sequence() const { return m_sequence; }
+    inline const QList<QByteArray>& fields() const { return m_fields; }
+
+protected:
+
+    bool m_valid;
+    quint32 m_sequence;
+    QList<QByteArray> m_fields;
+    ClockTimer m_keyframe_request_timer;
+};
+
+#endif /* DELTA_SYNC_H */
+
+// End of file
@@ -29,6 +29,8 @@
 #include <QString>
 #include <QTime>
 
+#include "clock.h"
+
 class FlightStatus;
 class FMCDataProvider;
 
@@ -106,7 +108,7 @@ protected:
     const FlightStatus* m_flightstatus;
     const FMCDataProvider* m_fmc_data_provider;
 
-    QTime m_check_timer;
+    ClockTimer m_check_timer;
 
     FLIGHTMODE m_current_flight_mode;
     FLIGHTMODE m_prev_flight_mode;
@@ -1548,7 +1548,7 @@ void FlightRoute::calcDistanceActiveWptToDestination()
 
 /////////////////////////////////////////////////////////////////////////////
 
-void FlightRoute::operator<<(QDataStream& in)
+void FlightRoute::readHeader(QDataStream& in)
 {
     in >> m_adep_wpt_index
        >> m_adep_id
@@ -1574,12 +1574,12 @@ void FlightRoute::operator<<(QDataStream& in)
     m_alt_reach_wpt << in;
     m_tod_wpt << in;
 
-    Route::operator<<(in);
+    Route::readHeader(in);
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
-void FlightRoute::operator>>(QDataStream& out) const
+void FlightRoute::writeHeader(QDataStream& out) const
 {
     out << m_adep_wpt_index
         << m_adep_id
@@ -1605,7 +1605,7 @@ void FlightRoute::operator>>(QDataStream& out) const
     m_alt_reach_wpt >> out;
     m_tod_wpt >> out;
 
-    Route::operator>>(out);
+    Route::writeHeader(out);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -59,9 +59,6 @@ public:
     //! returns false if the given start index is behind the last waypoint
     virtual bool calcProjection(const ProjectionBase& projection, int start_index = 0, int end_index = -1);
 
-    virtual void operator<<(QDataStream& in);
-    virtual void operator>>(QDataStream& out) const;
-
     //-----
 
     virtual void clear();
@@ -303,6 +300,9 @@ signals:
 
 protected:
 
+    virtual void writeHeader(QDataStream& out) const;
+    virtual void readHeader(QDataStream& in);
+
     void setAsDepartureAirportInternal(uint wpt_index, const QString& active_runway);
     void setAsDestinationAirportInternal(uint wpt_index, const QString& active_runway);
 
@@ -28,57 +28,40 @@
 
 /////////////////////////////////////////////////////////////////////////////
 
-uint EngineData::m_smooth_delay_ms = 0;
-
 const int FlightStatus::TO = 1;
 const int FlightStatus::FROM = 2;
 
 /////////////////////////////////////////////////////////////////////////////
 
 FlightStatus::FlightStatus(uint smooth_delay_ms) : 
-    smoothed_ias(false, false, 40, smooth_delay_ms, true),
-    smoothed_altimeter_readout(false, false, 40, smooth_delay_ms),
-    smoothed_vs(false, false, 40, smooth_delay_ms),
-    pitch(false, false, 40, smooth_delay_ms, true),
-    bank(false, false, 40, smooth_delay_ms, true),
-    fpv_vertical(false, false, 40, smooth_delay_ms, true),
-    nav1_bearing(true, false, 40, smooth_delay_ms), 
-    nav2_bearing(true, false, 40, smooth_delay_ms), 
-    adf1_bearing(true, false, 40, smooth_delay_ms), 
-    adf2_bearing(true, false, 40, smooth_delay_ms),
-    lat_smoothed(false, true, 40, smooth_delay_ms), 
-    lon_smoothed(false, true, 40, smooth_delay_ms),
-    m_true_heading(true, false, 40, smooth_delay_ms),
-    m_magnetic_track(true, false, 40, smooth_delay_ms),
-    m_fd_pitch(false, false, 40, smooth_delay_ms), 
+    m_smoothing(smooth_delay_ms),
+    smoothed_ias(&m_smoothing, false, false),
+    smoothed_altimeter_readout(&m_smoothing, false, false),
+    smoothed_vs(&m_smoothing, false, false),
+    pitch(&m_smoothing, false, false),
+    bank(&m_smoothing, false, false),
+    fpv_vertical(&m_smoothing, false, false),
+    nav1_bearing(&m_smoothing, true, false), 
+    nav2_bearing(&m_smoothing, true, false), 
+    adf1_bearing(&m_smoothing, true, false), 
+    adf2_bearing(&m_smoothing, true, false),
+    lat_smoothed(&m_smoothing, false, true), 
+    lon_smoothed(&m_smoothing, false, true),
+    m_true_heading(&m_smoothing, true, false),
+    m_magnetic_track(&m_smoothing, true, false),
+    m_fd_pitch(&m_smoothing, false, false), 
     m_fd_pitch_input_from_external(true),
-    m_fd_bank(false, false, 40, smooth_delay_ms), 
+    m_fd_bank(&m_smoothing, false, false), 
     m_fd_bank_input_from_external(true),
     m_fd_was_active(false)
 {
-    EngineData::m_smooth_delay_ms = smooth_delay_ms;
-
-    smoothed_ias.doTrendLowPass(true, 0.6);
-    m_fd_pitch.doLowPass(true, 0.5);
-    m_fd_bank.doLowPass(true, 0.5);
-
-//TODO for debugging
-//     smoothed_ias.setName("IAS");
-//     smoothed_altimeter_readout.setName("ALT");
-//     smoothed_vs.setName("VS");
-//     pitch.setName("Pitch");
-//     bank.setName("Bank");
-//     fpv_vertical.setName("FPV");
-//     nav1_bearing.setName("NAV1");
-//     nav2_bearing.setName("NAV2");
-//     adf1_bearing.setName("ADF1");
-//     adf2_bearing.setName("ADF2");
-//     lat_smoothed.setName("LAT");
-//     lon_smoothed.setName("LON");
-//     m_true_heading.setName("THDG");
-//     m_magnetic_track.setName("MTRACK");
-//    m_fd_pitch.setName("FDPitch");
-//    m_fd_bank.setName("FDBank");
+    m_smoothing.setTrendFilter(smoothed_ias.channel(), 40);
+    m_smoothing.setTrendLowPass(smoothed_ias.channel(), 0.6);
+    m_smoothing.setTrendFilter(pitch.channel(), 40);
+    m_smoothing.setTrendFilter(bank.channel(), 40);
+    m_smoothing.setTrendFilter(fpv_vertical.channel(), 40);
+    m_smoothing.setLowPass(m_fd_pitch.channel(), 0.5);
+    m_smoothing.setLowPass(m_fd_bank.channel(), 0.5);
 
     clear();
 
@@ -241,7 +224,7 @@ void FlightStatus::clear()
     m_altimeter_pressure_setting_hpa = 0.0;
 
     doors_open = pitot_heat_on = false;
-    m_flaps_transit_timer = QTime::currentTime().addSecs(-10);
+    m_flaps_transit_timer.setElapsed(10000);
     pushback_status = FSAccess::PUSHBACK_STOP;
     //TODOtime_of_day = TIME_OF_DAY_INVALID;
 
@@ -250,6 +233,21 @@ void FlightStatus::clear()
 
 /////////////////////////////////////////////////////////////////////////////
 
+void FlightStatus::setN1(uint engine, const double& n1_percent)
+{
+    MYASSERT(engine > 0);
+    EngineData& data = engine_data[engine];
+    if (!data.smoothed_n1.isAttached())
+    {
+        int channel = m_smoothing.addChannel(false, false);
+        m_smoothing.setTrendFilter(channel, 10);
+        data.smoothed_n1.attach(&m_smoothing, channel);
+    }
+    data.smoothed_n1 = n1_percent;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 QString FlightStatus::toString() const
 {
     return QString("valid=%1/paused=%2/lat=%3/lon=%4/thdg=%5/ias=%6").
@@ -290,6 +288,9 @@ void FlightStatus::recalc()
     fpv_vertical_previous = fpv_vertical.lastValue();
     fpv_vertical = Navcalc::getFlightPath(smoothedVS(), ground_speed_kts);
 
+    // commit all smoothed values received so far as one sample
+    m_smoothing.sample();
+
     if (fd_active)
     {
         if (!m_fd_was_active)
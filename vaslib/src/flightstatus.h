@@ -30,7 +30,9 @@
 #include "waypoint.h"
 #include "ils.h"
 #include "navcalc.h"
+#include "clock.h"
 #include "smoothing.h"
+#include "smoothing_engine.h"
 
 /////////////////////////////////////////////////////////////////////////////
 
@@ -63,7 +65,6 @@ class EngineData
 public:
     //! Standard Constructor
     EngineData() :
-        smoothed_n1(false, false, 10, m_smooth_delay_ms, true),
         n2_percent(0.0), egt_degrees(0), ff_kg_per_hour(0), anti_ice_on(false),
         throttle_lever_percent(0.0), reverser_percent(0.0), throttle_input_percent(0.0)
     {}
@@ -75,7 +76,9 @@ public:
 
 public:
 
-    SmoothedValueWithDelay<double> smoothed_n1;
+    //! attached to the smoothing engine of the flightstatus with the first
+    //! FlightStatus::setN1() of the engine
+    SmoothedChannel smoothed_n1;
     double n2_percent;
     double egt_degrees;
     double ff_kg_per_hour;
@@ -85,8 +88,6 @@ public:
     double reverser_percent;
     
     double throttle_input_percent;
-
-    static uint m_smooth_delay_ms;
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -118,13 +119,15 @@ public:
     inline void invalidate() 
     {
         m_valid = false; 
-        //TODO debugging
-        smoothed_altimeter_readout.setName(QString::null);
     }
 
     void clear();
     QString toString() const;
 
+    //! sets the N1 of the given engine (1 = first engine), the smoothing
+    //! channel of the engine is created with its first value.
+    void setN1(uint engine, const double& n1_percent);
+
     inline void recalcAndSetValid()
     {
         recalc();
@@ -330,6 +333,11 @@ public:
     void setAltPressureSettingHpaExternal(double value)
     { if (m_altimeter_pressure_setting_hpa_read_delay_timer.elapsed() >= 2000) m_altimeter_pressure_setting_hpa = value; }
 
+protected:
+
+    //! holds the history of all smoothed values, must be declared before the channels
+    SmoothingEngine m_smoothing;
+
 public:
 
     // position and movement data
@@ -337,15 +345,15 @@ public:
     double lat;
     double lon;
     double tas;
-    SmoothedValueWithDelay<double> smoothed_ias;
+    SmoothedChannel smoothed_ias;
     double barber_pole_speed;
-    SmoothedValueWithDelay<double> smoothed_altimeter_readout;
+    SmoothedChannel smoothed_altimeter_readout;
 
     double alt_ft;
     double ground_alt_ft;
-    SmoothedValueWithDelay<double> smoothed_vs;
-    SmoothedValueWithDelay<double> pitch;
-    SmoothedValueWithDelay<double> bank;
+    SmoothedChannel smoothed_vs;
+    SmoothedChannel pitch;
+    SmoothedChannel bank;
 
     bool fd_active;
 
@@ -359,7 +367,7 @@ public:
     double acceleration_roll_deg_s2;
     double acceleration_yaw_deg_s2;
 
-    SmoothedValueWithDelay<double> fpv_vertical;
+    SmoothedChannel fpv_vertical;
     double fpv_vertical_previous;
 
     // environmental data
@@ -483,7 +491,7 @@ public:
     int nav1_freq;
     bool nav1_has_loc;
     uint nav1_loc_mag_heading;
-    SmoothedValueWithDelay<double> nav1_bearing;
+    SmoothedChannel nav1_bearing;
     QString nav1_distance_nm;
     int obs1;
     int obs1_to_from;
@@ -493,7 +501,7 @@ public:
     Waypoint nav2;
     int nav2_freq;
     bool nav2_has_loc;
-    SmoothedValueWithDelay<double> nav2_bearing;
+    SmoothedChannel nav2_bearing;
     QString nav2_distance_nm;
     int obs2;
     int obs2_to_from;
@@ -501,10 +509,10 @@ public:
     int obs2_gs_needle;
 
     Ndb adf1;
-    SmoothedValueWithDelay<double> adf1_bearing;
+    SmoothedChannel adf1_bearing;
 
     Ndb adf2;
-    SmoothedValueWithDelay<double> adf2_bearing;
+    SmoothedChannel adf2_bearing;
 
     bool outer_marker;
     bool middle_marker;
@@ -516,8 +524,8 @@ public:
     double ground_speed_kts;
     Waypoint current_position_raw;
 
-    SmoothedValueWithDelay<double> lat_smoothed;
-    SmoothedValueWithDelay<double> lon_smoothed;
+    SmoothedChannel lat_smoothed;
+    SmoothedChannel lon_smoothed;
     Waypoint current_position_smoothed;
 
     int avionics_status;
@@ -552,15 +560,15 @@ protected:
 
     bool m_valid;
 
-    SmoothedValueWithDelay<double> m_true_heading;
+    SmoothedChannel m_true_heading;
     TcasEntryValueList m_tcas_entry_list;
 
-    SmoothedValueWithDelay<double> m_magnetic_track;
+    SmoothedChannel m_magnetic_track;
     bool m_magnetic_track_set;
 
-    SmoothedValueWithDelay<double> m_fd_pitch;
+    SmoothedChannel m_fd_pitch;
     bool m_fd_pitch_input_from_external;
-    SmoothedValueWithDelay<double> m_fd_bank;
+    SmoothedChannel m_fd_bank;
     bool m_fd_bank_input_from_external;
     bool m_fd_was_active;
 
@@ -573,16 +581,21 @@ private:
     double m_ap_mach;
     double m_altimeter_pressure_setting_hpa;
 
-    QTime m_altimeter_pressure_setting_hpa_read_delay_timer;
-    QTime m_ap_spd_read_delay_timer;
-    QTime m_ap_mach_read_delay_timer;
-    QTime m_ap_hdg_read_delay_timer;
-    QTime m_ap_alt_read_delay_timer;
-    QTime m_ap_vs_read_delay_timer;
+    ClockTimer m_altimeter_pressure_setting_hpa_read_delay_timer;
+    ClockTimer m_ap_spd_read_delay_timer;
+    ClockTimer m_ap_mach_read_delay_timer;
+    ClockTimer m_ap_hdg_read_delay_timer;
+    ClockTimer m_ap_alt_read_delay_timer;
+    ClockTimer m_ap_vs_read_delay_timer;
 
     double m_last_flaps_percent_left;
     double m_last_flaps_percent_right;
-    QTime m_flaps_transit_timer;
+    ClockTimer m_flaps_transit_timer;
+
+    //! Hidden copy-constructor
+    FlightStatus(const FlightStatus&);
+    //! Hidden assignment operator
+    const FlightStatus& operator = (const FlightStatus&);
 };
 
 /////////////////////////////////////////////////////////////////////////////
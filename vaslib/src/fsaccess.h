@@ -185,6 +185,11 @@ public:
     virtual bool setReadFp() { return false; }
     virtual void writeFMCStatusToSim(const FMCStatusData&) {};
 
+    //! processes the data received in the background since the last call.
+    //! Called at the start of each FMC cycle, so the flightstatus does not
+    //! change while the FMC reads it.
+    virtual void processReceivedData() {};
+
 protected:
 
     //! this method shall only be called by FMCAutopilot
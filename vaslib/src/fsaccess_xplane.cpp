@@ -5,8 +5,19 @@
 #include "fsaccess_xplane.h"
 #include "fsaccess_xplane_defines.h"
 #include "fsaccess_xplane_refids.h"
+#include "fsaccess_xplane_receiver.h"
+#include "fsaccess_xplane_shm_receiver.h"
+#include "metrics.h"
 #include <queue>
 
+#include <QSocketNotifier>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
 
 void checkMessageCode(can_t received)
 {
@@ -103,30 +114,120 @@ FSAccessXPlane::FSAccessXPlane(ConfigWidgetProvider* config_widget_provider,
                                FlightStatus* flightstatus) :
 FSAccess(flightstatus),
 m_cfg(cfg_file),
+m_read_socketdevice(0),
+m_raw_read_socket(-1),
+m_raw_read_notifier(0),
+m_receiver(0),
+m_receiver_error_count(0),
+m_shm_receiver(0),
+m_writeport(0),
+m_write_socketdevice(0),
+m_was_ever_connected(false),
+m_sent_request(false),
+m_count_wait_response(0),
+m_frame_sequence_valid(false),
+m_last_frame_sequence(0),
+m_lost_frame_count(0),
+m_state_keyframe_valid(false),
+m_state_keyframe(0),
+m_state_keyframe_lat(0.0),
+m_state_keyframe_lon(0.0),
+m_state_keyframe_alt_ft(0.0),
+m_state_dropped_count(0),
 apstate(0),
-m_message_code(0)
+m_message_code(0),
+m_multicastActive(false)
 {
-    MYASSERT(config_widget_provider != 0);
+    setupConfig(config_widget_provider);
+    setupSockets();
+
+    if (!m_cfg.getValue(CFG_RECORD_FILE).isEmpty()) m_recorder.open(m_cfg.getValue(CFG_RECORD_FILE));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlane::FSAccessXPlane(ConfigWidgetProvider* config_widget_provider,
+                               const QString& cfg_file,
+                               FlightStatus* flightstatus,
+                               bool) :
+FSAccess(flightstatus),
+m_cfg(cfg_file),
+m_read_socketdevice(0),
+m_raw_read_socket(-1),
+m_raw_read_notifier(0),
+m_receiver(0),
+m_receiver_error_count(0),
+m_shm_receiver(0),
+m_writeport(0),
+m_write_socketdevice(0),
+m_was_ever_connected(false),
+m_sent_request(false),
+m_count_wait_response(0),
+m_frame_sequence_valid(false),
+m_last_frame_sequence(0),
+m_lost_frame_count(0),
+m_state_keyframe_valid(false),
+m_state_keyframe(0),
+m_state_keyframe_lat(0.0),
+m_state_keyframe_lon(0.0),
+m_state_keyframe_alt_ft(0.0),
+m_state_dropped_count(0),
+apstate(0),
+m_message_code(0),
+m_multicastActive(false)
+{
+    // sockets are not used, the derived class feeds the datagrams
+    setupConfig(config_widget_provider);
+}
+
+/////////////////////////////////////////////////////////////////////////////
 
-    m_multicastActive = false;
+void FSAccessXPlane::setupConfig(ConfigWidgetProvider* config_widget_provider)
+{
+    MYASSERT(config_widget_provider != 0);
 
     // setup config
     m_cfg.setValue(CFG_HOSTADDRESS, "239.40.41.42");
     m_cfg.setValue(CFG_PORT_FROM_SIM, 50707);
     m_cfg.setValue(CFG_PORT_TO_SIM, 63703);
+    m_cfg.setValue(CFG_RECORD_FILE, "");
+    m_cfg.setValue(CFG_BATCHED_FRAMES, 1);
+    m_cfg.setValue(CFG_RAW_SOCKET_READER, 1);
+    m_cfg.setValue(CFG_RECEIVE_THREAD, 1);
+    m_cfg.setValue(CFG_STATE_VECTORS, 1);
+    m_cfg.setValue(CFG_STATE_VECTOR_RATE, 0);
+    m_cfg.setValue(CFG_SHARED_MEMORY, 1);
     m_cfg.loadfromFile();
     m_cfg.saveToFile();
     config_widget_provider->registerConfigWidget("XPLANE Access", &m_cfg);
 
+    setupDispatchTable();
+
     //TODO    MYASSERT(connect(&m_cfg, SIGNAL(signalChanged()), this, SLOT(slotConfigChanged())));
 
+    // init read timeout
+
+    MYASSERT(connect(&m_read_timout_timer, SIGNAL(timeout()), this, SLOT(slotReadTimeout())));
+    m_read_timout_timer.start(1000);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::setupSockets()
+{
     // init the read socket
 
-    m_read_socketdevice = new QUdpSocket;
-    MYASSERT(m_read_socketdevice);
-    QHostAddress addr;
-    addr.setAddress("0.0.0.0");
-    MYASSERT(m_read_socketdevice->bind(addr,m_cfg.getIntValue(CFG_PORT_FROM_SIM), QUdpSocket::ShareAddress));
+    quint16 read_port = m_cfg.getIntValue(CFG_PORT_FROM_SIM);
+    if (!m_cfg.getIntValue(CFG_RAW_SOCKET_READER) || !setupRawReadSocket(read_port))
+    {
+        m_read_socketdevice = new QUdpSocket;
+        MYASSERT(m_read_socketdevice);
+        QHostAddress addr;
+        addr.setAddress("0.0.0.0");
+        MYASSERT(m_read_socketdevice->bind(addr, read_port, QUdpSocket::ShareAddress));
+        MYASSERT(connect(m_read_socketdevice, SIGNAL(readyRead()), this, SLOT(slotSocketRead())));
+    }
+
     uint32_t address = inet_addr ( m_cfg.getValue(CFG_HOSTADDRESS).toLatin1().constData() );
 
     // If the hostaddress given is a valid multicast group, join it.
@@ -137,7 +238,7 @@ m_message_code(0)
 //        struct ip_mreq mreq;
         m_multicastAddr.imr_multiaddr.s_addr = address;
         m_multicastAddr.imr_interface.s_addr = INADDR_ANY;
-        int r = ::setsockopt(m_read_socketdevice->socketDescriptor(), IPPROTO_IP, IP_ADD_MEMBERSHIP,
+        int r = ::setsockopt(readSocketDescriptor(), IPPROTO_IP, IP_ADD_MEMBERSHIP,
                             (const char *)&m_multicastAddr, sizeof(m_multicastAddr));
         qDebug("setsockopt returned %d", r);
         
@@ -147,7 +248,6 @@ m_message_code(0)
         }
         
     }
-    MYASSERT(connect(m_read_socketdevice, SIGNAL(readyRead()), this, SLOT(slotSocketRead())));
 
     // init the write socket
 
@@ -156,11 +256,68 @@ m_message_code(0)
 
     m_write_socketdevice = new QUdpSocket;
     MYASSERT(m_write_socketdevice);
+}
 
-    // init read timeout
+/////////////////////////////////////////////////////////////////////////////
 
-    MYASSERT(connect(&m_read_timout_timer, SIGNAL(timeout()), this, SLOT(slotReadTimeout())));
-    m_read_timout_timer.start(1000);
+bool FSAccessXPlane::setupRawReadSocket(quint16 port)
+{
+#ifdef Q_OS_LINUX
+    m_raw_read_socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_raw_read_socket < 0)
+    {
+        Logger::log(QString("FSAccessXPlane:setupRawReadSocket: could not create socket (%1)").arg(errno));
+        return false;
+    }
+
+    // the same as QUdpSocket::ShareAddress
+    int yes = 1;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (::setsockopt(m_raw_read_socket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) != 0 ||
+        ::bind(m_raw_read_socket, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        Logger::log(QString("FSAccessXPlane:setupRawReadSocket: could not bind to port %1 (%2)").
+                    arg(port).arg(errno));
+        ::close(m_raw_read_socket);
+        m_raw_read_socket = -1;
+        return false;
+    }
+
+    if (m_cfg.getIntValue(CFG_RECEIVE_THREAD))
+    {
+        m_receiver = new FSAccessXPlaneReceiver(m_raw_read_socket);
+        MYASSERT(m_receiver != 0);
+        MYASSERT(connect(m_receiver, SIGNAL(signalReceived()), this, SLOT(slotReceivedData()), Qt::QueuedConnection));
+        m_receiver->start(QThread::TimeCriticalPriority);
+        Logger::log("FSAccessXPlane:setupRawReadSocket: using receive thread");
+        return true;
+    }
+
+    m_raw_read_buffer.resize(RAW_READ_MAX_DATAGRAMS * CANAS_FRAME_MAX_BYTES);
+    m_raw_read_notifier = new QSocketNotifier(m_raw_read_socket, QSocketNotifier::Read, this);
+    MYASSERT(m_raw_read_notifier != 0);
+    MYASSERT(connect(m_raw_read_notifier, SIGNAL(activated(int)), this, SLOT(slotRawSocketRead())));
+
+    Logger::log("FSAccessXPlane:setupRawReadSocket: using recvmmsg");
+    return true;
+#else
+    Q_UNUSED(port);
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+int FSAccessXPlane::readSocketDescriptor() const
+{
+    if (m_raw_read_socket >= 0) return m_raw_read_socket;
+    if (m_read_socketdevice != 0) return m_read_socketdevice->socketDescriptor();
+    return -1;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -168,13 +325,21 @@ m_message_code(0)
 FSAccessXPlane::~FSAccessXPlane()
 {
     m_cfg.saveToFile();
+    m_recorder.close();
+    logMessageStatistics();
 
 	if ( m_multicastActive )
 	{
-        ::setsockopt(m_read_socketdevice->socketDescriptor(), IPPROTO_IP, IP_DROP_MEMBERSHIP,
+        ::setsockopt(readSocketDescriptor(), IPPROTO_IP, IP_DROP_MEMBERSHIP,
                             (const char *)&m_multicastAddr, sizeof(m_multicastAddr));
 	}
 
+    delete m_shm_receiver;
+    delete m_receiver;
+    delete m_raw_read_notifier;
+#ifdef Q_OS_LINUX
+    if (m_raw_read_socket >= 0) ::close(m_raw_read_socket);
+#endif
 
     delete m_read_socketdevice;
     delete m_write_socketdevice;
@@ -195,10 +360,7 @@ bool FSAccessXPlane::sendValue<int>(int id, int value)
     aero.data.sLong = htonl(value);
     can.msg.aero = aero;
     inc_msgCode();
-    long sent_bytes = m_write_socketdevice->writeDatagram((char*)&can, sizeof(can), m_write_hostaddress, m_writeport);
-    m_write_socketdevice->flush();
-
-    return  sent_bytes != -1;
+    return writeCan(can);
 }
 template<>
 bool FSAccessXPlane::sendValue<float>(int id, float value)
@@ -216,10 +378,7 @@ bool FSAccessXPlane::sendValue<float>(int id, float value)
     aero.data.sLong = htonl(aero.data.sLong);
     can.msg.aero = aero;
     inc_msgCode();
-    long sent_bytes = m_write_socketdevice->writeDatagram((char*)&can, sizeof(can), m_write_hostaddress, m_writeport);
-    m_write_socketdevice->flush();
-
-    return  sent_bytes != -1;
+    return writeCan(can);
 }
 template<>
 bool FSAccessXPlane::sendValue<bool>(int id, bool value)
@@ -236,10 +395,7 @@ bool FSAccessXPlane::sendValue<bool>(int id, bool value)
     aero.data.uChar[0] = value?1:0;
     can.msg.aero = aero;
     inc_msgCode();
-    long sent_bytes = m_write_socketdevice->writeDatagram((char*)&can, sizeof(can), m_write_hostaddress, m_writeport);
-    m_write_socketdevice->flush();
-
-    return  sent_bytes != -1;
+    return writeCan(can);
 }
 
 template<>
@@ -268,9 +424,7 @@ bool FSAccessXPlane::sendValue<std::vector<float> >(int id, std::vector<float> v
     while(!sendqueue.empty())
     {
         can_t item = sendqueue.front();
-        long sent_bytes = m_write_socketdevice->writeDatagram((char*)&item, sizeof(item), m_write_hostaddress, m_writeport);
-        m_write_socketdevice->flush();
-        if (sent_bytes < 0) success = false;
+        if (!writeCan(item)) success = false;
         sendqueue.pop();
     }
     return success;
@@ -278,7 +432,8 @@ bool FSAccessXPlane::sendValue<std::vector<float> >(int id, std::vector<float> v
 
 int FSAccessXPlane::sendRequest(uint8_t service_code)
 {
-    MYASSERT(service_code == IDS || service_code == STS);
+    MYASSERT(service_code == IDS || service_code == STS || service_code == BFS ||
+             service_code == SVS || service_code == SHS);
     can_t request;
     request.id = htonl(NSH_CH0_REQ);
     request.dlc = 4;
@@ -287,7 +442,36 @@ int FSAccessXPlane::sendRequest(uint8_t service_code)
     request.msg.aero.dataType = AS_NODATA;
     request.msg.aero.serviceCode = service_code;
     request.msg.aero.messageCode = 0;
-    long sent_bytes = m_write_socketdevice->writeDatagram((char*)&request, sizeof(can_t), m_write_hostaddress, m_writeport);
+    if (service_code == BFS)
+    {
+        request.dlc = 5;
+        request.msg.aero.dataType = AS_UCHAR;
+        request.msg.aero.data.uChar[0] = CANAS_FRAME_VERSION;
+    }
+    else if (service_code == SHS)
+    {
+        request.dlc = 5;
+        request.msg.aero.dataType = AS_UCHAR;
+        request.msg.aero.data.uChar[0] = CANAS_SHM_VERSION;
+    }
+    else if (service_code == SVS)
+    {
+        // the plugin limits the state vectors sent to us to the given rate per second (0 = no limit)
+        request.dlc = 8;
+        request.msg.aero.dataType = AS_UCHAR4;
+        request.msg.aero.data.uChar[0] = CANAS_STATE_VERSION;
+        request.msg.aero.data.uChar[1] = (uint8_t)qBound(0, m_cfg.getIntValue(CFG_STATE_VECTOR_RATE), 255);
+        request.msg.aero.data.uChar[2] = 0;
+        request.msg.aero.data.uChar[3] = 0;
+    }
+    return writeCan(request);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlane::writeCan(const can_t& can)
+{
+    long sent_bytes = m_write_socketdevice->writeDatagram((const char*)&can, sizeof(can_t), m_write_hostaddress, m_writeport);
     m_write_socketdevice->flush();
 
     return sent_bytes != -1;
@@ -504,390 +688,1177 @@ bool FSAccessXPlane::setReadFp() {
 
 /////////////////////////////////////////////////////////////////////////////
 
-void FSAccessXPlane::slotSocketRead()
+void FSAccessXPlane::requestIdentification()
 {
-    static bool was_ever_connected = false;
-    static bool sent_request = false;
-    static int count_wait_response = 0;
-    if (!was_ever_connected && !sent_request) {
+    if (!m_was_ever_connected && !m_sent_request) {
             sendRequest(IDS);
-            sent_request = true;
+            m_sent_request = true;
             Logger::log("Waiting for plugin to identify itself");
     }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::slotSocketRead()
+{
+    requestIdentification();
     while(m_read_socketdevice->hasPendingDatagrams())
     {
-        if (!was_ever_connected && sent_request && count_wait_response >= 2000)
+        m_read_buffer.resize(qMax((qint64)0, m_read_socketdevice->pendingDatagramSize()));
+        long read_bytes = m_read_socketdevice->readDatagram(m_read_buffer.data(), m_read_buffer.size());
+
+        if (read_bytes <= 0)
         {
-            QMessageBox::critical(0, "PLUGIN DOESN'T IDENTIFY ITSELF",
-                                  QString("X-Plane Plugin does not respond correctly. Probably you use a too old plugin. Please download plugin revision %1").arg(PLUGIN_SOFTWARE_REVISION));
-            qFatal("X-Plane Plugin does not respond correctly. Probably you use a too old plugin. Please download plugin revision %i!", PLUGIN_SOFTWARE_REVISION);
+            Logger::log(QString("FSAccessXPlane:slotSocketRead: ERROR: no data read from socket: %1").arg(read_bytes));
+            return;
         }
-        else {
-        if (!m_read_timout_timer.isActive())
+
+        if (isRingDuplicate(m_read_buffer.constData(), read_bytes)) continue;
+
+        m_recorder.record(m_read_buffer.constData(), read_bytes);
+
+        if (!processDatagram(m_read_buffer.constData(), read_bytes)) return;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::slotRawSocketRead()
+{
+#ifdef Q_OS_LINUX
+    requestIdentification();
+
+    struct mmsghdr headers[RAW_READ_MAX_DATAGRAMS];
+    struct iovec iovecs[RAW_READ_MAX_DATAGRAMS];
+    char* buffer = m_raw_read_buffer.data();
+
+    for(int call = 0; call < RAW_READ_MAX_CALLS; ++call)
+    {
+        memset(headers, 0, sizeof(headers));
+        for(int index = 0; index < RAW_READ_MAX_DATAGRAMS; ++index)
         {
-            Logger::log("FSAccessXPlane:slotSocketRead: got data");
-            // ask X-Plane plugin to transmit all its can messages
-            sendRequest(STS);
+            iovecs[index].iov_base = buffer + index * CANAS_FRAME_MAX_BYTES;
+            iovecs[index].iov_len = CANAS_FRAME_MAX_BYTES;
+            headers[index].msg_hdr.msg_iov = &iovecs[index];
+            headers[index].msg_hdr.msg_iovlen = 1;
         }
-        m_read_timout_timer.start(1000);
 
-        QByteArray buffer;
-        buffer.resize(m_read_socketdevice->pendingDatagramSize());
-        can_t canmsg;
-        long read_bytes = m_read_socketdevice->readDatagram((char*)&canmsg, buffer.size());
-        if (!(buffer.size() == sizeof(can_t)))
+        int received = ::recvmmsg(m_raw_read_socket, headers, RAW_READ_MAX_DATAGRAMS, MSG_DONTWAIT, 0);
+        if (received < 0)
         {
-            Logger::log("Wrong buffer size. Network problems or incompatible plugin ?");
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                Logger::log(QString("FSAccessXPlane:slotRawSocketRead: ERROR: recvmmsg failed: %1").arg(errno));
             return;
         }
 
-        if (read_bytes <= 0)
+        for(int index = 0; index < received; ++index)
         {
-            Logger::log(QString("FSAccessXPlane:slotSocketRead: ERROR: no data read from socket: %1").arg(read_bytes));
+            const char* data = buffer + index * CANAS_FRAME_MAX_BYTES;
+            uint size = headers[index].msg_len;
+            if (isRingDuplicate(data, size)) continue;
+            m_recorder.record(data, size);
+            // the datagrams are already taken from the socket, a bad one
+            // must not drop the rest of the batch
+            if (!processDatagram(data, size))
+                Logger::log(QString("FSAccessXPlane:slotRawSocketRead: skipped datagram %1 of %2 (%3 bytes)").
+                            arg(index+1).arg(received).arg(size));
+        }
+
+        if (received < RAW_READ_MAX_DATAGRAMS) return;
+    }
+
+    // the notifier fires again for the datagrams left in the socket
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::slotReceivedData()
+{
+    processReceivedData();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::processReceivedData()
+{
+    if (m_receiver != 0 && m_receiver->errorCount() != m_receiver_error_count)
+    {
+        m_receiver_error_count = m_receiver->errorCount();
+        Logger::log(QString("FSAccessXPlane:processReceivedData: ERROR: receive failed (%1 times), last error %2").
+                    arg(m_receiver_error_count).arg(m_receiver->lastError()));
+    }
+
+    if (m_receiver != 0)
+    {
+        processReceiver(m_receiver);
+        MetricsRegistry::registry()->setGauge("FS.RX.OVERFLOWS", m_receiver->overflowCount());
+        MetricsRegistry::registry()->setGauge("FS.RX.ERRORS", m_receiver_error_count);
+    }
+
+    if (m_shm_receiver != 0) processReceiver(m_shm_receiver);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::processReceiver(FSAccessXPlaneReceiver* receiver)
+{
+    MYASSERT(receiver != 0);
+
+    int count = receiver->available();
+    if (count <= 0) return;
+
+    MetricsScope metrics_scope("FS.RX");
+
+    requestIdentification();
+
+    bool from_udp = (receiver == m_receiver);
+    uint size = 0;
+    for(int index = 0; index < count; ++index)
+    {
+        const char* data = receiver->datagram(index, size);
+        if (from_udp && isRingDuplicate(data, size)) continue;
+        m_recorder.record(data, size);
+        if (!processDatagram(data, size))
+        {
+            // the remaining datagrams are processed with the next call
+            receiver->release(index+1);
+            MetricsRegistry::registry()->incCounter("FS.RX.DATAGRAMS", index+1);
             return;
         }
+    }
 
-        uint32_t id = ntohl(canmsg.id);
+    receiver->release(count);
+    MetricsRegistry::registry()->incCounter("FS.RX.DATAGRAMS", count);
+}
 
-        static bool ap_spd_is_mach = false;
-        static float true_alt_ft = 0;
-        static float kias_maximum_operating, mach_maximum_operating, speed_of_sound;
-        bool b;
-        float f;
-        double d;
-        int i;
-        static float flapNotches[10]={0,0,0,0,0,0,0,0,0,0};
+/////////////////////////////////////////////////////////////////////////////
 
-        static QString ndb1Id, ndb2Id, vor1Id, vor2Id;
-        static float adf1_bearing, adf2_bearing, nav1_dme, nav2_dme, ndb1Lat, ndb1Lon, ndb2Lat, ndb2Lon, vor1Lat, vor1Lon, vor2Lat, vor2Lon;
-        static int adf1_freq, adf2_freq, nav1_flg, nav2_flg, vor1LocCrs, vor2LocCrs;
-        static bool n1hasDME, n2hasDME, vor1hasLOC, vor2hasLOC;
-        static bool isInOverride = false;
-        static int year = QDate::currentDate().year();
+bool FSAccessXPlane::isRingDuplicate(const char* data, uint size) const
+{
+    if (m_shm_receiver == 0 || !m_shm_receiver->isRingActive()) return false;
+
+    // the node services only go over UDP
+    if (size != sizeof(can_t)) return true;
+    can_t canmsg;
+    memcpy(&canmsg, data, sizeof(can_t));
+    uint32_t id = ntohl(canmsg.id);
+    return id != NSH_CH0_REQ && id != NSH_CH0_RES;
+}
 
+/////////////////////////////////////////////////////////////////////////////
 
-            if(id == RSRVD) break;
-            if(id == NSH_CH0_RES) {
-                uint8_t plugin_hardware_revision = getUCharFromCan(canmsg, 0);
-                uint8_t plugin_software_revision = getUCharFromCan(canmsg, 1);
-                uint8_t plugin_identifier_distribution = getUCharFromCan(canmsg, 2);
-                uint8_t plugin_header_type = getUCharFromCan(canmsg, 3);
-                if (plugin_hardware_revision == PLUGIN_HARDWARE_REVISION &&
-                    plugin_software_revision == PLUGIN_SOFTWARE_REVISION &&
-                    plugin_identifier_distribution == DISTRIBUTION_FP &&
-                    plugin_header_type == HEADER_TYPE_CANAS)
-                {
-                    was_ever_connected = true;
-                    sendRequest(STS);
-                    Logger::log("Plugin version is compatible, vasFMC is connected to X-Plane now");
-                } else
-                {
-                    QMessageBox::critical(0, "PLUGIN INCOMPATIBLE",
-                                          QString("X-Plane Plugin is incompatible to this version of vasFMC. Please download plugin revision %1").arg(PLUGIN_SOFTWARE_REVISION));
-                    qFatal("X-Plane Plugin is incompatible to this version of vasFMC. Please download plugin revision %i!", PLUGIN_SOFTWARE_REVISION);
-                }
-                continue;
-            } else if (!was_ever_connected && sent_request)
-            {
-                count_wait_response++;
-                continue;
-            }
-            switch(id)
-            {
-            case NSH_CH0_REQ: // Node service request, look if we are affected
-                if (canmsg.msg.aero.nodeId == 0 || canmsg.msg.aero.nodeId == VASFMC_NODE_ID)
-                {
-                    switch (canmsg.msg.aero.serviceCode)
-                    {
-                    case STS: // handle STS by sending some keep-alive packet
-                            // TODO: state vasfmcs messages
-                        Logger::log("STS request from X-Plane plugin");
-                        sendValue(RSRVD,(int)0);
-                    break;
-                    default: Logger::log(QString("Service request with service code %1 could not be handled").arg(canmsg.msg.aero.serviceCode));
-                    }
-                }
-                break;
-            case PITCHOVRDPOS: f = getFloatFromCan(canmsg); //m_flightstatus->elevator_percent = f;
-                break;
-            case ROLLOVRDPOS: f = getFloatFromCan(canmsg); //m_flightstatus->aileron_percent = f;
-                break;
-            case PITCHINPUT: f = getFloatFromCan(canmsg); //m_flightstatus->elevator_input_percent = f;
-                break;
-            case ROLLINPUT: f = getFloatFromCan(canmsg); //m_flightstatus->aileron_input_percent = f;
-                break;
-            case ROLLOVRD: b = getBoolFromCan(canmsg); break;
-            case PITCHOVRD: b = getBoolFromCan(canmsg); break;
-            case FLAPS: f = getFloatFromCan(canmsg);
-                m_flightstatus->flaps_percent_left = hardDetentsPercent(f,7);
-                m_flightstatus->flaps_percent_right = hardDetentsPercent(f,7);
-                break;
-            case FLAPRQST: f = getFloatFromCan(canmsg);
-                if (m_flightstatus->flaps_lever_notch_count >0)
-                    m_flightstatus->current_flap_lever_notch = Navcalc::round(f/m_flaps_inc_per_notch);
-                break;
-            case FLAPDET : i = getIntFromCan(canmsg); m_flightstatus->flaps_lever_notch_count = i+1; m_flaps_inc_per_notch = 100 / i; break;
-            case FLAPDETPOS:
-                if (getIndexFromCan(canmsg) < m_flightstatus->flaps_lever_notch_count)
-                    flapNotches[getIndexFromCan(canmsg)] = getFloatFromCan(canmsg);
-                if (m_flightstatus->current_flap_lever_notch < m_flightstatus->flaps_lever_notch_count)
-                    m_flightstatus->flaps_degrees = flapNotches[m_flightstatus->current_flap_lever_notch];
-                break;
-            case SPDBRK: f = getFloatFromCan(canmsg);
-                if (f>=0) m_flightstatus->spoiler_lever_percent = f*100;
-                m_flightstatus->spoilers_armed = (f==-0.5f);
-                break;
-            case THROVRDPOS: f = getFloatFromCan(canmsg); break;
-            case THROVRD: b = getBoolFromCan(canmsg); isInOverride=b; break;
-                //TODO handle m_separate_throttle_lever_mode
-            case THRAXIS: f = getFloatFromCan(canmsg); m_flightstatus->setAllThrottleLeversInputPercent(f);break;
-            case ZTIME: f = getFloatFromCan(canmsg); m_flightstatus->fs_utc_time = QTime().addSecs(int(floor(f))); break;
-            case ZDATE: i = getIntFromCan(canmsg); m_flightstatus->fs_utc_date = QDate(year,1,1).addDays(i); break;
-            case V_S0: f = getFloatFromCan(canmsg); m_flightstatus->speed_vs0_kts = uint(floor(f)); break;
-            case V_S: f = getFloatFromCan(canmsg); m_flightstatus->speed_vs1_kts = uint(floor(f));
-                // green dot speed = 1.35 * stall speed in clean config
-                m_flightstatus->speed_min_drag_kts = uint(floor(f*1.35));
-                break;
+void FSAccessXPlane::setupSharedMemory()
+{
+    // a replay must not read a running simulator
+    if (m_write_socketdevice == 0) return;
 
-            case SOS: f = getFloatFromCan(canmsg); speed_of_sound = f;
-                m_flightstatus->barber_pole_speed = barberpole(kias_maximum_operating, mach_maximum_operating, speed_of_sound);
-                break;
-            case M_MO: f = getFloatFromCan(canmsg); mach_maximum_operating = f; break;
-            case V_NO: f = getFloatFromCan(canmsg); kias_maximum_operating = f; break;
-            case V_FE: f = getFloatFromCan(canmsg); break;
-            case QNH: f = getFloatFromCan(canmsg); m_flightstatus->qnh = f; break;
-            case OAT: f = getFloatFromCan(canmsg); m_flightstatus->oat = f; break;
-            case DEW: f = getFloatFromCan(canmsg); m_flightstatus->dew = f; break;
-            case TAT: f = getFloatFromCan(canmsg); m_flightstatus->tat = f; break;
-            case ALTSET:f = getFloatFromCan(canmsg); m_flightstatus->setAltPressureSettingHpaExternal(f); break;
-            case NAV1:i = getIntFromCan(canmsg); m_flightstatus->nav1_freq=i; break;
-            case NAV2:i = getIntFromCan(canmsg); m_flightstatus->nav2_freq=i; break;
-            case ADF1:i = getIntFromCan(canmsg); adf1_freq = i; break;
-            case ADF2:i = getIntFromCan(canmsg); adf2_freq = i; break;
-            case ADF1BRG: f = getFloatFromCan(canmsg); adf1_bearing =f; break;
-            case ADF2BRG: f = getFloatFromCan(canmsg); adf2_bearing =f; break;
-            case VOR1HDEF:f = getFloatFromCan(canmsg); m_flightstatus->obs1_loc_needle = Navcalc::round(f); break;
-            case VOR2HDEF:f = getFloatFromCan(canmsg); m_flightstatus->obs2_loc_needle = Navcalc::round(f); break;
-            case ILS1VDEF:f = getFloatFromCan(canmsg); m_flightstatus->obs1_gs_needle = Navcalc::round(f);  break;
-            case OBS1:f = getFloatFromCan(canmsg); m_flightstatus->obs1 = Navcalc::round(Navcalc::trimHeading(f));break;
-            case OBS2:f = getFloatFromCan(canmsg); m_flightstatus->obs2 = Navcalc::round(Navcalc::trimHeading(f));break;
-            case N1DME:f = getFloatFromCan(canmsg); nav1_dme=f; break;
-            case N2DME:f = getFloatFromCan(canmsg); nav2_dme=f; break;
-            case THDG:f = getFloatFromCan(canmsg); m_flightstatus->setTrueHeading(f); break;
-            case LAT: d = getDoubleFromCan(canmsg); m_flightstatus->lat=d; break;
-            case LON: d = getDoubleFromCan(canmsg); m_flightstatus->lon=d; break;
-            case YAGL:f = getFloatFromCan(canmsg); m_flightstatus->ground_alt_ft=true_alt_ft-f; break;
-            case IAS: f = getFloatFromCan(canmsg); m_flightstatus->smoothed_ias = qMax(30.0, (double)f); break;
-            case MACH:f = getFloatFromCan(canmsg); m_flightstatus->mach = f; break;
-            case VS:  f = getFloatFromCan(canmsg); m_flightstatus->smoothed_vs = f; break;
-            case PITCH: f = getFloatFromCan(canmsg); m_flightstatus->pitch = f; break;
-            case BANK: f = getFloatFromCan(canmsg); m_flightstatus->bank = f; break;
-            case TALT: d = getDoubleFromCan(canmsg); true_alt_ft=d; m_flightstatus->alt_ft = d; break;
-            case INDALT:f = getFloatFromCan(canmsg); m_flightstatus->smoothed_altimeter_readout = f; break;
-            case GS: f = getFloatFromCan(canmsg); m_flightstatus->ground_speed_kts=f; break;
-            case TAS: f = getFloatFromCan(canmsg); m_flightstatus->tas=f; break;
-            case APALT: f = getFloatFromCan(canmsg); m_flightstatus->setAPAltExternal(Navcalc::round(f+0.5));break;
-            case APHDG: f = getFloatFromCan(canmsg); m_flightstatus->setAPHdgExternal(Navcalc::round(Navcalc::trimHeading(f)));break;
-            case APSPD: f = getFloatFromCan(canmsg); ap_spd_is_mach ? m_flightstatus->setAPMachExternal(f): m_flightstatus->setAPSpdExternal(Navcalc::round(f));break;
-            case APVS:  f = getFloatFromCan(canmsg); m_flightstatus->setAPVsExternal(Navcalc::round(f)); break;
-            case EFIS1SELCPT:  i = getIntFromCan(canmsg); break;
-            case EFIS2SELCPT:  i = getIntFromCan(canmsg); break;
-
-            case APMODE:i = getIntFromCan(canmsg); break ;
-            case APSTATE: i = getIntFromCan(canmsg);
-                apstate = i;
-                //printf("=============\n");
-                m_flightstatus->ap_available = (i&1); //if (i&1) printf("AP avail\n");
-                //m_flightstatus->ap_enabled = (i&2);
-                m_flightstatus->ap_hdg_lock = (i&4); //if (i&4) printf("AP HDG\n");
-                m_flightstatus->ap_alt_lock = (i&8); //if (i&8) printf("AP ALT (FS)\n");
-                m_flightstatus->ap_speed_lock = (i&16); //if (i&16) printf("AP SPEED\n");
-                m_flightstatus->ap_mach_lock = (i&32); //if (i&32) printf("AP MACH\n");
-                m_flightstatus->ap_vs_lock = (i&64); //if (i&64) printf("AP VS\n");
-                m_flightstatus->ap_nav1_lock = (i&128); //if (i&128) printf("AP NAV1\n");
-                m_flightstatus->ap_gs_lock = (i&256); //if (i&256) printf("AP GS\n");
-                m_flightstatus->ap_app_lock = (i&512); //if (i&512) printf("AP APP\n");
-                m_flightstatus->ap_app_bc_lock = (i&1024); //if (i&1024) printf("AP APP_BC\n");
-                m_flightstatus->at_toga = (i&2048); //if (i&2048) printf("AT TOGA\n");
-                m_flightstatus->at_arm = (i&4096); //if (i&4096) printf("AT ARM\n");
-                m_flightstatus->gps_enabled = (i&8192); //if (i&8192) printf("GPS MODE CPL\n");
-                break;
-            case FDON:  i = getIntFromCan(canmsg); m_flightstatus->fd_active = (i!=0); m_flightstatus->ap_enabled=(i==2);break;
-            case FDROLL: f = getFloatFromCan(canmsg); m_flightstatus->setFlightDirectorBankInputFromExternal(true); m_flightstatus->setFlightDirectorBankExternal(-f); break;
-            case FDPITCH: f = getFloatFromCan(canmsg); m_flightstatus->setFlightDirectorPitchInputFromExternal(true); m_flightstatus->setFlightDirectorPitchExternal(-f);break;
-            case APSPDMACH: b = getBoolFromCan(canmsg); ap_spd_is_mach = b; break;
-            case WINDSPEED: f = getFloatFromCan(canmsg);m_flightstatus->wind_speed_kts = f; break;
-            case WINDDIR: f = getFloatFromCan(canmsg);m_flightstatus->wind_dir_deg_true = f; break;
-            case MAGVAR: f = getFloatFromCan(canmsg); m_flightstatus->magvar = f; if (m_flightstatus->magvar > 180.0) m_flightstatus->magvar -= 360; break;
-            case TOTWT:  f = getFloatFromCan(canmsg); m_flightstatus->total_weight_kg = uint(floor(f)); break;
-            case FUELCAP: f = getFloatFromCan(canmsg); m_flightstatus->total_fuel_capacity_kg = f; break;
-            case FUELWT: f = getFloatFromCan(canmsg); m_flightstatus->zero_fuel_weight_kg = m_flightstatus->total_weight_kg - uint(floor(f)); break;
-            case AVIONICS: b = getBoolFromCan(canmsg); m_flightstatus->avionics_on = b; break;
-            case BATTERY: b = getBoolFromCan(canmsg); m_flightstatus->battery_on = b; break;
-            case ONGROUND: b = getBoolFromCan(canmsg); m_flightstatus->onground = b; break;
-            case BEACON: b = getBoolFromCan(canmsg); m_flightstatus->lights_beacon = b; break;
-            case STROBE: b = getBoolFromCan(canmsg); m_flightstatus->lights_strobe = b; break;
-            case LDGLT:  b = getBoolFromCan(canmsg); m_flightstatus->lights_landing = b; break;
-            case NAVLT:  b = getBoolFromCan(canmsg); m_flightstatus->lights_navigation = b; break;
-            case TAXILT: b = getBoolFromCan(canmsg); m_flightstatus->lights_taxi = b; break;
-            case PITOTHT: b = getBoolFromCan(canmsg); m_flightstatus->pitot_heat_on = b; break;
-            case PAUSE:  b = getBoolFromCan(canmsg); m_flightstatus->paused = b; break;
-            case PRKBRK: f = getFloatFromCan(canmsg); m_flightstatus->parking_brake_set = (f>0.9); break;
-            case NOENGINES: i = getIntFromCan(canmsg);m_flightstatus->nr_of_engines=i; break;
-            case ENGTHRO:
-                //TODO handle m_separate_throttle_lever_mode
-                f = getFloatFromCan(canmsg);
-                if (getIndexFromCan(canmsg) == 1)
-                    m_flightstatus->setAllThrottleLeversInputPercent(f);
-                if (getIndexFromCan(canmsg) < m_flightstatus->nr_of_engines)
-                        m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].throttle_lever_percent = f;
-                break;
-            case ENGN2:
-                    if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
-                        m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].n2_percent = getFloatFromCan(canmsg);
-                break;
-            case ENGN1:
-                if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
-                    m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].smoothed_n1 = getFloatFromCan(canmsg);
-                break;
-            case ENGEGT:
-                if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
-                    m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].egt_degrees = getFloatFromCan(canmsg);;
-                break;
-            case ENGFF:
-                if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
-                        m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].ff_kg_per_hour = getFloatFromCan(canmsg);;
-                break;
-            case GEAR:
-                switch(getIndexFromCan(canmsg))
-                    {
-                            case 0: m_flightstatus->gear_nose_position_percent=hardDetentsPercent(getFloatFromCan(canmsg),10); break;
-                            case 1: m_flightstatus->gear_left_position_percent=hardDetentsPercent(getFloatFromCan(canmsg),10); break;
-                            case 2: m_flightstatus->gear_right_position_percent=hardDetentsPercent(getFloatFromCan(canmsg),10); break;
-                            default : break;
-                    }
-                break;
-            case TAI:
-                if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
-                    m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].anti_ice_on = (getFloatFromCan(canmsg)==1);
-                break;
-            case ENGREV:
-                if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
-                        m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].reverser_percent = hardDetentsPercent(getFloatFromCan(canmsg),10);
-                break;
-            case N1FROMTO: nav1_flg = getIntFromCan(canmsg); break;
-            case N2FROMTO: nav2_flg = getIntFromCan(canmsg); break;
-            case N1HASDME: n1hasDME = getBoolFromCan(canmsg); break;
-            case N2HASDME: n2hasDME = getBoolFromCan(canmsg); break;
-            case NDB1TND:
-                if (getBoolFromCan(canmsg))
-                {
-                    m_flightstatus->adf1 = Ndb(ndb1Id,QString(""),ndb1Lat,ndb1Lon,adf1_freq,50,0,QString(""));
-                    m_flightstatus->adf1_bearing = adf1_bearing;
-                } else
-                {
-                    m_flightstatus->adf1 = Ndb(QString::null, QString::null, 0.0, 0.0, adf1_freq, 0, 0, QString::null);
-                    m_flightstatus->adf1_bearing.clear();
-                }
-                break;
-            case NDB1ID: ndb1Id = getQStringFomCan(canmsg); break;
-            case NDB1LAT: ndb1Lat = getFloatFromCan(canmsg); break;
-            case NDB1LON: ndb1Lon = getFloatFromCan(canmsg); break;
-            case NDB2TND:
-                if (getBoolFromCan(canmsg))
-                {
-                    m_flightstatus->adf2 = Ndb(ndb2Id,QString(""),ndb2Lat,ndb2Lon,adf2_freq,50,0,QString(""));
-                    m_flightstatus->adf2_bearing = adf2_bearing;
-                } else
-                {
-                    m_flightstatus->adf2 = Ndb(QString::null, QString::null, 0.0, 0.0, adf2_freq, 0, 0, QString::null);
-                    m_flightstatus->adf2_bearing.clear();
-                }
-                break;
-            case NDB2ID: ndb2Id = getQStringFomCan(canmsg); break;
-            case NDB2LAT: ndb2Lat = getFloatFromCan(canmsg); break;
-            case NDB2LON: ndb2Lon = getFloatFromCan(canmsg); break;
-            case VOR1TND:
-                if (getBoolFromCan(canmsg))
-                {
-                    m_flightstatus->nav1.setId(vor1Id);
-                    m_flightstatus->nav1.setLat(vor1Lat);
-                    m_flightstatus->nav1.setLon(vor1Lon);
-                    if (vor1hasLOC)
-                    {
-                        m_flightstatus->nav1_has_loc = true;
-                        m_flightstatus->nav1_loc_mag_heading =(int)Navcalc::trimHeading(vor1LocCrs);
-                    }
-                    else
-                    {
-                        m_flightstatus->nav1_has_loc=false;
-                        m_flightstatus->nav1_loc_mag_heading = 0;
-                    }
-                    if(n1hasDME)
-                        m_flightstatus->nav1_distance_nm = QString("%1").arg(nav1_dme,0,'f',1);
-                    else
-                        m_flightstatus->nav1_distance_nm = QString::null;
-                    m_flightstatus->nav1_bearing = Navcalc::getSignedHeadingDiff(Navcalc::trimHeading(m_flightstatus->smoothedTrueHeading()), Navcalc::getTrackBetweenWaypoints(m_flightstatus->current_position_smoothed, m_flightstatus->nav1));
-                    m_flightstatus->obs1_to_from = nav1_flg;
-                }
-                else
-                {
-                    m_flightstatus->nav1 = Waypoint();
-                    m_flightstatus->nav1_has_loc = false;
-                    m_flightstatus->nav1_distance_nm = QString::null;
-                    m_flightstatus->nav1_bearing.clear();
-                }
-            break;
-            case VOR1ID: vor1Id = getQStringFomCan(canmsg); break;
-            case VOR1LAT: vor1Lat = getFloatFromCan(canmsg); break;
-            case VOR1LON: vor1Lon = getFloatFromCan(canmsg); break;
-            case VOR1LOC: vor1hasLOC = getBoolFromCan(canmsg); break;
-            case VOR1LOCCRS: vor1LocCrs = getIntFromCan(canmsg); break;
-            case VOR2TND:
-                if (getBoolFromCan(canmsg))
-                {
-                    m_flightstatus->nav2.setId(vor2Id);
-                    m_flightstatus->nav2.setLat(vor2Lat);
-                    m_flightstatus->nav2.setLon(vor2Lon);
-                    if (vor2hasLOC)
-                    {
-                        m_flightstatus->nav2_has_loc = true;
-                        //m_flightstatus->nav2_loc_mag_heading =(int)Navcalc::trimHeading(vor2LocCrs);
-                    }
-                    else
-                    {
-                        m_flightstatus->nav2_has_loc=false;
-                        //m_flightstatus->nav2_loc_mag_heading = 0;
-                    }
-                    if(n2hasDME)
-                        m_flightstatus->nav2_distance_nm = QString("%2").arg(nav2_dme,0,'f',1);
-                    else
-                        m_flightstatus->nav2_distance_nm = QString::null;
-                    m_flightstatus->nav2_bearing = Navcalc::getSignedHeadingDiff(Navcalc::trimHeading(m_flightstatus->smoothedTrueHeading()), Navcalc::getTrackBetweenWaypoints(m_flightstatus->current_position_smoothed, m_flightstatus->nav2));
-                    m_flightstatus->obs2_to_from = nav2_flg;
-                }
-                else
-                {
-                    m_flightstatus->nav2 = Waypoint();
-                    m_flightstatus->nav2_has_loc = false;
-                    m_flightstatus->nav2_distance_nm = QString::null;
-                    m_flightstatus->nav2_bearing.clear();
-                }
-            break;
-            case VOR2ID: vor2Id = getQStringFomCan(canmsg); break;
-            case VOR2LAT: vor2Lat = getFloatFromCan(canmsg); break;
-            case VOR2LON: vor2Lon = getFloatFromCan(canmsg); break;
-            case VOR2LOC: vor2hasLOC = getBoolFromCan(canmsg); break;
-            case VOR2LOCCRS: vor2LocCrs = getIntFromCan(canmsg); break;
-            case TOTALNUM: Logger::log(QString("Total count in this block %1").arg(getIntFromCan(canmsg))); break;
-
-            default: Logger::log(QString("FSAccessXPlane:slotSocketRead: ERROR: Got unrecognized ID of: %1").arg(id));
-            } // end of switch
-        // set data to valid
-        m_flightstatus->recalcAndSetValid();
-        m_read_timout_timer.start(READ_TIMEOUT_PERIOD_MS);
-    } // end of else (ever connected)
-    } // end of while
+    // a restarted plugin creates a new ring
+    if (m_shm_receiver != 0 && !m_shm_receiver->isWriterAlive())
+    {
+        delete m_shm_receiver;
+        m_shm_receiver = 0;
+    }
+
+    if (m_shm_receiver == 0)
+    {
+        m_shm_receiver = new FSAccessXPlaneShmReceiver;
+        MYASSERT(m_shm_receiver != 0);
+        if (!m_shm_receiver->attach())
+        {
+            delete m_shm_receiver;
+            m_shm_receiver = 0;
+            Logger::log("FSAccessXPlane:setupSharedMemory: no shared memory of the plugin on this host "
+                        "or read by an other vasFMC, using UDP");
+            return;
+        }
+
+        MYASSERT(connect(m_shm_receiver, SIGNAL(signalReceived()), this, SLOT(slotReceivedData()), Qt::QueuedConnection));
+        m_shm_receiver->start(QThread::TimeCriticalPriority);
+        Logger::log("FSAccessXPlane:setupSharedMemory: using shared memory");
+    }
+
+    // plugins without shared memory support ignore the request, the data keeps coming over UDP
+    sendRequest(SHS);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlane::processDatagram(const char* data, uint size)
+{
+    if (!m_was_ever_connected && m_sent_request && m_count_wait_response >= 2000)
+    {
+        QMessageBox::critical(0, "PLUGIN DOESN'T IDENTIFY ITSELF",
+                              QString("X-Plane Plugin does not respond correctly. Probably you use a too old plugin. Please download plugin revision %1").arg(PLUGIN_SOFTWARE_REVISION));
+        qFatal("X-Plane Plugin does not respond correctly. Probably you use a too old plugin. Please download plugin revision %i!", PLUGIN_SOFTWARE_REVISION);
+    }
+
+    if (!m_read_timout_timer.isActive())
+    {
+        Logger::log("FSAccessXPlane:processDatagram: got data");
+        // ask X-Plane plugin to transmit all its can messages
+        sendRequest(STS);
+    }
+    m_read_timout_timer.start(1000);
+
+    can_t canmsg;
+
+    if (size == sizeof(can_t))
+    {
+        memcpy(&canmsg, data, sizeof(can_t));
+        return processMessage(canmsg);
+    }
+
+    // state vector
+
+    if (size >= sizeof(canAS_state_header_t))
+    {
+        uint32_t magic;
+        memcpy(&magic, data, sizeof(magic));
+        if (ntohl(magic) == CANAS_STATE_MAGIC) return processStateVector(data, size);
+    }
+
+    // batched frame
+
+    canAS_frame_header_t header;
+    uint count = 0;
+    if (size >= sizeof(header))
+    {
+        memcpy(&header, data, sizeof(header));
+        count = ntohs(header.count);
+    }
+
+    if (size < sizeof(header) || ntohl(header.magic) != CANAS_FRAME_MAGIC ||
+        size != sizeof(header) + count * sizeof(can_t))
+    {
+        Logger::log("Wrong buffer size. Network problems or incompatible plugin ?");
+        return false;
+    }
+
+    uint16_t sequence = ntohs(header.sequence);
+    if (m_frame_sequence_valid && sequence != (uint16_t)(m_last_frame_sequence + 1))
+    {
+        uint lost = (uint16_t)(sequence - m_last_frame_sequence - 1);
+        m_lost_frame_count += lost;
+        Logger::log(QString("FSAccessXPlane:processDatagram: lost %1 frames (%2 total)").
+                    arg(lost).arg(m_lost_frame_count));
+    }
+    m_last_frame_sequence = sequence;
+    m_frame_sequence_valid = true;
+
+    const char* record = data + sizeof(header);
+    for(uint index = 0; index < count; ++index, record += sizeof(can_t))
+    {
+        memcpy(&canmsg, record, sizeof(can_t));
+        if (!processMessage(canmsg)) return false;
+    }
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! joins the two 32 bit words in network byte order (high word first) to a double
+static double getDoubleFromWords(const uint32_t* words)
+{
+    uint64_t bits = ((uint64_t)ntohl(words[0]) << 32) | ntohl(words[1]);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlane::processStateVector(const char* data, uint size)
+{
+    canAS_state_header_t header;
+    memcpy(&header, data, sizeof(header));
+
+    if (header.type == CANAS_STATE_KEYFRAME && size == sizeof(canAS_state_keyframe_t))
+    {
+        canAS_state_keyframe_t keyframe;
+        memcpy(&keyframe, data, sizeof(keyframe));
+
+        m_state_keyframe_valid = true;
+        m_state_keyframe = keyframe.header.keyframe;
+        m_state_keyframe_lat = getDoubleFromWords(keyframe.lat);
+        m_state_keyframe_lon = getDoubleFromWords(keyframe.lon);
+        m_state_keyframe_alt_ft = getDoubleFromWords(keyframe.alt);
+
+        setStateVector(m_state_keyframe_lat, m_state_keyframe_lon, m_state_keyframe_alt_ft, keyframe.attitude);
+        return true;
+    }
+
+    if (header.type == CANAS_STATE_DELTA && size == sizeof(canAS_state_delta_t))
+    {
+        // deltas to a keyframe we did not get are useless, wait for the next keyframe
+        if (!m_state_keyframe_valid || header.keyframe != m_state_keyframe)
+        {
+            ++m_state_dropped_count;
+            return true;
+        }
+
+        canAS_state_delta_t delta;
+        memcpy(&delta, data, sizeof(delta));
+
+        double lon = m_state_keyframe_lon + (int32_t)ntohl(delta.lon) * CANAS_STATE_LATLON_QUANTUM;
+        if (lon > 180.0) lon -= 360.0;
+        else if (lon < -180.0) lon += 360.0;
+
+        setStateVector(m_state_keyframe_lat + (int32_t)ntohl(delta.lat) * CANAS_STATE_LATLON_QUANTUM,
+                       lon,
+                       m_state_keyframe_alt_ft + (int32_t)ntohl(delta.alt) * CANAS_STATE_ALT_QUANTUM,
+                       delta.attitude);
+        return true;
+    }
+
+    Logger::log("Wrong state vector. Network problems or incompatible plugin ?");
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::setStateVector(double lat, double lon, double alt_ft, const canAS_state_attitude_t& attitude)
+{
+    m_flightstatus->lat = lat;
+    m_flightstatus->lon = lon;
+    m_received.true_alt_ft = alt_ft;
+    m_flightstatus->alt_ft = alt_ft;
+    m_flightstatus->setTrueHeading(ntohs(attitude.heading) * CANAS_STATE_ANGLE_QUANTUM);
+    m_flightstatus->pitch = (int16_t)ntohs(attitude.pitch) * CANAS_STATE_ANGLE_QUANTUM;
+    m_flightstatus->bank = (int16_t)ntohs(attitude.bank) * CANAS_STATE_ANGLE_QUANTUM;
+
+    m_flightstatus->recalcAndSetValid();
+    m_read_timout_timer.start(READ_TIMEOUT_PERIOD_MS);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlane::ReceivedValues::ReceivedValues() :
+    ap_spd_is_mach(false), true_alt_ft(0.0), kias_maximum_operating(0.0), mach_maximum_operating(0.0),
+    speed_of_sound(0.0), throttle_override(false), year(QDate::currentDate().year()),
+    adf1_freq(0), adf2_freq(0), adf1_bearing(0.0), adf2_bearing(0.0),
+    ndb1_lat(0.0), ndb1_lon(0.0), ndb2_lat(0.0), ndb2_lon(0.0),
+    nav1_dme(0.0), nav2_dme(0.0), nav1_flag(0), nav2_flag(0), nav1_has_dme(false), nav2_has_dme(false),
+    vor1_lat(0.0), vor1_lon(0.0), vor2_lat(0.0), vor2_lon(0.0),
+    vor1_has_loc(false), vor2_has_loc(false), vor1_loc_course(0), vor2_loc_course(0)
+{
+    for(int index = 0; index < FLAP_NOTCH_COUNT; ++index) flap_notches[index] = 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlane::CanDispatchEntry::CanDispatchEntry() :
+    kind(UNHANDLED), type(AS_NODATA), scale(1.0), index(0), handler(0),
+    fs_double(0), fs_smoothed(0), fs_bool(0), fs_int(0), fs_uint(0), engine_double(0),
+    own_float(0), own_int(0), own_bool(0), own_string(0),
+    message_count(0), window_count(0), rate(0.0)
+{}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::setupDispatchTable()
+{
+    m_dispatch.clear();
+    m_dispatch.resize(READFP+1);
+
+    addHandler(NSH_CH0_REQ, &FSAccessXPlane::handleNodeServiceRequest);
+
+    // received but not used (yet)
+    addIgnored(PITCHOVRDPOS, AS_FLOAT);
+    addIgnored(ROLLOVRDPOS, AS_FLOAT);
+    addIgnored(PITCHINPUT, AS_FLOAT);
+    addIgnored(ROLLINPUT, AS_FLOAT);
+    addIgnored(ROLLOVRD, AS_UCHAR);
+    addIgnored(PITCHOVRD, AS_UCHAR);
+    addIgnored(THROVRDPOS, AS_FLOAT);
+    addIgnored(V_FE, AS_FLOAT);
+    addIgnored(EFIS1SELCPT, AS_LONG);
+    addIgnored(EFIS2SELCPT, AS_LONG);
+    addIgnored(APMODE, AS_LONG);
+
+    // flightstatus values
+    addField(QNH, AS_FLOAT, &FlightStatus::qnh);
+    addField(OAT, AS_FLOAT, &FlightStatus::oat);
+    addField(DEW, AS_FLOAT, &FlightStatus::dew);
+    addField(TAT, AS_FLOAT, &FlightStatus::tat);
+    addField(LAT, AS_FLOAT, &FlightStatus::lat);
+    addField(LON, AS_FLOAT, &FlightStatus::lon);
+    addField(MACH, AS_FLOAT, &FlightStatus::mach);
+    addField(GS, AS_FLOAT, &FlightStatus::ground_speed_kts);
+    addField(TAS, AS_FLOAT, &FlightStatus::tas);
+    addField(WINDSPEED, AS_FLOAT, &FlightStatus::wind_speed_kts);
+    addField(WINDDIR, AS_FLOAT, &FlightStatus::wind_dir_deg_true);
+    addField(FUELCAP, AS_FLOAT, &FlightStatus::total_fuel_capacity_kg);
+    addField(VS, AS_FLOAT, &FlightStatus::smoothed_vs);
+    addField(INDALT, AS_FLOAT, &FlightStatus::smoothed_altimeter_readout);
+    addField(PITCH, AS_FLOAT, &FlightStatus::pitch);
+    addField(BANK, AS_FLOAT, &FlightStatus::bank);
+    addField(NAV1, AS_LONG, &FlightStatus::nav1_freq);
+    addField(NAV2, AS_LONG, &FlightStatus::nav2_freq);
+    addField(VOR1HDEF, AS_FLOAT, &FlightStatus::obs1_loc_needle);
+    addField(VOR2HDEF, AS_FLOAT, &FlightStatus::obs2_loc_needle);
+    addField(ILS1VDEF, AS_FLOAT, &FlightStatus::obs1_gs_needle);
+    addField(V_S0, AS_FLOAT, &FlightStatus::speed_vs0_kts);
+    addField(TOTWT, AS_FLOAT, &FlightStatus::total_weight_kg);
+    addField(AVIONICS, AS_UCHAR, &FlightStatus::avionics_on);
+    addField(BATTERY, AS_UCHAR, &FlightStatus::battery_on);
+    addField(ONGROUND, AS_UCHAR, &FlightStatus::onground);
+    addField(BEACON, AS_UCHAR, &FlightStatus::lights_beacon);
+    addField(STROBE, AS_UCHAR, &FlightStatus::lights_strobe);
+    addField(LDGLT, AS_UCHAR, &FlightStatus::lights_landing);
+    addField(NAVLT, AS_UCHAR, &FlightStatus::lights_navigation);
+    addField(TAXILT, AS_UCHAR, &FlightStatus::lights_taxi);
+    addField(PITOTHT, AS_UCHAR, &FlightStatus::pitot_heat_on);
+    addField(PAUSE, AS_UCHAR, &FlightStatus::paused);
+
+    // per engine values, the index of the message is the engine index
+    addField(ENGN2, AS_FLOAT, &EngineData::n2_percent);
+    addField(ENGEGT, AS_FLOAT, &EngineData::egt_degrees);
+    addField(ENGFF, AS_FLOAT, &EngineData::ff_kg_per_hour);
+
+    // values combined with other values later on
+    addField(APSPDMACH, AS_UCHAR, &ReceivedValues::ap_spd_is_mach);
+    addField(M_MO, AS_FLOAT, &ReceivedValues::mach_maximum_operating);
+    addField(V_NO, AS_FLOAT, &ReceivedValues::kias_maximum_operating);
+    addField(THROVRD, AS_UCHAR, &ReceivedValues::throttle_override);
+    addField(ADF1, AS_LONG, &ReceivedValues::adf1_freq);
+    addField(ADF2, AS_LONG, &ReceivedValues::adf2_freq);
+    addField(ADF1BRG, AS_FLOAT, &ReceivedValues::adf1_bearing);
+    addField(ADF2BRG, AS_FLOAT, &ReceivedValues::adf2_bearing);
+    addField(N1DME, AS_FLOAT, &ReceivedValues::nav1_dme);
+    addField(N2DME, AS_FLOAT, &ReceivedValues::nav2_dme);
+    addField(N1FROMTO, AS_LONG, &ReceivedValues::nav1_flag);
+    addField(N2FROMTO, AS_LONG, &ReceivedValues::nav2_flag);
+    addField(N1HASDME, AS_UCHAR, &ReceivedValues::nav1_has_dme);
+    addField(N2HASDME, AS_UCHAR, &ReceivedValues::nav2_has_dme);
+    addField(NDB1ID, FP_ACHAR5, &ReceivedValues::ndb1_id);
+    addField(NDB1LAT, AS_FLOAT, &ReceivedValues::ndb1_lat);
+    addField(NDB1LON, AS_FLOAT, &ReceivedValues::ndb1_lon);
+    addField(NDB2ID, FP_ACHAR5, &ReceivedValues::ndb2_id);
+    addField(NDB2LAT, AS_FLOAT, &ReceivedValues::ndb2_lat);
+    addField(NDB2LON, AS_FLOAT, &ReceivedValues::ndb2_lon);
+    addField(VOR1ID, FP_ACHAR5, &ReceivedValues::vor1_id);
+    addField(VOR1LAT, AS_FLOAT, &ReceivedValues::vor1_lat);
+    addField(VOR1LON, AS_FLOAT, &ReceivedValues::vor1_lon);
+    addField(VOR1LOC, AS_UCHAR, &ReceivedValues::vor1_has_loc);
+    addField(VOR1LOCCRS, AS_LONG, &ReceivedValues::vor1_loc_course);
+    addField(VOR2ID, FP_ACHAR5, &ReceivedValues::vor2_id);
+    addField(VOR2LAT, AS_FLOAT, &ReceivedValues::vor2_lat);
+    addField(VOR2LON, AS_FLOAT, &ReceivedValues::vor2_lon);
+    addField(VOR2LOC, AS_UCHAR, &ReceivedValues::vor2_has_loc);
+    addField(VOR2LOCCRS, AS_LONG, &ReceivedValues::vor2_loc_course);
+
+    // values with conversions or side effects
+    addHandler(FLAPS, &FSAccessXPlane::handleFlaps);
+    addHandler(FLAPRQST, &FSAccessXPlane::handleFlapRequest);
+    addHandler(FLAPDET, &FSAccessXPlane::handleFlapDetents);
+    addHandler(FLAPDETPOS, &FSAccessXPlane::handleFlapDetentPosition);
+    addHandler(SPDBRK, &FSAccessXPlane::handleSpeedBrake);
+    addHandler(THRAXIS, &FSAccessXPlane::handleThrottleAxis);
+    addHandler(ZTIME, &FSAccessXPlane::handleZuluTime);
+    addHandler(ZDATE, &FSAccessXPlane::handleZuluDate);
+    addHandler(V_S, &FSAccessXPlane::handleStallSpeed);
+    addHandler(SOS, &FSAccessXPlane::handleSpeedOfSound);
+    addHandler(ALTSET, &FSAccessXPlane::handleAltimeterSetting);
+    addHandler(OBS1, &FSAccessXPlane::handleObs, 1);
+    addHandler(OBS2, &FSAccessXPlane::handleObs, 2);
+    addHandler(THDG, &FSAccessXPlane::handleTrueHeading);
+    addHandler(YAGL, &FSAccessXPlane::handleHeightAboveGround);
+    addHandler(IAS, &FSAccessXPlane::handleIas);
+    addHandler(TALT, &FSAccessXPlane::handleTrueAltitude);
+    addHandler(APALT, &FSAccessXPlane::handleAPAltitude);
+    addHandler(APHDG, &FSAccessXPlane::handleAPHeading);
+    addHandler(APSPD, &FSAccessXPlane::handleAPSpeed);
+    addHandler(APVS, &FSAccessXPlane::handleAPVs);
+    addHandler(APSTATE, &FSAccessXPlane::handleAPState);
+    addHandler(FDON, &FSAccessXPlane::handleFDOn);
+    addHandler(FDROLL, &FSAccessXPlane::handleFDRoll);
+    addHandler(FDPITCH, &FSAccessXPlane::handleFDPitch);
+    addHandler(MAGVAR, &FSAccessXPlane::handleMagvar);
+    addHandler(FUELWT, &FSAccessXPlane::handleFuelWeight);
+    addHandler(PRKBRK, &FSAccessXPlane::handleParkingBrake);
+    addHandler(NOENGINES, &FSAccessXPlane::handleNumberOfEngines);
+    addHandler(ENGTHRO, &FSAccessXPlane::handleEngineThrottle);
+    addHandler(ENGN1, &FSAccessXPlane::handleEngineN1);
+    addHandler(ENGREV, &FSAccessXPlane::handleEngineReverser);
+    addHandler(TAI, &FSAccessXPlane::handleEngineAntiIce);
+    addHandler(GEAR, &FSAccessXPlane::handleGear);
+    addHandler(NDB1TND, &FSAccessXPlane::handleNdbTuned, 1);
+    addHandler(NDB2TND, &FSAccessXPlane::handleNdbTuned, 2);
+    addHandler(VOR1TND, &FSAccessXPlane::handleVorTuned, 1);
+    addHandler(VOR2TND, &FSAccessXPlane::handleVorTuned, 2);
+    addHandler(TOTALNUM, &FSAccessXPlane::handleTotalNum);
+
+    m_rate_window_timer.start();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlane::CanDispatchEntry& FSAccessXPlane::addEntry(uint id, CanDispatchEntry::Kind kind, uint8_t type)
+{
+    MYASSERT(id < (uint)m_dispatch.count());
+    MYASSERT(m_dispatch[id].kind == CanDispatchEntry::UNHANDLED);
+    CanDispatchEntry& entry = m_dispatch[id];
+    entry.kind = kind;
+    entry.type = type;
+    return entry;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::addIgnored(uint id, uint8_t type)
+{
+    addEntry(id, CanDispatchEntry::IGNORED, type);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::addHandler(uint id, CanHandler handler, int index)
+{
+    CanDispatchEntry& entry = addEntry(id, CanDispatchEntry::HANDLER, AS_NODATA);
+    entry.handler = handler;
+    entry.index = index;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::addField(uint id, uint8_t type, double FlightStatus::* field, double scale)
+{
+    CanDispatchEntry& entry = addEntry(id, CanDispatchEntry::FS_DOUBLE, type);
+    entry.fs_double = field;
+    entry.scale = scale;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, SmoothedChannel FlightStatus::* field, double scale)
+{
+    CanDispatchEntry& entry = addEntry(id, CanDispatchEntry::FS_SMOOTHED, type);
+    entry.fs_smoothed = field;
+    entry.scale = scale;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, bool FlightStatus::* field)
+{
+    addEntry(id, CanDispatchEntry::FS_BOOL, type).fs_bool = field;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, int FlightStatus::* field, double scale)
+{
+    CanDispatchEntry& entry = addEntry(id, CanDispatchEntry::FS_INT, type);
+    entry.fs_int = field;
+    entry.scale = scale;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, uint FlightStatus::* field, double scale)
+{
+    CanDispatchEntry& entry = addEntry(id, CanDispatchEntry::FS_UINT, type);
+    entry.fs_uint = field;
+    entry.scale = scale;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, double EngineData::* field, double scale)
+{
+    CanDispatchEntry& entry = addEntry(id, CanDispatchEntry::ENGINE_DOUBLE, type);
+    entry.engine_double = field;
+    entry.scale = scale;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, float ReceivedValues::* field)
+{
+    addEntry(id, CanDispatchEntry::OWN_FLOAT, type).own_float = field;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, int ReceivedValues::* field)
+{
+    addEntry(id, CanDispatchEntry::OWN_INT, type).own_int = field;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, bool ReceivedValues::* field)
+{
+    addEntry(id, CanDispatchEntry::OWN_BOOL, type).own_bool = field;
+}
+
+void FSAccessXPlane::addField(uint id, uint8_t type, QString ReceivedValues::* field)
+{
+    addEntry(id, CanDispatchEntry::OWN_STRING, type).own_string = field;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+double FSAccessXPlane::decodeValue(const can_t& can, uint8_t type)
+{
+    switch(type)
+    {
+        case(AS_FLOAT): return getFloatFromCan(can);
+        case(AS_LONG): return getIntFromCan(can);
+        case(AS_UCHAR): return getBoolFromCan(can) ? 1.0 : 0.0;
+    }
+
+    MYASSERT(false);
+    return 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::countMessage(CanDispatchEntry& entry)
+{
+    ++entry.message_count;
+    ++entry.window_count;
+
+    int elapsed_ms = m_rate_window_timer.elapsed();
+    if (elapsed_ms < RATE_WINDOW_MS) return;
+
+    for(int id = 0; id < m_dispatch.count(); ++id)
+    {
+        CanDispatchEntry& counted = m_dispatch[id];
+        counted.rate = counted.window_count * 1000.0 / elapsed_ms;
+        counted.window_count = 0;
+    }
+    m_rate_window_timer.start();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+double FSAccessXPlane::messageRate(uint id) const
+{
+    if (id >= (uint)m_dispatch.count()) return 0.0;
+    return m_dispatch[id].rate;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+uint FSAccessXPlane::messageCount(uint id) const
+{
+    if (id >= (uint)m_dispatch.count()) return 0;
+    return m_dispatch[id].message_count;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::logMessageStatistics() const
+{
+    QString text;
+    for(int id = 0; id < m_dispatch.count(); ++id)
+    {
+        const CanDispatchEntry& entry = m_dispatch[id];
+        if (entry.message_count == 0) continue;
+        text += QString(" %1:%2(%3/s)").arg(id).arg(entry.message_count).arg(entry.rate, 0, 'f', 1);
+    }
+
+    if (!text.isEmpty()) Logger::log("FSAccessXPlane: messages per id:" + text);
+    if (m_state_dropped_count > 0)
+        Logger::log(QString("FSAccessXPlane: %1 state vector deltas dropped without keyframe").arg(m_state_dropped_count));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlane::processMessage(const can_t& canmsg)
+{
+        uint32_t id = ntohl(canmsg.id);
+
+            if(id == RSRVD) return false;
+            if(id == NSH_CH0_RES) {
+                uint8_t plugin_hardware_revision = getUCharFromCan(canmsg, 0);
+                uint8_t plugin_software_revision = getUCharFromCan(canmsg, 1);
+                uint8_t plugin_identifier_distribution = getUCharFromCan(canmsg, 2);
+                uint8_t plugin_header_type = getUCharFromCan(canmsg, 3);
+                if (plugin_hardware_revision == PLUGIN_HARDWARE_REVISION &&
+                    plugin_software_revision == PLUGIN_SOFTWARE_REVISION &&
+                    plugin_identifier_distribution == DISTRIBUTION_FP &&
+                    plugin_header_type == HEADER_TYPE_CANAS)
+                {
+                    m_was_ever_connected = true;
+                    // ask for batched frames, plugins without frame support ignore the request
+                    if (m_cfg.getIntValue(CFG_BATCHED_FRAMES) != 0) sendRequest(BFS);
+                    // same for state vectors of position and attitude
+                    m_state_keyframe_valid = false;
+                    if (m_cfg.getIntValue(CFG_STATE_VECTORS) != 0) sendRequest(SVS);
+                    if (m_cfg.getIntValue(CFG_SHARED_MEMORY) != 0) setupSharedMemory();
+                    sendRequest(STS);
+                    Logger::log("Plugin version is compatible, vasFMC is connected to X-Plane now");
+                } else
+                {
+                    QMessageBox::critical(0, "PLUGIN INCOMPATIBLE",
+                                          QString("X-Plane Plugin is incompatible to this version of vasFMC. Please download plugin revision %1").arg(PLUGIN_SOFTWARE_REVISION));
+                    qFatal("X-Plane Plugin is incompatible to this version of vasFMC. Please download plugin revision %i!", PLUGIN_SOFTWARE_REVISION);
+                }
+                return true;
+            } else if (!m_was_ever_connected && m_sent_request)
+            {
+                m_count_wait_response++;
+                return true;
+            }
+
+        if (id < (uint)m_dispatch.count() && m_dispatch[id].kind != CanDispatchEntry::UNHANDLED)
+        {
+            CanDispatchEntry& entry = m_dispatch[id];
+            countMessage(entry);
+
+            switch(entry.kind)
+            {
+                case(CanDispatchEntry::IGNORED):
+                    decodeValue(canmsg, entry.type);
+                    break;
+                case(CanDispatchEntry::HANDLER):
+                    (this->*entry.handler)(canmsg, entry);
+                    break;
+                case(CanDispatchEntry::FS_DOUBLE):
+                    m_flightstatus->*entry.fs_double = decodeValue(canmsg, entry.type) * entry.scale;
+                    break;
+                case(CanDispatchEntry::FS_SMOOTHED):
+                    m_flightstatus->*entry.fs_smoothed = decodeValue(canmsg, entry.type) * entry.scale;
+                    break;
+                case(CanDispatchEntry::FS_BOOL):
+                    m_flightstatus->*entry.fs_bool = (decodeValue(canmsg, entry.type) != 0.0);
+                    break;
+                case(CanDispatchEntry::FS_INT):
+                    m_flightstatus->*entry.fs_int = Navcalc::round(decodeValue(canmsg, entry.type) * entry.scale);
+                    break;
+                case(CanDispatchEntry::FS_UINT):
+                    m_flightstatus->*entry.fs_uint = uint(floor(decodeValue(canmsg, entry.type) * entry.scale));
+                    break;
+                case(CanDispatchEntry::ENGINE_DOUBLE): {
+                    double value = decodeValue(canmsg, entry.type) * entry.scale;
+                    if (getIndexFromCan(canmsg) < m_flightstatus->nr_of_engines)
+                        m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].*entry.engine_double = value;
+                    break;
+                }
+                case(CanDispatchEntry::OWN_FLOAT):
+                    m_received.*entry.own_float = decodeValue(canmsg, entry.type);
+                    break;
+                case(CanDispatchEntry::OWN_INT):
+                    m_received.*entry.own_int = (int)decodeValue(canmsg, entry.type);
+                    break;
+                case(CanDispatchEntry::OWN_BOOL):
+                    m_received.*entry.own_bool = (decodeValue(canmsg, entry.type) != 0.0);
+                    break;
+                case(CanDispatchEntry::OWN_STRING):
+                    m_received.*entry.own_string = getQStringFomCan(canmsg);
+                    break;
+                case(CanDispatchEntry::UNHANDLED):
+                    break;
+            }
+        }
+        else
+        {
+            Logger::log(QString("FSAccessXPlane:processMessage: ERROR: Got unrecognized ID of: %1").arg(id));
+        }
+
+        // set data to valid
+        m_flightstatus->recalcAndSetValid();
+        m_read_timout_timer.start(READ_TIMEOUT_PERIOD_MS);
+        return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleNodeServiceRequest(const can_t& canmsg, const CanDispatchEntry&)
+{
+    // Node service request, look if we are affected
+    if (canmsg.msg.aero.nodeId == 0 || canmsg.msg.aero.nodeId == VASFMC_NODE_ID)
+    {
+        switch (canmsg.msg.aero.serviceCode)
+        {
+            case STS: // handle STS by sending some keep-alive packet
+                // TODO: state vasfmcs messages
+                Logger::log("STS request from X-Plane plugin");
+                sendValue(RSRVD,(int)0);
+                break;
+            default: Logger::log(QString("Service request with service code %1 could not be handled").arg(canmsg.msg.aero.serviceCode));
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleFlaps(const can_t& canmsg, const CanDispatchEntry&)
+{
+    float f = getFloatFromCan(canmsg);
+    m_flightstatus->flaps_percent_left = hardDetentsPercent(f,7);
+    m_flightstatus->flaps_percent_right = hardDetentsPercent(f,7);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleFlapRequest(const can_t& canmsg, const CanDispatchEntry&)
+{
+    float f = getFloatFromCan(canmsg);
+    if (m_flightstatus->flaps_lever_notch_count >0)
+        m_flightstatus->current_flap_lever_notch = Navcalc::round(f/m_flaps_inc_per_notch);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleFlapDetents(const can_t& canmsg, const CanDispatchEntry&)
+{
+    int i = getIntFromCan(canmsg);
+    m_flightstatus->flaps_lever_notch_count = i+1;
+    m_flaps_inc_per_notch = 100 / i;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleFlapDetentPosition(const can_t& canmsg, const CanDispatchEntry&)
+{
+    if (getIndexFromCan(canmsg) < m_flightstatus->flaps_lever_notch_count &&
+        getIndexFromCan(canmsg) < ReceivedValues::FLAP_NOTCH_COUNT)
+        m_received.flap_notches[getIndexFromCan(canmsg)] = getFloatFromCan(canmsg);
+    if (m_flightstatus->current_flap_lever_notch < m_flightstatus->flaps_lever_notch_count &&
+        m_flightstatus->current_flap_lever_notch < (uint)ReceivedValues::FLAP_NOTCH_COUNT)
+        m_flightstatus->flaps_degrees = m_received.flap_notches[m_flightstatus->current_flap_lever_notch];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleSpeedBrake(const can_t& canmsg, const CanDispatchEntry&)
+{
+    float f = getFloatFromCan(canmsg);
+    if (f>=0) m_flightstatus->spoiler_lever_percent = f*100;
+    m_flightstatus->spoilers_armed = (f==-0.5f);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleThrottleAxis(const can_t& canmsg, const CanDispatchEntry&)
+{
+    //TODO handle m_separate_throttle_lever_mode
+    m_flightstatus->setAllThrottleLeversInputPercent(getFloatFromCan(canmsg));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleZuluTime(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->fs_utc_time = QTime().addSecs(int(floor(getFloatFromCan(canmsg))));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleZuluDate(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->fs_utc_date = QDate(m_received.year,1,1).addDays(getIntFromCan(canmsg));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleStallSpeed(const can_t& canmsg, const CanDispatchEntry&)
+{
+    float f = getFloatFromCan(canmsg);
+    m_flightstatus->speed_vs1_kts = uint(floor(f));
+    // green dot speed = 1.35 * stall speed in clean config
+    m_flightstatus->speed_min_drag_kts = uint(floor(f*1.35));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleSpeedOfSound(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_received.speed_of_sound = getFloatFromCan(canmsg);
+    m_flightstatus->barber_pole_speed = barberpole(m_received.kias_maximum_operating,
+                                                   m_received.mach_maximum_operating,
+                                                   m_received.speed_of_sound);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleAltimeterSetting(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->setAltPressureSettingHpaExternal(getFloatFromCan(canmsg));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleObs(const can_t& canmsg, const CanDispatchEntry& entry)
+{
+    int obs = Navcalc::round(Navcalc::trimHeading(getFloatFromCan(canmsg)));
+    if (entry.index == 1) m_flightstatus->obs1 = obs;
+    else                  m_flightstatus->obs2 = obs;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleTrueHeading(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->setTrueHeading(getFloatFromCan(canmsg));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleHeightAboveGround(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->ground_alt_ft = m_received.true_alt_ft - getFloatFromCan(canmsg);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleIas(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->smoothed_ias = qMax(30.0, (double)getFloatFromCan(canmsg));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleTrueAltitude(const can_t& canmsg, const CanDispatchEntry&)
+{
+    double d = getDoubleFromCan(canmsg);
+    m_received.true_alt_ft = d;
+    m_flightstatus->alt_ft = d;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleAPAltitude(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->setAPAltExternal(Navcalc::round(getFloatFromCan(canmsg)+0.5));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleAPHeading(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->setAPHdgExternal(Navcalc::round(Navcalc::trimHeading(getFloatFromCan(canmsg))));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleAPSpeed(const can_t& canmsg, const CanDispatchEntry&)
+{
+    float f = getFloatFromCan(canmsg);
+    if (m_received.ap_spd_is_mach) m_flightstatus->setAPMachExternal(f);
+    else                           m_flightstatus->setAPSpdExternal(Navcalc::round(f));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleAPVs(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->setAPVsExternal(Navcalc::round(getFloatFromCan(canmsg)));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleAPState(const can_t& canmsg, const CanDispatchEntry&)
+{
+    int i = getIntFromCan(canmsg);
+    apstate = i;
+    m_flightstatus->ap_available = (i&1);
+    //m_flightstatus->ap_enabled = (i&2);
+    m_flightstatus->ap_hdg_lock = (i&4);
+    m_flightstatus->ap_alt_lock = (i&8);
+    m_flightstatus->ap_speed_lock = (i&16);
+    m_flightstatus->ap_mach_lock = (i&32);
+    m_flightstatus->ap_vs_lock = (i&64);
+    m_flightstatus->ap_nav1_lock = (i&128);
+    m_flightstatus->ap_gs_lock = (i&256);
+    m_flightstatus->ap_app_lock = (i&512);
+    m_flightstatus->ap_app_bc_lock = (i&1024);
+    m_flightstatus->at_toga = (i&2048);
+    m_flightstatus->at_arm = (i&4096);
+    m_flightstatus->gps_enabled = (i&8192);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleFDOn(const can_t& canmsg, const CanDispatchEntry&)
+{
+    int i = getIntFromCan(canmsg);
+    m_flightstatus->fd_active = (i!=0);
+    m_flightstatus->ap_enabled=(i==2);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleFDRoll(const can_t& canmsg, const CanDispatchEntry&)
+{
+    float f = getFloatFromCan(canmsg);
+    m_flightstatus->setFlightDirectorBankInputFromExternal(true);
+    m_flightstatus->setFlightDirectorBankExternal(-f);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleFDPitch(const can_t& canmsg, const CanDispatchEntry&)
+{
+    float f = getFloatFromCan(canmsg);
+    m_flightstatus->setFlightDirectorPitchInputFromExternal(true);
+    m_flightstatus->setFlightDirectorPitchExternal(-f);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleMagvar(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->magvar = getFloatFromCan(canmsg);
+    if (m_flightstatus->magvar > 180.0) m_flightstatus->magvar -= 360;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleFuelWeight(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->zero_fuel_weight_kg = m_flightstatus->total_weight_kg - uint(floor(getFloatFromCan(canmsg)));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleParkingBrake(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->parking_brake_set = (getFloatFromCan(canmsg)>0.9);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleNumberOfEngines(const can_t& canmsg, const CanDispatchEntry&)
+{
+    m_flightstatus->nr_of_engines = getIntFromCan(canmsg);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleEngineThrottle(const can_t& canmsg, const CanDispatchEntry&)
+{
+    //TODO handle m_separate_throttle_lever_mode
+    float f = getFloatFromCan(canmsg);
+    if (getIndexFromCan(canmsg) == 1)
+        m_flightstatus->setAllThrottleLeversInputPercent(f);
+    if (getIndexFromCan(canmsg) < m_flightstatus->nr_of_engines)
+        m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].throttle_lever_percent = f;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleEngineN1(const can_t& canmsg, const CanDispatchEntry&)
+{
+    if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
+        m_flightstatus->setN1(getIndexFromCan(canmsg) + 1, getFloatFromCan(canmsg));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleEngineReverser(const can_t& canmsg, const CanDispatchEntry&)
+{
+    if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
+        m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].reverser_percent =
+            hardDetentsPercent(getFloatFromCan(canmsg),10);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleEngineAntiIce(const can_t& canmsg, const CanDispatchEntry&)
+{
+    if(getIndexFromCan(canmsg)<m_flightstatus->nr_of_engines)
+        m_flightstatus->engine_data[getIndexFromCan(canmsg) + 1].anti_ice_on = (getFloatFromCan(canmsg)==1);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleGear(const can_t& canmsg, const CanDispatchEntry&)
+{
+    switch(getIndexFromCan(canmsg))
+    {
+        case 0: m_flightstatus->gear_nose_position_percent=hardDetentsPercent(getFloatFromCan(canmsg),10); break;
+        case 1: m_flightstatus->gear_left_position_percent=hardDetentsPercent(getFloatFromCan(canmsg),10); break;
+        case 2: m_flightstatus->gear_right_position_percent=hardDetentsPercent(getFloatFromCan(canmsg),10); break;
+        default : break;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleNdbTuned(const can_t& canmsg, const CanDispatchEntry& entry)
+{
+    bool first = (entry.index == 1);
+    Ndb& adf = first ? m_flightstatus->adf1 : m_flightstatus->adf2;
+    SmoothedChannel& adf_bearing = first ? m_flightstatus->adf1_bearing : m_flightstatus->adf2_bearing;
+    int freq = first ? m_received.adf1_freq : m_received.adf2_freq;
+
+    if (getBoolFromCan(canmsg))
+    {
+        if (first) adf = Ndb(m_received.ndb1_id,QString(""),m_received.ndb1_lat,m_received.ndb1_lon,freq,50,0,QString(""));
+        else       adf = Ndb(m_received.ndb2_id,QString(""),m_received.ndb2_lat,m_received.ndb2_lon,freq,50,0,QString(""));
+        adf_bearing = first ? m_received.adf1_bearing : m_received.adf2_bearing;
+    } else
+    {
+        adf = Ndb(QString::null, QString::null, 0.0, 0.0, freq, 0, 0, QString::null);
+        adf_bearing.clear();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleVorTuned(const can_t& canmsg, const CanDispatchEntry& entry)
+{
+    if (entry.index == 1)
+    {
+        if (getBoolFromCan(canmsg))
+        {
+            m_flightstatus->nav1.setId(m_received.vor1_id);
+            m_flightstatus->nav1.setLat(m_received.vor1_lat);
+            m_flightstatus->nav1.setLon(m_received.vor1_lon);
+            if (m_received.vor1_has_loc)
+            {
+                m_flightstatus->nav1_has_loc = true;
+                m_flightstatus->nav1_loc_mag_heading =(int)Navcalc::trimHeading(m_received.vor1_loc_course);
+            }
+            else
+            {
+                m_flightstatus->nav1_has_loc=false;
+                m_flightstatus->nav1_loc_mag_heading = 0;
+            }
+            if(m_received.nav1_has_dme)
+                m_flightstatus->nav1_distance_nm = QString("%1").arg(m_received.nav1_dme,0,'f',1);
+            else
+                m_flightstatus->nav1_distance_nm = QString::null;
+            m_flightstatus->nav1_bearing = Navcalc::getSignedHeadingDiff(Navcalc::trimHeading(m_flightstatus->smoothedTrueHeading()), Navcalc::getTrackBetweenWaypoints(m_flightstatus->current_position_smoothed, m_flightstatus->nav1));
+            m_flightstatus->obs1_to_from = m_received.nav1_flag;
+        }
+        else
+        {
+            m_flightstatus->nav1 = Waypoint();
+            m_flightstatus->nav1_has_loc = false;
+            m_flightstatus->nav1_distance_nm = QString::null;
+            m_flightstatus->nav1_bearing.clear();
+        }
+    }
+    else
+    {
+        if (getBoolFromCan(canmsg))
+        {
+            m_flightstatus->nav2.setId(m_received.vor2_id);
+            m_flightstatus->nav2.setLat(m_received.vor2_lat);
+            m_flightstatus->nav2.setLon(m_received.vor2_lon);
+            if (m_received.vor2_has_loc)
+            {
+                m_flightstatus->nav2_has_loc = true;
+                //m_flightstatus->nav2_loc_mag_heading =(int)Navcalc::trimHeading(m_received.vor2_loc_course);
+            }
+            else
+            {
+                m_flightstatus->nav2_has_loc=false;
+                //m_flightstatus->nav2_loc_mag_heading = 0;
+            }
+            if(m_received.nav2_has_dme)
+                m_flightstatus->nav2_distance_nm = QString("%2").arg(m_received.nav2_dme,0,'f',1);
+            else
+                m_flightstatus->nav2_distance_nm = QString::null;
+            m_flightstatus->nav2_bearing = Navcalc::getSignedHeadingDiff(Navcalc::trimHeading(m_flightstatus->smoothedTrueHeading()), Navcalc::getTrackBetweenWaypoints(m_flightstatus->current_position_smoothed, m_flightstatus->nav2));
+            m_flightstatus->obs2_to_from = m_received.nav2_flag;
+        }
+        else
+        {
+            m_flightstatus->nav2 = Waypoint();
+            m_flightstatus->nav2_has_loc = false;
+            m_flightstatus->nav2_distance_nm = QString::null;
+            m_flightstatus->nav2_bearing.clear();
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlane::handleTotalNum(const can_t& canmsg, const CanDispatchEntry&)
+{
+    Logger::log(QString("Total count in this block %1").arg(getIntFromCan(canmsg)));
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -5,8 +5,11 @@
 #ifndef XPLANE_FSACCESS_H
 #define XPLANE_FSACCESS_H
 
+#include <QVector>
+
 #include "fsaccess.h"
 #include "canas.h"
+#include "datagram_recorder.h"
 
 #ifdef Q_OS_WIN32
 #include <windows.h>
@@ -18,6 +21,9 @@
 #include <arpa/inet.h>
 #endif
 
+class QSocketNotifier;
+class FSAccessXPlaneReceiver;
+class FSAccessXPlaneShmReceiver;
 
 //! X-Plane Flightsim Access
 class FSAccessXPlane : public FSAccess
@@ -80,12 +86,79 @@ public:
     virtual bool setAltimeterHpa(const double& hpa);
     virtual bool setReadFp();
 
+    //! processes the datagrams received by the receive thread
+    virtual void processReceivedData();
+
+    //! returns the messages per second of the given refid (measured over
+    //! the last RATE_WINDOW_MS)
+    double messageRate(uint id) const;
+    //! returns the number of received messages of the given refid
+    uint messageCount(uint id) const;
+    //! logs the number of messages and the message rate of each refid
+    void logMessageStatistics() const;
+
 protected slots:
 
     void slotSocketRead();
 
+    //! reads all pending datagrams from the raw read socket with few
+    //! recvmmsg calls (linux only)
+    void slotRawSocketRead();
+
+    //! called when the receive thread got new datagrams
+    void slotReceivedData();
+
     void slotReadTimeout();
 
+protected:
+
+    //! Constructor for derived classes which feed the datagrams on their
+    //! own (e.g. from a recording), no sockets will be opened.
+    FSAccessXPlane(ConfigWidgetProvider* config_widget_provider,
+                   const QString& cfg_file, FlightStatus* flightstatus, bool no_sockets);
+
+    void setupConfig(ConfigWidgetProvider* config_widget_provider);
+    void setupSockets();
+
+    //! opens a plain socket bound to the given port, which is read with
+    //! recvmmsg instead of one readDatagram call per datagram, either on read
+    //! notifications or by the receive thread. Returns false when not
+    //! supported or on errors, the QUdpSocket is used then.
+    bool setupRawReadSocket(quint16 port);
+
+    //! returns the descriptor of the socket the datagrams are read from
+    int readSocketDescriptor() const;
+
+    //! asks the plugin to identify itself before the first data is processed
+    void requestIdentification();
+
+    //! maps the shared memory ring of a plugin on this host and asks the
+    //! plugin to write into it, UDP is used when there is none.
+    void setupSharedMemory();
+
+    //! processes the datagrams of the given receive thread
+    void processReceiver(FSAccessXPlaneReceiver* receiver);
+
+    //! returns true for a datagram received over UDP which the plugin also
+    //! wrote into the shared memory ring we read.
+    bool isRingDuplicate(const char* data, uint size) const;
+
+    //! processes a single datagram received from the plugin, returns false
+    //! when the following datagrams shall not be processed.
+    bool processDatagram(const char* data, uint size);
+
+    //! decodes a single CAN message into the flightstatus, see m_dispatch
+    bool processMessage(const can_t& canmsg);
+
+    //! decodes a state vector (see canAS_state_header_t) into the flightstatus
+    bool processStateVector(const char* data, uint size);
+
+    //! sets the position and attitude of a state vector to the flightstatus
+    void setStateVector(double lat, double lon, double alt_ft, const canAS_state_attitude_t& attitude);
+
+    //! sends the given CAN message to the plugin
+    virtual bool writeCan(const can_t& can);
+
 protected:
 
     //! XPlane fsaccess configuration
@@ -94,13 +167,187 @@ protected:
     QHostAddress m_read_hostaddress;
     QUdpSocket* m_read_socketdevice;
     QTimer m_read_timout_timer;
+    QByteArray m_read_buffer;
+
+    //! raw read socket and its notifier, -1/0 when the QUdpSocket is used
+    int m_raw_read_socket;
+    QSocketNotifier* m_raw_read_notifier;
+    //! reads the raw read socket instead of the notifier when configured
+    FSAccessXPlaneReceiver* m_receiver;
+    uint m_receiver_error_count;
+    //! reads the shared memory ring of a plugin on this host, 0 when not used
+    FSAccessXPlaneShmReceiver* m_shm_receiver;
+    //! RAW_READ_MAX_DATAGRAMS slots of CANAS_FRAME_MAX_BYTES
+    QByteArray m_raw_read_buffer;
 
     QHostAddress m_write_hostaddress;
     unsigned int m_writeport;
     QUdpSocket* m_write_socketdevice;
 
+    //! records the received datagrams when a record file is configured
+    DatagramRecorder m_recorder;
+
+    bool m_was_ever_connected;
+    bool m_sent_request;
+    int m_count_wait_response;
+
+    //! sequence number tracking of batched frames
+    bool m_frame_sequence_valid;
+    uint16_t m_last_frame_sequence;
+    uint m_lost_frame_count;
+
+    //! position of the last state vector keyframe, the deltas refer to it
+    bool m_state_keyframe_valid;
+    uint8_t m_state_keyframe;
+    double m_state_keyframe_lat;
+    double m_state_keyframe_lon;
+    double m_state_keyframe_alt_ft;
+    //! number of deltas dropped because their keyframe was not received
+    uint m_state_dropped_count;
+
     //FSTcasEntryValueList m_tcas_entry_list;
 
+    //----- CAN message dispatching
+
+    //! values of messages which are combined with other messages before
+    //! they are set to the flightstatus
+    class ReceivedValues
+    {
+    public:
+        ReceivedValues();
+
+        enum { FLAP_NOTCH_COUNT = 10 };
+
+        bool ap_spd_is_mach;
+        float true_alt_ft;
+        float kias_maximum_operating;
+        float mach_maximum_operating;
+        float speed_of_sound;
+        float flap_notches[FLAP_NOTCH_COUNT];
+        bool throttle_override;
+        int year;
+
+        int adf1_freq, adf2_freq;
+        float adf1_bearing, adf2_bearing;
+        QString ndb1_id, ndb2_id;
+        float ndb1_lat, ndb1_lon, ndb2_lat, ndb2_lon;
+
+        float nav1_dme, nav2_dme;
+        int nav1_flag, nav2_flag;
+        bool nav1_has_dme, nav2_has_dme;
+        QString vor1_id, vor2_id;
+        float vor1_lat, vor1_lon, vor2_lat, vor2_lon;
+        bool vor1_has_loc, vor2_has_loc;
+        int vor1_loc_course, vor2_loc_course;
+    };
+
+    class CanDispatchEntry;
+    typedef void (FSAccessXPlane::*CanHandler)(const can_t& canmsg, const CanDispatchEntry& entry);
+
+    //! describes how the messages of one refid are decoded: either the
+    //! value is scaled and stored to the member the entry points to or the
+    //! handler is called.
+    class CanDispatchEntry
+    {
+    public:
+        CanDispatchEntry();
+
+        enum Kind { UNHANDLED = 0, IGNORED, HANDLER,
+                    FS_DOUBLE, FS_SMOOTHED, FS_BOOL, FS_INT, FS_UINT, ENGINE_DOUBLE,
+                    OWN_FLOAT, OWN_INT, OWN_BOOL, OWN_STRING };
+
+        Kind kind;
+        //! expected CANaerospace data type (AS_FLOAT, AS_LONG, AS_UCHAR, FP_ACHAR5)
+        uint8_t type;
+        double scale;
+        //! handler parameter (e.g. 1 for NAV1, 2 for NAV2)
+        int index;
+
+        CanHandler handler;
+        double FlightStatus::* fs_double;
+        SmoothedChannel FlightStatus::* fs_smoothed;
+        bool FlightStatus::* fs_bool;
+        int FlightStatus::* fs_int;
+        uint FlightStatus::* fs_uint;
+        double EngineData::* engine_double;
+        float ReceivedValues::* own_float;
+        int ReceivedValues::* own_int;
+        bool ReceivedValues::* own_bool;
+        QString ReceivedValues::* own_string;
+
+        uint message_count;
+        uint window_count;
+        double rate;
+    };
+
+    //! builds m_dispatch, called once at startup
+    void setupDispatchTable();
+
+    CanDispatchEntry& addEntry(uint id, CanDispatchEntry::Kind kind, uint8_t type);
+    void addIgnored(uint id, uint8_t type);
+    void addHandler(uint id, CanHandler handler, int index = 0);
+    void addField(uint id, uint8_t type, double FlightStatus::* field, double scale = 1.0);
+    void addField(uint id, uint8_t type, SmoothedChannel FlightStatus::* field, double scale = 1.0);
+    void addField(uint id, uint8_t type, bool FlightStatus::* field);
+    void addField(uint id, uint8_t type, int FlightStatus::* field, double scale = 1.0);
+    void addField(uint id, uint8_t type, uint FlightStatus::* field, double scale = 1.0);
+    void addField(uint id, uint8_t type, double EngineData::* field, double scale = 1.0);
+    void addField(uint id, uint8_t type, float ReceivedValues::* field);
+    void addField(uint id, uint8_t type, int ReceivedValues::* field);
+    void addField(uint id, uint8_t type, bool ReceivedValues::* field);
+    void addField(uint id, uint8_t type, QString ReceivedValues::* field);
+
+    //! returns the value of the given message, checks the data type
+    double decodeValue(const can_t& canmsg, uint8_t type);
+
+    void countMessage(CanDispatchEntry& entry);
+
+    void handleNodeServiceRequest(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleFlaps(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleFlapRequest(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleFlapDetents(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleFlapDetentPosition(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleSpeedBrake(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleThrottleAxis(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleZuluTime(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleZuluDate(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleStallSpeed(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleSpeedOfSound(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleAltimeterSetting(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleObs(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleTrueHeading(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleHeightAboveGround(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleIas(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleTrueAltitude(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleAPAltitude(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleAPHeading(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleAPSpeed(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleAPVs(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleAPState(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleFDOn(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleFDRoll(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleFDPitch(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleMagvar(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleFuelWeight(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleParkingBrake(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleNumberOfEngines(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleEngineThrottle(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleEngineN1(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleEngineReverser(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleEngineAntiIce(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleGear(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleNdbTuned(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleVorTuned(const can_t& canmsg, const CanDispatchEntry& entry);
+    void handleTotalNum(const can_t& canmsg, const CanDispatchEntry& entry);
+
+    //! message rates are measured over this period
+    static const int RATE_WINDOW_MS = 10000;
+
+    //! decoding of the CAN messages, indexed by refid
+    QVector<CanDispatchEntry> m_dispatch;
+    ReceivedValues m_received;
+    ClockTimer m_rate_window_timer;
+
 private:
     //! Hidden copy-constructor
     FSAccessXPlane(const FSAccessXPlane&);
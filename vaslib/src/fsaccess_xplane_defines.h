@@ -28,9 +28,25 @@
 #define CFG_HOSTADDRESS "hostaddress"
 #define CFG_PORT_FROM_SIM "port_from_sim"
 #define CFG_PORT_TO_SIM "port_to_sim"
+#define CFG_RECORD_FILE "record_file"
+#define CFG_BATCHED_FRAMES "batched_frames"
+#define CFG_RAW_SOCKET_READER "raw_socket_reader"
+#define CFG_RECEIVE_THREAD "receive_thread"
+#define CFG_STATE_VECTORS "state_vectors"
+#define CFG_STATE_VECTOR_RATE "state_vector_rate"
+#define CFG_SHARED_MEMORY "shared_memory"
+
+#define CFG_REPLAY_FILE "replay_file"
+#define CFG_REPLAY_SPEED "replay_speed"
 
 #define READ_TIMEOUT_PERIOD_MS 3000
 
+//! max. number of datagrams fetched with one recvmmsg call by the raw socket reader
+#define RAW_READ_MAX_DATAGRAMS 64
+//! max. number of recvmmsg calls per read notification, more datagrams are
+//! left for the next notification to not stall the event loop
+#define RAW_READ_MAX_CALLS 4
+
 #endif /* FSACCESS_XPLANE_DEFINES_H */
 
 // End of file
@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    fsaccess_xplane_receiver.cpp
+    \author  vasFMC contributors
+*/
+
+#include <string.h>
+
+#include "assert.h"
+#include "fsaccess_xplane_defines.h"
+
+#include "fsaccess_xplane_receiver.h"
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlaneReceiver::FSAccessXPlaneReceiver(int socket_descriptor) :
+    m_socket(socket_descriptor), m_stop(0), m_notify_pending(0), m_overflow_count(0),
+    m_error_count(0), m_last_error(0), m_head(0), m_tail(0)
+{
+    MYASSERT(m_socket >= 0);
+    MYASSERT((SLOT_COUNT & (SLOT_COUNT - 1)) == 0);
+    m_slots.resize(SLOT_COUNT * CANAS_FRAME_MAX_BYTES);
+    memset(m_sizes, 0, sizeof(m_sizes));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlaneReceiver::FSAccessXPlaneReceiver() :
+    m_socket(-1), m_stop(0), m_notify_pending(0), m_overflow_count(0),
+    m_error_count(0), m_last_error(0), m_head(0), m_tail(0)
+{
+    MYASSERT((SLOT_COUNT & (SLOT_COUNT - 1)) == 0);
+    m_slots.resize(SLOT_COUNT * CANAS_FRAME_MAX_BYTES);
+    memset(m_sizes, 0, sizeof(m_sizes));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlaneReceiver::~FSAccessXPlaneReceiver()
+{
+    stop();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlaneReceiver::stop()
+{
+    m_stop.fetchAndStoreOrdered(1);
+    wait();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlaneReceiver::release(int count)
+{
+    MYASSERT(count >= 0 && count <= available());
+
+    // allow a new notification before the remaining datagrams are checked,
+    // so datagrams arriving meanwhile are not missed
+    m_notify_pending.fetchAndStoreOrdered(0);
+    m_tail.fetchAndAddRelease(count);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlaneReceiver::run()
+{
+#ifdef Q_OS_LINUX
+    bool was_full = false;
+
+    while(m_stop.fetchAndAddAcquire(0) == 0)
+    {
+        int used = (int)((uint)(int)m_head - (uint)m_tail.fetchAndAddAcquire(0));
+        int free_slots = SLOT_COUNT - used;
+
+        if (free_slots <= 0)
+        {
+            // the consumer is behind, the datagrams wait in the socket buffer
+            if (!was_full) m_overflow_count.ref();
+            was_full = true;
+            msleep(1);
+            continue;
+        }
+        was_full = false;
+
+        if (!waitForData()) continue;
+
+        int received = receive(free_slots);
+        if (received < 0)
+        {
+            m_error_count.ref();
+            msleep(10);
+            continue;
+        }
+        if (received == 0) continue;
+
+        m_head.fetchAndAddRelease(received);
+        if (m_notify_pending.testAndSetOrdered(0, 1)) emit signalReceived();
+    }
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlaneReceiver::waitForData()
+{
+#ifdef Q_OS_LINUX
+    struct pollfd poll_fd;
+    poll_fd.fd = m_socket;
+    poll_fd.events = POLLIN;
+    poll_fd.revents = 0;
+    return ::poll(&poll_fd, 1, POLL_TIMEOUT_MS) > 0;
+#else
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+int FSAccessXPlaneReceiver::receive(int free_slots)
+{
+#ifdef Q_OS_LINUX
+    // only the slots up to the end of the ring are contiguous
+    uint first_slot = (uint)(int)m_head % SLOT_COUNT;
+    int count = qMin(qMin(free_slots, (int)(SLOT_COUNT - first_slot)), RAW_READ_MAX_DATAGRAMS);
+
+    struct mmsghdr headers[RAW_READ_MAX_DATAGRAMS];
+    struct iovec iovecs[RAW_READ_MAX_DATAGRAMS];
+    char* buffer = m_slots.data() + first_slot * CANAS_FRAME_MAX_BYTES;
+
+    memset(headers, 0, sizeof(headers));
+    for(int index = 0; index < count; ++index)
+    {
+        iovecs[index].iov_base = buffer + index * CANAS_FRAME_MAX_BYTES;
+        iovecs[index].iov_len = CANAS_FRAME_MAX_BYTES;
+        headers[index].msg_hdr.msg_iov = &iovecs[index];
+        headers[index].msg_hdr.msg_iovlen = 1;
+    }
+
+    int received = ::recvmmsg(m_socket, headers, count, MSG_DONTWAIT, 0);
+    if (received < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+        m_last_error.fetchAndStoreRelaxed(errno);
+        return -1;
+    }
+
+    for(int index = 0; index < received; ++index)
+        m_sizes[first_slot + index] = headers[index].msg_len;
+
+    return received;
+#else
+    Q_UNUSED(free_slots);
+    return -1;
+#endif
+}
+
+// End of file
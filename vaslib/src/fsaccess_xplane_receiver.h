@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    fsaccess_xplane_receiver.h
+    \author  vasFMC contributors
+*/
+
+#ifndef FSACCESS_XPLANE_RECEIVER_H
+#define FSACCESS_XPLANE_RECEIVER_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QByteArray>
+
+#include "canas.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Receives the datagrams of the X-Plane plugin in its own thread, so the
+//! reception does not depend on the load of the GUI thread.
+//! The datagrams are stored in a single producer/single consumer ring of
+//! fixed size slots (no locks, no copies). The GUI thread processes them
+//! with datagram()/release() when it suits (e.g. at the start of the FMC
+//! cycle), so the flightstatus is never changed while the FMC reads it.
+//! signalReceived() is emitted once when new datagrams arrived after the
+//! ring was drained.
+class FSAccessXPlaneReceiver : public QThread
+{
+    Q_OBJECT
+
+public:
+
+    //! Standard Constructor, the caller keeps the ownership of the given
+    //! (bound) socket.
+    FSAccessXPlaneReceiver(int socket_descriptor);
+
+    //! Destructor, stops the thread
+    virtual ~FSAccessXPlaneReceiver();
+
+    //! stops the thread and waits until it finished
+    void stop();
+
+    //----- consumer side
+
+    //! returns the number of datagrams ready to be processed
+    inline int available() const { return (int)((uint)readHead() - (uint)(int)m_tail); }
+
+    //! returns the datagram with the given index (0 = oldest)
+    inline const char* datagram(int index, uint& size) const
+    {
+        uint slot = ((uint)(int)m_tail + index) % SLOT_COUNT;
+        size = m_sizes[slot];
+        return m_slots.constData() + slot * CANAS_FRAME_MAX_BYTES;
+    }
+
+    //! releases the given number of oldest datagrams
+    void release(int count);
+
+    //! returns how often the ring was full (the datagrams then wait in the socket)
+    inline uint overflowCount() const { return (int)m_overflow_count; }
+
+    //! returns the number of failed receive calls and the last error number
+    inline uint errorCount() const { return (int)m_error_count; }
+    inline int lastError() const { return (int)m_last_error; }
+
+signals:
+
+    void signalReceived();
+
+protected:
+
+    //! Constructor for derived classes which receive from an other source
+    //! than a socket, see waitForData() and receive().
+    FSAccessXPlaneReceiver();
+
+    virtual void run();
+
+    //! waits up to POLL_TIMEOUT_MS for new datagrams, returns true when
+    //! there are datagrams to receive.
+    virtual bool waitForData();
+
+    //! returns the producer position with acquire semantics
+    inline int readHead() const { return const_cast<QAtomicInt&>(m_head).fetchAndAddAcquire(0); }
+
+    //! receives up to the given number of datagrams into the free slots
+    //! starting at the head, returns the number of received datagrams or
+    //! -1 on errors.
+    virtual int receive(int free_slots);
+
+protected:
+
+    //! number of slots of the ring
+    static const int SLOT_COUNT = 256;
+    //! max. time to wait for data before the stop flag is checked again
+    static const int POLL_TIMEOUT_MS = 100;
+
+    int m_socket;
+    QAtomicInt m_stop;
+    QAtomicInt m_notify_pending;
+    QAtomicInt m_overflow_count;
+    QAtomicInt m_error_count;
+    QAtomicInt m_last_error;
+
+    //! SLOT_COUNT slots of CANAS_FRAME_MAX_BYTES
+    QByteArray m_slots;
+    uint m_sizes[SLOT_COUNT];
+
+    //! number of produced datagrams, only written by the receive thread.
+    //! Head and tail wrap around, SLOT_COUNT must be a power of two.
+    QAtomicInt m_head;
+    //! number of consumed datagrams, only written by the consumer
+    QAtomicInt m_tail;
+
+private:
+    //! Hidden copy-constructor
+    FSAccessXPlaneReceiver(const FSAccessXPlaneReceiver&);
+    //! Hidden assignment operator
+    const FSAccessXPlaneReceiver& operator = (const FSAccessXPlaneReceiver&);
+};
+
+#endif /* FSACCESS_XPLANE_RECEIVER_H */
+
+// End of file
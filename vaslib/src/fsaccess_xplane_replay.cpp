@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    fsaccess_xplane_replay.cpp
+    \author  vasFMC contributors
+*/
+
+#include "assert.h"
+#include "logger.h"
+
+#include "fsaccess_xplane_defines.h"
+#include "fsaccess_xplane_replay.h"
+
+//! interval of the replay timer, all datagrams due are processed at once
+#define REPLAY_TIMER_INTERVAL_MS 5
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlaneReplay::FSAccessXPlaneReplay(ConfigWidgetProvider* config_widget_provider,
+                                           const QString& cfg_file,
+                                           FlightStatus* flightstatus) :
+    FSAccessXPlane(config_widget_provider, cfg_file, flightstatus, true),
+    m_clock(0), m_replay_start_ms(0), m_has_pending(false), m_pending_timestamp_ms(0),
+    m_replayed_count(0), m_discarded_write_count(0)
+{
+    if (!m_cfg.contains(CFG_REPLAY_FILE)) m_cfg.setValue(CFG_REPLAY_FILE, "");
+    if (!m_cfg.contains(CFG_REPLAY_SPEED)) m_cfg.setValue(CFG_REPLAY_SPEED, "1.0");
+    m_cfg.saveToFile();
+
+    // the recording starts with the plugin handshake already done
+    m_was_ever_connected = true;
+    m_sent_request = true;
+
+    double speed = m_cfg.getValue(CFG_REPLAY_SPEED).toDouble();
+    if (speed <= 0.0)
+    {
+        Logger::log(QString("FSAccessXPlaneReplay: invalid replay speed (%1), using 1.0").
+                    arg(m_cfg.getValue(CFG_REPLAY_SPEED)));
+        speed = 1.0;
+    }
+
+    if (!m_reader.open(m_cfg.getValue(CFG_REPLAY_FILE)))
+    {
+        Logger::log("FSAccessXPlaneReplay: nothing to replay");
+        return;
+    }
+
+    // the scaled clock continues from the current time, so running timers are not disturbed
+    m_clock = new ScaledClock(speed, Clock::current());
+    MYASSERT(m_clock != 0);
+    Clock::setCurrent(m_clock);
+
+    m_has_pending = m_reader.next(m_pending_timestamp_ms, m_pending_data);
+    m_replay_start_ms = m_clock->msecs() - (m_has_pending ? m_pending_timestamp_ms : 0);
+    m_wall_timer.start();
+
+    Logger::log(QString("FSAccessXPlaneReplay: replaying (%1) with speed %2").
+                arg(m_cfg.getValue(CFG_REPLAY_FILE)).arg(speed));
+
+    MYASSERT(connect(&m_replay_timer, SIGNAL(timeout()), this, SLOT(slotReplayTimer())));
+    m_replay_timer.start(REPLAY_TIMER_INTERVAL_MS);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlaneReplay::~FSAccessXPlaneReplay()
+{
+    m_replay_timer.stop();
+
+    if (m_clock != 0)
+    {
+        if (Clock::current() == m_clock) Clock::setCurrent(0);
+        delete m_clock;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlaneReplay::slotReplayTimer()
+{
+    qint64 replay_ms = m_clock->msecs() - m_replay_start_ms;
+
+    while(m_has_pending && (qint64)m_pending_timestamp_ms <= replay_ms)
+    {
+        processDatagram(m_pending_data.constData(), m_pending_data.size());
+        ++m_replayed_count;
+        m_has_pending = m_reader.next(m_pending_timestamp_ms, m_pending_data);
+    }
+
+    if (!m_has_pending) finishReplay();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlaneReplay::finishReplay()
+{
+    m_replay_timer.stop();
+    m_reader.close();
+
+    qint64 wall_ms = m_wall_timer.elapsed();
+    qint64 sim_ms = m_clock->msecs() - m_replay_start_ms;
+
+    Logger::log(QString("FSAccessXPlaneReplay: replay finished: %1 datagrams, %2s recorded time, "
+                        "%3s real time, %4 datagrams/s, %5 writes discarded").
+                arg(m_replayed_count).
+                arg(sim_ms / 1000.0, 0, 'f', 1).
+                arg(wall_ms / 1000.0, 0, 'f', 1).
+                arg(wall_ms > 0 ? m_replayed_count * 1000.0 / wall_ms : 0.0, 0, 'f', 0).
+                arg(m_discarded_write_count));
+}
+
+// End of file
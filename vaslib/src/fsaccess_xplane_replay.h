@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    fsaccess_xplane_replay.h
+    \author  vasFMC contributors
+*/
+
+#ifndef FSACCESS_XPLANE_REPLAY_H
+#define FSACCESS_XPLANE_REPLAY_H
+
+#include <QElapsedTimer>
+
+#include "fsaccess_xplane.h"
+#include "datagram_recorder.h"
+#include "clock.h"
+
+//! Replays a flight recorded by FSAccessXPlane (see CFG_RECORD_FILE) into
+//! the flightstatus. The replay speed is configurable, while replaying the
+//! current clock runs with the replay speed, so the smoothing, timers and
+//! controllers see the recorded flight in its recorded timing. At the end of
+//! the recording some benchmark figures are logged.
+class FSAccessXPlaneReplay : public FSAccessXPlane
+{
+    Q_OBJECT
+
+public:
+
+    //! Standard Constructor
+    FSAccessXPlaneReplay(ConfigWidgetProvider* config_widget_provider,
+                         const QString& cfg_file, FlightStatus* flightstatus);
+
+    //! Destructor
+    virtual ~FSAccessXPlaneReplay();
+
+protected slots:
+
+    void slotReplayTimer();
+
+protected:
+
+    //! nothing is sent during a replay, the messages are only counted
+    virtual bool writeCan(const can_t&) { ++m_discarded_write_count; return true; }
+
+    void finishReplay();
+
+protected:
+
+    DatagramRecordReader m_reader;
+    ScaledClock* m_clock;
+    QTimer m_replay_timer;
+
+    //! clock time of the start of the replay
+    qint64 m_replay_start_ms;
+    //! real time since the start of the replay
+    QElapsedTimer m_wall_timer;
+
+    bool m_has_pending;
+    quint32 m_pending_timestamp_ms;
+    QByteArray m_pending_data;
+
+    uint m_replayed_count;
+    uint m_discarded_write_count;
+
+private:
+    //! Hidden copy-constructor
+    FSAccessXPlaneReplay(const FSAccessXPlaneReplay&);
+    //! Hidden assignment operator
+    const FSAccessXPlaneReplay& operator = (const FSAccessXPlaneReplay&);
+};
+
+#endif /* FSACCESS_XPLANE_REPLAY_H */
+
+// End of file
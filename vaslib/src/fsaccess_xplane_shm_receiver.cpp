@@ -0,0 +1,261 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    fsaccess_xplane_shm_receiver.cpp
+    \author  vasFMC contributors
+*/
+
+
+#include <string.h>
+
+#include "assert.h"
+#include "logger.h"
+
+#include "fsaccess_xplane_shm_receiver.h"
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlaneShmReceiver::FSAccessXPlaneShmReceiver() : m_ring(0), m_records(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+FSAccessXPlaneShmReceiver::~FSAccessXPlaneShmReceiver()
+{
+    stop();
+    detach();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void FSAccessXPlaneShmReceiver::detach()
+{
+#ifdef Q_OS_LINUX
+    if (m_ring == 0) return;
+
+    uint32_t pid = (uint32_t)::getpid();
+    __atomic_compare_exchange_n(&m_ring->reader_pid, &pid, 0, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+
+    ::munmap(m_ring, sizeof(canAS_shm_ring_t) + CANAS_SHM_CAPACITY);
+    m_ring = 0;
+    m_records = 0;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlaneShmReceiver::claim()
+{
+#ifdef Q_OS_LINUX
+    MYASSERT(m_ring != 0);
+
+    uint32_t pid = (uint32_t)::getpid();
+    uint32_t reader_pid = __atomic_load_n(&m_ring->reader_pid, __ATOMIC_ACQUIRE);
+    while(reader_pid != pid)
+    {
+        // the claim of a receiver which is gone is taken over
+        if (reader_pid != 0 && (::kill(reader_pid, 0) == 0 || errno != ESRCH))
+        {
+            Logger::log(QString("FSAccessXPlaneShmReceiver:claim: shared memory is read by process %1").
+                        arg(reader_pid));
+            return false;
+        }
+
+        if (__atomic_compare_exchange_n(&m_ring->reader_pid, &reader_pid, pid, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) break;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlaneShmReceiver::attach()
+{
+    MYASSERT(!isRunning());
+#ifdef Q_OS_LINUX
+    if (m_ring != 0) return true;
+
+    int fd = ::shm_open(CANAS_SHM_NAME, O_RDWR, 0);
+    if (fd < 0) return false;
+
+    size_t bytes = sizeof(canAS_shm_ring_t) + CANAS_SHM_CAPACITY;
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (::fstat(fd, &info) == 0 && (size_t)info.st_size >= bytes)
+        memory = ::mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) return false;
+
+    m_ring = (canAS_shm_ring_t*)memory;
+    if (__atomic_load_n(&m_ring->magic, __ATOMIC_ACQUIRE) != CANAS_SHM_MAGIC ||
+        m_ring->version != CANAS_SHM_VERSION || m_ring->capacity != CANAS_SHM_CAPACITY || !isWriterAlive())
+    {
+        ::munmap(memory, bytes);
+        m_ring = 0;
+        return false;
+    }
+
+    // the ring has a single reader
+    if (!claim())
+    {
+        ::munmap(memory, bytes);
+        m_ring = 0;
+        return false;
+    }
+
+    m_records = (const char*)memory + sizeof(canAS_shm_ring_t);
+    __atomic_store_n(&m_ring->tail, __atomic_load_n(&m_ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlaneShmReceiver::isWriterAlive() const
+{
+#ifdef Q_OS_LINUX
+    if (m_ring == 0) return false;
+    return ::kill(m_ring->writer_pid, 0) == 0 || errno != ESRCH;
+#else
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlaneShmReceiver::isRingActive() const
+{
+#ifdef Q_OS_LINUX
+    if (m_ring == 0) return false;
+    return __atomic_load_n(&m_ring->ring_active, __ATOMIC_ACQUIRE) != 0;
+#else
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlaneShmReceiver::hasRecords() const
+{
+#ifdef Q_OS_LINUX
+    return __atomic_load_n(&m_ring->head, __ATOMIC_SEQ_CST) != m_ring->tail;
+#else
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool FSAccessXPlaneShmReceiver::waitForData()
+{
+#ifdef Q_OS_LINUX
+    MYASSERT(m_ring != 0);
+
+    __atomic_add_fetch(&m_ring->reader_heartbeat, 1, __ATOMIC_RELEASE);
+    if (hasRecords()) return true;
+
+    // the writer increments the futex word after the head, so the wait
+    // returns at once when records arrive after the check below
+    __atomic_store_n(&m_ring->reader_waiting, 1, __ATOMIC_SEQ_CST);
+    uint32_t wakeup = __atomic_load_n(&m_ring->wakeup, __ATOMIC_SEQ_CST);
+    if (!hasRecords())
+    {
+        struct timespec timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_nsec = CANAS_SHM_WAIT_MS * 1000000L;
+        ::syscall(SYS_futex, &m_ring->wakeup, FUTEX_WAIT, wakeup, &timeout, 0, 0);
+    }
+    __atomic_store_n(&m_ring->reader_waiting, 0, __ATOMIC_SEQ_CST);
+
+    return hasRecords();
+#else
+    return false;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+int FSAccessXPlaneShmReceiver::receive(int free_slots)
+{
+#ifdef Q_OS_LINUX
+    MYASSERT(m_ring != 0);
+
+    uint64_t tail = m_ring->tail;
+    uint64_t head = __atomic_load_n(&m_ring->head, __ATOMIC_ACQUIRE);
+    uint first_slot = (uint)(int)m_head;
+    int received = 0;
+
+    while(tail != head && received < free_slots)
+    {
+        uint offset = (uint)(tail % CANAS_SHM_CAPACITY);
+        uint32_t size = 0;
+        memcpy(&size, m_records + offset, sizeof(size));
+
+        if (size == CANAS_SHM_WRAP)
+        {
+            tail += CANAS_SHM_CAPACITY - offset;
+            continue;
+        }
+
+        if (size <= CANAS_FRAME_MAX_BYTES)
+        {
+            uint slot = (first_slot + received) % SLOT_COUNT;
+            memcpy(m_slots.data() + slot * CANAS_FRAME_MAX_BYTES, m_records + offset + sizeof(size), size);
+            m_sizes[slot] = size;
+            ++received;
+        }
+        else
+        {
+            // broken ring, skip everything written so far
+            m_error_count.ref();
+            tail = head;
+            break;
+        }
+
+        tail += CANAS_SHM_RECORD_BYTES(size);
+    }
+
+    __atomic_store_n(&m_ring->tail, tail, __ATOMIC_RELEASE);
+    return received;
+#else
+    Q_UNUSED(free_slots);
+    return 0;
+#endif
+}
+
+// End of file
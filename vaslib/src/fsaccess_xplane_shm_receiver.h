@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    fsaccess_xplane_shm_receiver.h
+    \author  vasFMC contributors
+*/
+
+
+#ifndef FSACCESS_XPLANE_SHM_RECEIVER_H
+#define FSACCESS_XPLANE_SHM_RECEIVER_H
+
+#include "fsaccess_xplane_receiver.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Reads the datagrams of the X-Plane plugin from the shared memory ring
+//! (see canAS_shm_ring_t) when vasFMC runs on the host of the simulator.
+//! The thread sleeps on the futex word of the ring until the plugin wrote
+//! new records and copies them into the same slots the UDP receiver uses,
+//! so the GUI thread processes them alike. While the thread runs it
+//! increments the heartbeat of the ring, the plugin falls back to UDP when
+//! the heartbeat stalls or the ring runs full.
+class FSAccessXPlaneShmReceiver : public FSAccessXPlaneReceiver
+{
+    Q_OBJECT
+
+public:
+
+    //! Standard Constructor
+    FSAccessXPlaneShmReceiver();
+
+    //! Destructor, stops the thread and unmaps the ring
+    virtual ~FSAccessXPlaneShmReceiver();
+
+    //! maps the ring created by the plugin and claims it, returns false when
+    //! there is no valid ring of a running plugin on this host (linux only)
+    //! or an other running receiver claimed it. Records written before are
+    //! skipped.
+    bool attach();
+
+    inline bool isAttached() const { return m_ring != 0; }
+
+    //! returns false when the plugin which created the ring is gone, a
+    //! restarted plugin creates a new ring.
+    bool isWriterAlive() const;
+
+    //! returns true while the plugin writes the datagrams into the ring,
+    //! the data datagrams received over UDP are duplicates then.
+    bool isRingActive() const;
+
+protected:
+
+    //! waits on the futex word of the ring
+    virtual bool waitForData();
+
+    //! copies the records of the ring into the free slots
+    virtual int receive(int free_slots);
+
+    //! returns true when the plugin wrote records we did not read yet
+    bool hasRecords() const;
+
+    //! claims the ring for this process, returns false when an other
+    //! running process claimed it.
+    bool claim();
+
+    //! unmaps the ring, releases the claim
+    void detach();
+
+protected:
+
+    canAS_shm_ring_t* m_ring;
+    const char* m_records;
+
+private:
+    //! Hidden copy-constructor
+    FSAccessXPlaneShmReceiver(const FSAccessXPlaneShmReceiver&);
+    //! Hidden assignment operator
+    const FSAccessXPlaneShmReceiver& operator = (const FSAccessXPlaneShmReceiver&);
+};
+
+#endif /* FSACCESS_XPLANE_SHM_RECEIVER_H */
+
+// End of file
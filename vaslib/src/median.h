@@ -25,12 +25,19 @@
 #ifndef MEDIAN_H
 #define MEDIAN_H
 
+#include <set>
+
+#include <QVector>
+
 #include "assert.h"
 #include "navcalc.h"
 
 /////////////////////////////////////////////////////////////////////////////
 
-//! mean value
+//! sliding window median.
+//! The window is kept in a ring buffer (insertion order) and in an ordered
+//! multiset (value order). An iterator to the middle element of the multiset
+//! is moved along on every update, so add() is O(log n) and median() is O(1).
 template <class TYPE> class Median 
 {
 public:
@@ -38,44 +45,106 @@ public:
     Median(uint length, const TYPE& init_value) : 
         m_init_value(init_value), m_middle_index(Navcalc::round(length/2.0)), m_length(length)
     {
-        for(uint index=0; index<length; ++index) m_value_list.append(init_value);
-        m_sorted_list = m_value_list;
+        MYASSERT(m_length > 0);
+        if (m_middle_index >= (int)m_length) m_middle_index = m_length - 1;
+        clear();
     };
 
+    //! Copy Constructor, the middle iterator must point into our own set
+    Median(const Median<TYPE>& other) :
+        m_init_value(other.m_init_value), m_middle_index(other.m_middle_index),
+        m_ring(other.m_ring), m_ring_pos(other.m_ring_pos), 
+        m_sorted_set(other.m_sorted_set), m_length(other.m_length)
+    {
+        resetMiddle();
+    }
+
     //! Destructor
     virtual ~Median()
     {};
 
-    //! calculates the new mean value with the given value
+    //! Assignment operator, the middle iterator must point into our own set
+    const Median<TYPE>& operator=(const Median<TYPE>& other)
+    {
+        if (&other == this) return *this;
+        m_init_value = other.m_init_value;
+        m_middle_index = other.m_middle_index;
+        m_ring = other.m_ring;
+        m_ring_pos = other.m_ring_pos;
+        m_sorted_set = other.m_sorted_set;
+        m_length = other.m_length;
+        resetMiddle();
+        return *this;
+    }
+
+    //! adds the given value and drops the oldest one from the window
     inline void add(const TYPE& value) 
     { 
-        m_value_list.removeFirst();
-        m_value_list.append(value);
-        MYASSERT(m_value_list.count() == (int)m_length);
-    
-        m_sorted_list = m_value_list;
-        qSort(m_sorted_list.begin(), m_sorted_list.end());
+        // insert the new value, equal values are inserted behind the middle
+        if (value < *m_middle) 
+        {
+            m_sorted_set.insert(value);
+            --m_middle;
+        }
+        else
+        {
+            m_sorted_set.insert(value);
+        }
+
+        // remove the oldest value
+        const TYPE oldest = m_ring[m_ring_pos];
+        if (oldest < *m_middle)
+        {
+            m_sorted_set.erase(m_sorted_set.find(oldest));
+            ++m_middle;
+        }
+        else if (*m_middle < oldest)
+        {
+            m_sorted_set.erase(m_sorted_set.find(oldest));
+        }
+        else
+        {
+            // the next element moves into the middle position
+            m_middle = m_sorted_set.erase(m_middle);
+        }
+
+        m_ring[m_ring_pos] = value;
+        m_ring_pos = (m_ring_pos + 1) % m_length;
+        MYASSERT(m_sorted_set.size() == m_length);
     }
     
-    //! returns the calculated mean value
-    inline const TYPE& median() const { return m_value_list[m_middle_index]; }
+    //! returns the median of the current window
+    inline const TYPE& median() const { return *m_middle; }
 
     inline uint length() const { return m_length; }
 
     void clear()
     {
-        m_value_list.clear();
-        m_sorted_list.clear();
-        for(uint index=0; index<m_length; ++index) m_value_list.append(m_init_value);
-        m_sorted_list = m_value_list;
+        m_ring.fill(m_init_value, m_length);
+        m_ring_pos = 0;
+        m_sorted_set.clear();
+        for(uint index=0; index<m_length; ++index) m_sorted_set.insert(m_init_value);
+        resetMiddle();
     }
     
+protected:
+
+    void resetMiddle()
+    {
+        m_middle = m_sorted_set.begin();
+        for(int index=0; index<m_middle_index; ++index) ++m_middle;
+    }
+
 protected:
     
     TYPE m_init_value;
     int m_middle_index;
-    QList<TYPE> m_value_list;
-    QList<TYPE> m_sorted_list;
+    //! values in insertion order, m_ring_pos points to the oldest one
+    QVector<TYPE> m_ring;
+    uint m_ring_pos;
+    //! values in sorted order
+    std::multiset<TYPE> m_sorted_set;
+    typename std::multiset<TYPE>::iterator m_middle;
     uint m_length;
 };
 
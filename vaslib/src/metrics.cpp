@@ -0,0 +1,225 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    metrics.cpp
+    \author  vasFMC contributors
+*/
+
+#include <math.h>
+
+#include <QFile>
+#include <QTextStream>
+
+#include "logger.h"
+
+#include "metrics.h"
+
+const qint64 LatencyHistogram::METRICS_MAX_VALUE_US;
+
+MetricsRegistry* MetricsRegistry::m_registry = 0;
+
+/////////////////////////////////////////////////////////////////////////////
+
+LatencyHistogram::LatencyHistogram() : m_bucket_list(METRICS_BUCKET_COUNT, 0)
+{
+    reset();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void LatencyHistogram::record(qint64 value_us)
+{
+    value_us = qMax(Q_INT64_C(0), qMin(value_us, METRICS_MAX_VALUE_US));
+
+    ++m_bucket_list[bucketIndex(value_us)];
+    if (m_count == 0 || value_us < m_min_us) m_min_us = value_us;
+    if (m_count == 0 || value_us > m_max_us) m_max_us = value_us;
+    m_sum_us += value_us;
+    ++m_count;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void LatencyHistogram::reset()
+{
+    m_bucket_list.fill(0);
+    m_count = 0;
+    m_min_us = 0;
+    m_max_us = 0;
+    m_sum_us = 0.0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+qint64 LatencyHistogram::percentileUs(double percent) const
+{
+    if (m_count == 0) return 0;
+
+    quint64 wanted_count = (quint64)ceil(qMax(0.0, qMin(percent, 100.0)) / 100.0 * m_count);
+    wanted_count = qMax(wanted_count, (quint64)1);
+
+    quint64 count = 0;
+    for(int index = 0; index < m_bucket_list.count(); ++index)
+    {
+        count += m_bucket_list[index];
+        if (count >= wanted_count) return qMax(m_min_us, qMin(bucketHighestValueUs(index), m_max_us));
+    }
+
+    return m_max_us;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+int LatencyHistogram::bucketIndex(qint64 value_us)
+{
+    if (value_us < 2*METRICS_SUB_BUCKET_COUNT) return (int)value_us;
+
+    int highest_bit = METRICS_SUB_BUCKET_BITS + 1;
+    while((value_us >> (highest_bit+1)) != 0) ++highest_bit;
+
+    // the sub bucket keeps the METRICS_SUB_BUCKET_BITS bits below the highest one
+    int shift = highest_bit - METRICS_SUB_BUCKET_BITS;
+    return (shift + 1) * METRICS_SUB_BUCKET_COUNT + (int)(value_us >> shift) - METRICS_SUB_BUCKET_COUNT;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+qint64 LatencyHistogram::bucketHighestValueUs(int index)
+{
+    if (index < 2*METRICS_SUB_BUCKET_COUNT) return index;
+
+    int shift = index / METRICS_SUB_BUCKET_COUNT - 1;
+    qint64 sub_bucket = (index % METRICS_SUB_BUCKET_COUNT) + METRICS_SUB_BUCKET_COUNT;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+MetricsRegistry::~MetricsRegistry()
+{
+    qDeleteAll(m_histogram_map);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void MetricsRegistry::recordLatency(const QString& name, qint64 value_us)
+{
+    LatencyHistogram* histogram = m_histogram_map.value(name, 0);
+    if (histogram == 0)
+    {
+        histogram = new LatencyHistogram;
+        MYASSERT(histogram != 0);
+        m_histogram_map.insert(name, histogram);
+    }
+
+    histogram->record(value_us);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void MetricsRegistry::incCounter(const QString& name, qint64 increment)
+{
+    m_counter_map[name] += increment;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void MetricsRegistry::setGauge(const QString& name, double value)
+{
+    m_gauge_map[name] = value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void MetricsRegistry::reset()
+{
+    QMap<QString, LatencyHistogram*>::iterator iter = m_histogram_map.begin();
+    for(; iter != m_histogram_map.end(); ++iter) (*iter)->reset();
+
+    QMap<QString, qint64>::iterator counter_iter = m_counter_map.begin();
+    for(; counter_iter != m_counter_map.end(); ++counter_iter) *counter_iter = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+QStringList MetricsRegistry::reportList() const
+{
+    QStringList report_list;
+
+    QMap<QString, LatencyHistogram*>::const_iterator iter = m_histogram_map.begin();
+    for(; iter != m_histogram_map.end(); ++iter)
+    {
+        const LatencyHistogram& histogram = **iter;
+        report_list.append(QString("%1: count %2, p50 %3us, p99 %4us, p99.9 %5us, max %6us, mean %7us").
+                           arg(iter.key()).arg(histogram.count()).
+                           arg(histogram.percentileUs(50.0)).arg(histogram.percentileUs(99.0)).
+                           arg(histogram.percentileUs(99.9)).arg(histogram.maxUs()).
+                           arg(histogram.meanUs(), 0, 'f', 1));
+    }
+
+    QMap<QString, qint64>::const_iterator counter_iter = m_counter_map.begin();
+    for(; counter_iter != m_counter_map.end(); ++counter_iter)
+        report_list.append(QString("%1: %2").arg(counter_iter.key()).arg(*counter_iter));
+
+    QMap<QString, double>::const_iterator gauge_iter = m_gauge_map.begin();
+    for(; gauge_iter != m_gauge_map.end(); ++gauge_iter)
+        report_list.append(QString("%1: %2").arg(gauge_iter.key()).arg(*gauge_iter));
+
+    return report_list;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool MetricsRegistry::exportToFile(const QString& filename) const
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        Logger::log(QString("MetricsRegistry:exportToFile: could not open file (%1)").arg(filename));
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << "type,name,count,min_us,mean_us,p50_us,p90_us,p99_us,p99.9_us,max_us,value" << endl;
+
+    QMap<QString, LatencyHistogram*>::const_iterator iter = m_histogram_map.begin();
+    for(; iter != m_histogram_map.end(); ++iter)
+    {
+        const LatencyHistogram& histogram = **iter;
+        stream << "histogram," << iter.key() << "," << histogram.count() << "," 
+               << histogram.minUs() << "," << QString::number(histogram.meanUs(), 'f', 1) << ","
+               << histogram.percentileUs(50.0) << "," << histogram.percentileUs(90.0) << ","
+               << histogram.percentileUs(99.0) << "," << histogram.percentileUs(99.9) << ","
+               << histogram.maxUs() << "," << endl;
+    }
+
+    QMap<QString, qint64>::const_iterator counter_iter = m_counter_map.begin();
+    for(; counter_iter != m_counter_map.end(); ++counter_iter)
+        stream << "counter," << counter_iter.key() << ",,,,,,,,," << *counter_iter << endl;
+
+    QMap<QString, double>::const_iterator gauge_iter = m_gauge_map.begin();
+    for(; gauge_iter != m_gauge_map.end(); ++gauge_iter)
+        stream << "gauge," << gauge_iter.key() << ",,,,,,,,," << *gauge_iter << endl;
+
+    return stream.status() == QTextStream::Ok;
+}
+
+// End of file
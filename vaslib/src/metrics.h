@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    metrics.h
+    \author  vasFMC contributors
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QElapsedTimer>
+
+#include "assert.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Histogram of latencies with microsecond resolution. The buckets are
+//! log-linear like in HdrHistogram: values below 2*METRICS_SUB_BUCKET_COUNT
+//! get one bucket each, above each power of two is split into
+//! METRICS_SUB_BUCKET_COUNT buckets, so every recorded value is kept with
+//! a relative error of at most 1/METRICS_SUB_BUCKET_COUNT. Values above
+//! METRICS_MAX_VALUE_US are clamped.
+class LatencyHistogram
+{
+public:
+
+    enum { METRICS_SUB_BUCKET_BITS = 5,
+           METRICS_SUB_BUCKET_COUNT = 1 << METRICS_SUB_BUCKET_BITS,
+           METRICS_VALUE_BITS = 31,
+           METRICS_BUCKET_COUNT = (METRICS_VALUE_BITS - METRICS_SUB_BUCKET_BITS + 1) * METRICS_SUB_BUCKET_COUNT
+    };
+
+    static const qint64 METRICS_MAX_VALUE_US = (Q_INT64_C(1) << METRICS_VALUE_BITS) - 1;
+
+    //! Standard Constructor
+    LatencyHistogram();
+
+    //! Destructor
+    virtual ~LatencyHistogram() {};
+
+    void record(qint64 value_us);
+
+    void reset();
+
+    inline quint64 count() const { return m_count; }
+    inline qint64 minUs() const { return m_min_us; }
+    inline qint64 maxUs() const { return m_max_us; }
+    inline double meanUs() const { return (m_count > 0) ? m_sum_us / m_count : 0.0; }
+
+    //! returns the value below or at which the given percentage (0-100) of
+    //! the recorded values lie, 0 when nothing was recorded
+    qint64 percentileUs(double percent) const;
+
+protected:
+
+    static int bucketIndex(qint64 value_us);
+    //! returns the highest value counted in the given bucket
+    static qint64 bucketHighestValueUs(int index);
+
+protected:
+
+    QVector<quint32> m_bucket_list;
+    quint64 m_count;
+    qint64 m_min_us;
+    qint64 m_max_us;
+    double m_sum_us;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Registry of named latency histograms, counters and gauges, the names
+//! are created on first use. The subsystems record e.g. their refresh
+//! times here, the registry can be shown (e.g. on a CDU page), logged or
+//! exported. Not thread safe, must only be used from the GUI thread.
+class MetricsRegistry
+{
+public:
+
+    static MetricsRegistry* registry()
+    {
+        if (m_registry == 0)
+        {
+            m_registry = new MetricsRegistry;
+            MYASSERT(m_registry != 0);
+        }
+
+        return m_registry;
+    }
+
+    static void finish()
+    {
+        delete m_registry;
+        m_registry = 0;
+    }
+
+    //-----
+
+    //! Destructor
+    virtual ~MetricsRegistry();
+
+    void recordLatency(const QString& name, qint64 value_us);
+    void incCounter(const QString& name, qint64 increment = 1);
+    void setGauge(const QString& name, double value);
+
+    //! returns the names in ascending order
+    inline QStringList histogramNames() const { return m_histogram_map.keys(); }
+    inline QStringList counterNames() const { return m_counter_map.keys(); }
+    inline QStringList gaugeNames() const { return m_gauge_map.keys(); }
+
+    //! returns 0 when the given histogram does not exist
+    const LatencyHistogram* histogram(const QString& name) const { return m_histogram_map.value(name, 0); }
+    inline qint64 counter(const QString& name) const { return m_counter_map.value(name, 0); }
+    inline double gauge(const QString& name) const { return m_gauge_map.value(name, 0.0); }
+
+    //! clears the histograms and counters, the gauges are kept
+    void reset();
+
+    //! returns one line per metric
+    QStringList reportList() const;
+
+    //! writes the metrics to the given file as CSV, returns true on success
+    bool exportToFile(const QString& filename) const;
+
+protected:
+
+    //! Standard Constructor
+    MetricsRegistry() {};
+
+protected:
+
+    static MetricsRegistry* m_registry;
+
+    QMap<QString, LatencyHistogram*> m_histogram_map;
+    QMap<QString, qint64> m_counter_map;
+    QMap<QString, double> m_gauge_map;
+
+private:
+    //! Hidden copy-constructor
+    MetricsRegistry(const MetricsRegistry&);
+    //! Hidden assignment operator
+    const MetricsRegistry& operator = (const MetricsRegistry&);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Records the time from its construction to its destruction in the
+//! latency histogram with the given name.
+class MetricsScope
+{
+public:
+
+    MetricsScope(const QString& name) : m_name(name) { m_timer.start(); }
+
+    ~MetricsScope() { MetricsRegistry::registry()->recordLatency(m_name, m_timer.nsecsElapsed() / 1000); }
+
+protected:
+
+    QString m_name;
+    QElapsedTimer m_timer;
+
+private:
+    //! Hidden copy-constructor
+    MetricsScope(const MetricsScope&);
+    //! Hidden assignment operator
+    const MetricsScope& operator = (const MetricsScope&);
+};
+
+#endif /* METRICS_H */
+
+// End of file
@@ -27,6 +27,7 @@
 
 #include <QTime>
 
+#include "clock.h"
 #include "smoothing.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -65,7 +66,7 @@ public:
 
 protected:
     
-    QTime m_last_noise_update_timer;
+    ClockTimer m_last_noise_update_timer;
     uint m_max_noise_update_interval_ms;
     double m_max_noise_inc_per_update;
     double m_max_noise;
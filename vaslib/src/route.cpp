@@ -524,25 +524,39 @@ bool Route::checkAndSetSpecialWaypoint(int pos, bool take_current_flightdata_as_
 
 /////////////////////////////////////////////////////////////////////////////
 
-void Route::operator>>(QDataStream& out) const
+void Route::writeHeader(QDataStream& out) const
 {
     out << m_type
         << m_flag
         << m_flag_fixed
-        << m_id
-        << m_wpt_list
-        << m_routedata_list;
+        << m_id;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
-void Route::operator<<(QDataStream& in)
+void Route::readHeader(QDataStream& in)
 {
     in >> m_type
        >> m_flag
        >> m_flag_fixed
-       >> m_id
-       >> m_wpt_list
+       >> m_id;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Route::operator>>(QDataStream& out) const
+{
+    writeHeader(out);
+    out << m_wpt_list
+        << m_routedata_list;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Route::operator<<(QDataStream& in)
+{
+    readHeader(in);
+    in >> m_wpt_list
        >> m_routedata_list;
 
     emit signalChanged(m_flag, false, "Route:operator<<");
@@ -550,4 +564,68 @@ void Route::operator<<(QDataStream& in)
 
 /////////////////////////////////////////////////////////////////////////////
 
+void Route::syncFields(QList<QByteArray>& fields) const
+{
+    MYASSERT(m_wpt_list.count() == m_routedata_list.count());
+
+    fields.clear();
+
+    QByteArray header;
+    QDataStream header_stream(&header, QIODevice::WriteOnly);
+    writeHeader(header_stream);
+    fields.append(header);
+
+    for (int index=0; index < m_wpt_list.count(); ++index)
+    {
+        QByteArray wpt_data;
+        QDataStream wpt_stream(&wpt_data, QIODevice::WriteOnly);
+        wpt_stream << m_wpt_list.at(index)->type();
+        *m_wpt_list.at(index) >> wpt_stream;
+
+        QByteArray routedata_data;
+        QDataStream routedata_stream(&routedata_data, QIODevice::WriteOnly);
+        routedata_stream << m_routedata_list.at(index);
+
+        QByteArray leg;
+        QDataStream leg_stream(&leg, QIODevice::WriteOnly);
+        leg_stream << wpt_data << routedata_data;
+        fields.append(leg);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+bool Route::setSyncFields(const QList<QByteArray>& fields)
+{
+    if (fields.isEmpty()) return false;
+
+    // reassemble the stream of operator>>
+
+    QByteArray wpt_list_data;
+    QDataStream wpt_list_stream(&wpt_list_data, QIODevice::WriteOnly);
+    wpt_list_stream << (qint32)(fields.count() - 1);
+
+    QByteArray routedata_list_data;
+    QDataStream routedata_list_stream(&routedata_list_data, QIODevice::WriteOnly);
+    routedata_list_stream << (quint32)(fields.count() - 1);
+
+    for (int index=1; index < fields.count(); ++index)
+    {
+        QByteArray wpt_data, routedata_data;
+        QDataStream leg_stream(fields.at(index));
+        leg_stream >> wpt_data >> routedata_data;
+        if (leg_stream.status() != QDataStream::Ok) return false;
+
+        wpt_list_data += wpt_data;
+        routedata_list_data += routedata_data;
+    }
+
+    QByteArray data = fields.at(0) + wpt_list_data + routedata_list_data;
+    QDataStream ds(data);
+    *this << ds;
+    return ds.status() == QDataStream::Ok && ds.atEnd();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 // End of file
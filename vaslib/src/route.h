@@ -105,6 +105,14 @@ public:
     virtual void operator<<(QDataStream& in);
     virtual void operator>>(QDataStream& out) const;
 
+    //! splits the serialized route into the header and one field per leg
+    //! (waypoint and route data), used to sync only the changed legs to remote FMCs
+    void syncFields(QList<QByteArray>& fields) const;
+
+    //! sets the route from the fields of syncFields(), returns false if they
+    //! could not be read
+    bool setSyncFields(const QList<QByteArray>& fields);
+
     /////////////////////////////////////////////////////////////////////////////
 
     static QString TYPE_ROUTE;
@@ -253,6 +261,11 @@ signals:
 
 protected:
 
+    //! serializes everything but the waypoints and the route data, derived
+    //! classes write their members first and call this method afterwards
+    virtual void writeHeader(QDataStream& out) const;
+    virtual void readHeader(QDataStream& in);
+
     // recalculates the route data for the waypoint at the given pos
     void recalcWaypointData(int pos);
 
@@ -28,6 +28,7 @@
 #include <QDateTime>
 
 #include "logger.h"
+#include "clock.h"
 #include "median.h"
 #include "navcalc.h"
 #include "meanvalue.h"
@@ -75,7 +76,7 @@ protected:
     
     bool m_first_update;
     TYPE m_time_constant;
-    QTime m_update_dt;
+    ClockTimer m_update_dt;
     TYPE m_init_value;
     TYPE m_current_value;
 };
@@ -89,16 +90,17 @@ public:
     ValueWithTimeStamp(const TYPE& value)
     {
         m_value = value;
-        m_dt = QTime::currentTime();
+        m_dt_ms = Clock::current()->msecs();
     }
 
     inline const TYPE& value() const { return m_value; }
-    inline const QTime& dt() const { return m_dt; }
+    //! timestamp in ms of the current clock
+    inline qint64 dtMs() const { return m_dt_ms; }
 
 protected:
 
     TYPE m_value;
-    QTime m_dt;
+    qint64 m_dt_ms;
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -169,16 +171,15 @@ public:
             return newest_value.value();
         }
 
-        QTime wanted_dt = QTime::currentTime().addMSecs(-m_delay_ms);
-        if (newest_value.dt() < wanted_dt) 
+        qint64 now_ms = Clock::current()->msecs();
+        qint64 wanted_dt = now_ms - m_delay_ms;
+        if (newest_value.dtMs() < wanted_dt) 
         {
             if (!m_name.isEmpty())
                 Logger::logToFileOnly(QString("SmoothedValueWithDelay:value(%1): " 
                                               "newest value (%2) < wanted_dt (%3) (cur=%4, del=%5) -> newest value").
-                                      arg(m_name).arg(newest_value.dt().toString("hh:mm:ss:zzz")).
-                                      arg(wanted_dt.toString("hh:mm:ss:zzz")).
-                                      arg(QTime::currentTime().toString("hh:mm:ss:zzz")).
-                                      arg(m_delay_ms));
+                                      arg(m_name).arg(newest_value.dtMs()).arg(wanted_dt).
+                                      arg(now_ms).arg(m_delay_ms));
             return newest_value.value();
         }
 
@@ -187,15 +188,14 @@ public:
         int index = m_value_list.count() - 1;
         MYASSERT(index > 0);
 
-        while(wanted_dt < m_value_list[index].dt())
+        while(wanted_dt < m_value_list[index].dtMs())
         {
             if (index == 0)
             {
                 if (!m_name.isEmpty())
                     Logger::logToFileOnly(QString("SmoothedValueWithDelay:value(%1): "
                                         "wanted_dt (%2) < oldest value (%3) -> newest value").
-                                arg(m_name).arg(wanted_dt.toString("hh:mm:ss:zzz")).
-                                arg(m_value_list[index].dt().toString("hh:mm:ss:zzz")));
+                                arg(m_name).arg(wanted_dt).arg(m_value_list[index].dtMs()));
                 return newest_value.value();
             }
             --index;
@@ -203,7 +203,7 @@ public:
 
         // interpolate value
 
-        int timediff = m_value_list[index].dt().msecsTo(newest_value.dt());
+        int timediff = (int)(newest_value.dtMs() - m_value_list[index].dtMs());
         TYPE per_time_change = 0;
 
         if (timediff > 0) 
@@ -241,11 +241,11 @@ public:
             MYASSERT(trend_per_second == 0);
         }
         
-        double correction_value = per_time_change * m_value_list[index].dt().msecsTo(wanted_dt);
+        int refdtdiff = (int)(wanted_dt - m_value_list[index].dtMs());
+        double correction_value = per_time_change * refdtdiff;
 
         if (m_verbose)
-            Logger::log(QString("refdtdiff=%1 correction=%2").
-                        arg(m_value_list[index].dt().msecsTo(wanted_dt)).arg(correction_value));
+            Logger::log(QString("refdtdiff=%1 correction=%2").arg(refdtdiff).arg(correction_value));
 
         TYPE ret;
         if (m_is_heading) ret= Navcalc::trimHeading(m_value_list[index].value() + correction_value);
@@ -0,0 +1,307 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    smoothing_engine.cpp
+    \author  vasFMC contributors
+*/
+
+#include <limits.h>
+
+#include "smoothing_engine.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+const int SmoothingEngine::NO_VALUE = -1;
+const int SmoothingEngine::PENDING = INT_MAX;
+
+/////////////////////////////////////////////////////////////////////////////
+
+SmoothingEngine::SmoothingEngine(uint delay_ms, uint row_capacity, uint min_row_interval_ms) :
+    m_delay_ms(delay_ms), m_row_capacity(row_capacity), m_min_row_interval_ms(min_row_interval_ms),
+    m_channel_count(0), m_head(0), m_row_count(0), m_output_valid(false), m_output_time_ms(0)
+{
+    MYASSERT(m_row_capacity > 1);
+    m_time_base_ms = Clock::current()->msecs();
+    m_row_time_ms.fill(0, m_row_capacity);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+SmoothingEngine::~SmoothingEngine()
+{
+    qDeleteAll(m_filter);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+int SmoothingEngine::addChannel(bool is_heading, bool is_coordinate)
+{
+    int channel = m_channel_count++;
+
+    m_is_heading.append(is_heading);
+    m_is_coordinate.append(is_coordinate);
+    m_current.append(0.0);
+    m_updated.append(false);
+    m_first_seq.append(NO_VALUE);
+    m_filter.append(0);
+    m_trend_filter.append(0);
+    m_output.append(0.0);
+    m_interpolated.append(false);
+    m_change_per_s.append(0.0);
+    m_trend_output.append(0.0);
+    m_row_values.resize(m_channel_count * m_row_capacity);
+    m_row_update_ms.resize(m_channel_count * m_row_capacity);
+    m_output_valid = false;
+
+    return channel;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SmoothingEngine::setTrendFilter(int channel, uint filter_length)
+{
+    MYASSERT(channel >= 0 && channel < m_channel_count);
+    MYASSERT(m_filter[channel] == 0);
+    m_filter[channel] = new ChannelFilter(filter_length);
+    MYASSERT(m_filter[channel] != 0);
+    m_trend_filter[channel] = m_filter[channel];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SmoothingEngine::setTrendLowPass(int channel, const double& time_constant)
+{
+    MYASSERT(channel >= 0 && channel < m_channel_count);
+    MYASSERT(m_trend_filter[channel] != 0);
+    m_trend_filter[channel]->do_trend_low_pass = true;
+    m_trend_filter[channel]->trend_low_pass.setTimeConstant(time_constant);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SmoothingEngine::setLowPass(int channel, const double& time_constant)
+{
+    MYASSERT(channel >= 0 && channel < m_channel_count);
+    if (m_filter[channel] == 0) m_filter[channel] = new ChannelFilter(1);
+    MYASSERT(m_filter[channel] != 0);
+    m_filter[channel]->do_low_pass = true;
+    m_filter[channel]->low_pass.setTimeConstant(time_constant);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SmoothingEngine::sample()
+{
+    int now_ms = nowMs();
+    int seq;
+    uint prev_head = m_head;
+
+    // values arriving faster than the row interval update the newest row
+    bool new_row = !(m_row_count > 0 && now_ms - m_row_time_ms[m_head] < (int)m_min_row_interval_ms);
+    if (new_row)
+    {
+        if (m_row_count > 0) m_head = (m_head + 1) % m_row_capacity;
+        seq = m_row_count++;
+    }
+    else
+    {
+        seq = m_row_count - 1;
+    }
+
+    m_row_time_ms[m_head] = now_ms;
+
+    double* row_values = m_row_values.data();
+    int* row_update_ms = m_row_update_ms.data();
+    for(int channel=0; channel < m_channel_count; ++channel)
+    {
+        uint offset = channel * m_row_capacity;
+
+        if (m_updated[channel])
+        {
+            row_values[offset + m_head] = m_current[channel];
+            row_update_ms[offset + m_head] = now_ms;
+            m_updated[channel] = false;
+        }
+        else if (new_row)
+        {
+            // not updated -> the row keeps the last update of the channel
+            row_values[offset + m_head] = row_values[offset + prev_head];
+            row_update_ms[offset + m_head] = row_update_ms[offset + prev_head];
+        }
+
+        if (m_first_seq[channel] == PENDING) m_first_seq[channel] = seq;
+    }
+
+    m_output_valid = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SmoothingEngine::update(int now_ms)
+{
+    m_output_valid = true;
+    m_output_time_ms = now_ms;
+    m_interpolated.fill(false);
+
+    if (m_row_count < 1)
+    {
+        for(int channel=0; channel < m_channel_count; ++channel) m_output[channel] = m_current[channel];
+        return;
+    }
+
+    // search the reference row once for all channels
+
+    int wanted_ms = now_ms - m_delay_ms;
+    uint available_rows = qMin(m_row_count, (int)m_row_capacity);
+    uint steps = 0;
+    bool found_reference = m_row_time_ms[m_head] >= wanted_ms;
+
+    if (found_reference)
+    {
+        while(steps < available_rows && wanted_ms < m_row_time_ms[rowIndex(steps)]) ++steps;
+        found_reference = steps < available_rows;
+    }
+
+    const double* values = m_row_values.constData();
+    const int* update_ms = m_row_update_ms.constData();
+
+    if (!found_reference)
+    {
+        // newest row older than the wanted time or history too short -> newest values
+        for(int channel=0; channel < m_channel_count; ++channel)
+            m_output[channel] = (m_first_seq[channel] == NO_VALUE) ? 0.0 : m_current[channel];
+        return;
+    }
+
+    uint ref_index = rowIndex(steps);
+    int ref_seq = m_row_count - 1 - steps;
+
+    // interpolate all channels
+
+    for(int channel=0; channel < m_channel_count; ++channel)
+    {
+        if (m_first_seq[channel] == NO_VALUE)
+        {
+            m_output[channel] = 0.0;
+            continue;
+        }
+
+        if (m_first_seq[channel] > ref_seq)
+        {
+            m_output[channel] = m_current[channel];
+            continue;
+        }
+
+        // interpolate between the last update of the channel up to the
+        // reference row and the newest update of the channel
+        const double* channel_values = values + channel * m_row_capacity;
+        const int* channel_update_ms = update_ms + channel * m_row_capacity;
+        double ref_value = channel_values[ref_index];
+        int timediff = channel_update_ms[m_head] - channel_update_ms[ref_index];
+        int correction_ms = wanted_ms - channel_update_ms[ref_index];
+        double per_time_change = 0.0;
+
+        if (timediff > 0)
+        {
+            double absolut_change = channel_values[m_head] - ref_value;
+
+            if (m_is_heading[channel] || m_is_coordinate[channel])
+            {
+                if (absolut_change > 180.0) absolut_change -= 360.0;
+                else if (absolut_change < - 180.0) absolut_change += 360;
+            }
+
+            per_time_change = absolut_change / timediff;
+        }
+
+        m_output[channel] = ref_value + per_time_change * correction_ms;
+        m_change_per_s[channel] = per_time_change * 1000.0;
+        m_interpolated[channel] = true;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+double SmoothingEngine::filteredValue(int channel, double* trend_per_second)
+{
+    ChannelFilter* filter = m_filter[channel];
+    MYASSERT(filter != 0);
+
+    if (m_trend_filter[channel] != 0)
+    {
+        filter->trend_median.add(m_change_per_s[channel]);
+        filter->trend_median_mean.add(filter->trend_median.median());
+        if (trend_per_second != 0)
+        {
+            m_trend_output[channel] = filter->trend_median_mean.mean();
+            if (filter->do_trend_low_pass)
+                m_trend_output[channel] = filter->trend_low_pass.nextValue(m_trend_output[channel]);
+            *trend_per_second = m_trend_output[channel];
+        }
+    }
+    else
+    {
+        MYASSERT(trend_per_second == 0);
+    }
+
+    if (filter->do_low_pass) return filter->low_pass.nextValue(m_output[channel]);
+    return m_output[channel];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SmoothingEngine::clear()
+{
+    m_head = 0;
+    m_row_count = 0;
+    for(int channel=0; channel < m_channel_count; ++channel) clearChannel(channel);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SmoothingEngine::clearChannel(int channel)
+{
+    MYASSERT(channel >= 0 && channel < m_channel_count);
+
+    m_current[channel] = 0.0;
+    m_updated[channel] = false;
+    m_first_seq[channel] = NO_VALUE;
+    m_output[channel] = 0.0;
+    m_interpolated[channel] = false;
+    m_change_per_s[channel] = 0.0;
+    m_trend_output[channel] = 0.0;
+    resetFilters(channel);
+    m_output_valid = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void SmoothingEngine::resetFilters(int channel)
+{
+    ChannelFilter* filter = m_filter[channel];
+    if (filter == 0) return;
+
+    filter->trend_median.clear();
+    filter->trend_median_mean.clear();
+    filter->trend_low_pass.clear();
+    filter->low_pass.clear();
+}
+
+// End of file
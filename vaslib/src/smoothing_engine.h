@@ -0,0 +1,255 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2026 vasFMC contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/*! \file    smoothing_engine.h
+    \author  vasFMC contributors
+*/
+
+#ifndef SMOOTHING_ENGINE_H
+#define SMOOTHING_ENGINE_H
+
+#include <QVector>
+
+#include "assert.h"
+#include "clock.h"
+#include "median.h"
+#include "meanvalue.h"
+#include "smoothing.h"
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! Multi channel smoothing with delay.
+//! All channels share one ring of sample timestamps, the channel values are
+//! stored channel by channel (one contiguous block per channel). New values
+//! are written with setValue() and committed as one row with sample(). A
+//! single pass in update() searches the reference row for the wanted delay
+//! once and then interpolates (and runs the trend/low pass filters of) every
+//! channel. The output is recalculated lazily when a channel value is read,
+//! the trend and low pass filters of a channel are stepped with each read
+//! of the channel like the ones of SmoothedValueWithDelay.
+//! Each row also keeps the time of the last real update per channel, so a
+//! channel updated at a lower rate than the others is interpolated between
+//! its own updates and not held flat between them.
+class SmoothingEngine
+{
+public:
+
+    //! Standard Constructor
+    SmoothingEngine(uint delay_ms, uint row_capacity = 64, uint min_row_interval_ms = 10);
+
+    //! Destructor
+    virtual ~SmoothingEngine();
+
+    //! adds a new channel and returns its index.
+    int addChannel(bool is_heading, bool is_coordinate);
+
+    //! enables trend calculation for the given channel, the trend is
+    //! filtered by a median and a mean value of the given length.
+    void setTrendFilter(int channel, uint filter_length);
+    //! enables the low pass filter for the trend of the given channel
+    void setTrendLowPass(int channel, const double& time_constant);
+    //! enables the low pass filter for the value of the given channel
+    void setLowPass(int channel, const double& time_constant);
+
+    inline int channelCount() const { return m_channel_count; }
+    inline uint delayMs() const { return m_delay_ms; }
+    inline void setDelayMs(uint delay_ms) { m_delay_ms = delay_ms; m_output_valid = false; }
+
+    //-----
+
+    //! sets the newest raw value of the given channel, it will become part
+    //! of the history with the next call to sample().
+    inline void setValue(int channel, const double& value)
+    {
+        MYASSERT(channel >= 0 && channel < m_channel_count);
+        m_current[channel] = value;
+        m_updated[channel] = true;
+        if (m_first_seq[channel] == NO_VALUE) m_first_seq[channel] = PENDING;
+    }
+
+    //! returns the newest raw value of the given channel
+    inline double lastValue(int channel) const
+    {
+        MYASSERT(channel >= 0 && channel < m_channel_count);
+        return m_current[channel];
+    }
+
+    //! commits the current values of all channels as one row
+    void sample();
+
+    //! returns the smoothed value of the given channel, the trend per second
+    //! will be set when trend_per_second is non-zero.
+    inline double value(int channel, double* trend_per_second = 0)
+    {
+        MYASSERT(channel >= 0 && channel < m_channel_count);
+        refresh();
+        if (m_filter[channel] != 0 && m_interpolated[channel]) return filteredValue(channel, trend_per_second);
+        if (trend_per_second != 0)
+        {
+            MYASSERT(m_trend_filter[channel] != 0);
+            *trend_per_second = m_trend_output[channel];
+        }
+        return m_output[channel];
+    }
+
+    //! recalculates the output of all channels if it is outdated
+    inline void refresh()
+    {
+        int now_ms = nowMs();
+        if (!m_output_valid || now_ms != m_output_time_ms) update(now_ms);
+    }
+
+    //! clears the history of all channels
+    void clear();
+
+    //! clears the history of the given channel
+    void clearChannel(int channel);
+
+protected:
+
+    //! returns the current clock time relative to the construction of the engine
+    inline int nowMs() const { return (int)(Clock::current()->msecs() - m_time_base_ms); }
+
+    //! interpolates all channels for the given time
+    void update(int now_ms);
+
+    //! steps the filters of the given channel with its interpolated value
+    double filteredValue(int channel, double* trend_per_second);
+
+    void resetFilters(int channel);
+
+    //! returns the ring position of the row which is "steps" rows older
+    //! than the newest row.
+    inline uint rowIndex(uint steps) const { return (m_head + m_row_capacity - steps) % m_row_capacity; }
+
+protected:
+
+    //! first sequence number values of channels without any value
+    static const int NO_VALUE;
+    //! first sequence number values of channels with a not yet sampled value
+    static const int PENDING;
+
+    //! per channel filters
+    class ChannelFilter
+    {
+    public:
+        ChannelFilter(uint filter_length) :
+            trend_median(2*filter_length, 0.0), trend_median_mean(2*filter_length, 0.0),
+            do_trend_low_pass(false), trend_low_pass(0.0, 0.0),
+            do_low_pass(false), low_pass(0.0, 0.0)
+        {}
+
+        Median<double> trend_median;
+        MeanValue<double> trend_median_mean;
+        bool do_trend_low_pass;
+        LowPass<double> trend_low_pass;
+        bool do_low_pass;
+        LowPass<double> low_pass;
+    };
+
+    uint m_delay_ms;
+    uint m_row_capacity;
+    uint m_min_row_interval_ms;
+    qint64 m_time_base_ms;
+
+    int m_channel_count;
+    QVector<bool> m_is_heading;
+    QVector<bool> m_is_coordinate;
+    QVector<double> m_current;
+    //! true when the channel was set since the last sample()
+    QVector<bool> m_updated;
+    //! sequence number of the first row containing a value of the channel
+    QVector<int> m_first_seq;
+    QVector<ChannelFilter*> m_filter;
+    //! points to m_filter when the trend is calculated for the channel
+    QVector<ChannelFilter*> m_trend_filter;
+
+    //! shared timestamp ring (ms since m_time_base_ms)
+    QVector<int> m_row_time_ms;
+    //! channel value rings, m_row_capacity values per channel
+    QVector<double> m_row_values;
+    //! time of the last update of the channel up to each row, same layout as m_row_values
+    QVector<int> m_row_update_ms;
+    //! ring position of the newest row
+    uint m_head;
+    //! number of rows committed so far, the newest row has the sequence number m_row_count-1
+    int m_row_count;
+
+    bool m_output_valid;
+    int m_output_time_ms;
+    QVector<double> m_output;
+    //! true when m_output of the channel was interpolated and may be filtered
+    QVector<bool> m_interpolated;
+    //! unfiltered change per second of the interpolation
+    QVector<double> m_change_per_s;
+    QVector<double> m_trend_output;
+
+private:
+    //! Hidden copy-constructor
+    SmoothingEngine(const SmoothingEngine&);
+    //! Hidden assignment operator
+    const SmoothingEngine& operator = (const SmoothingEngine&);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+//! handle to a single channel of a smoothing engine, provides the same
+//! accessors as SmoothedValueWithDelay.
+class SmoothedChannel
+{
+public:
+
+    SmoothedChannel() : m_engine(0), m_channel(-1) {}
+    SmoothedChannel(SmoothingEngine* engine, bool is_heading, bool is_coordinate) :
+        m_engine(engine), m_channel(engine->addChannel(is_heading, is_coordinate)) {}
+
+    inline void attach(SmoothingEngine* engine, int channel) { m_engine = engine; m_channel = channel; }
+    inline bool isAttached() const { return m_engine != 0; }
+    inline int channel() const { return m_channel; }
+
+    inline double value(double* trend_per_second = 0) const
+    {
+        if (m_engine == 0) return 0.0;
+        return m_engine->value(m_channel, trend_per_second);
+    }
+
+    inline double lastValue() const
+    {
+        if (m_engine == 0) return 0.0;
+        return m_engine->lastValue(m_channel);
+    }
+
+    inline void operator=(const double& value)
+    {
+        MYASSERT(m_engine != 0);
+        m_engine->setValue(m_channel, value);
+    }
+
+    inline void clear() { if (m_engine != 0) m_engine->clearChannel(m_channel); }
+
+protected:
+
+    SmoothingEngine* m_engine;
+    int m_channel;
+};
+
+#endif /* SMOOTHING_ENGINE_H */
+
+// End of file
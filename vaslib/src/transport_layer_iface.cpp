@@ -24,7 +24,9 @@
 
 #include <QByteArray>
 #include <QDataStream>
+#include <QtEndian>
 
+#include "crc32c.h"
 #include "transport_layer_iface.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -79,20 +81,24 @@ QString TransportLayerIface::getSocketErrorText(QAbstractSocket::SocketError err
 
 /////////////////////////////////////////////////////////////////////////////
 
-void TransportLayerIface::enframeData(qint16 data_type, const QByteArray& data, QByteArray& enframed_data)
+void TransportLayerIface::enframeData(qint16 data_type, const QByteArray& data, QByteArray& enframed_data,
+                                      int frame_version)
 {
     enframed_data.clear();
     QDataStream write_stream(&enframed_data, QIODevice::WriteOnly);
 
-    qint32 overall_length = data.count() + sizeof(qint32)*2 + sizeof(qint16)*2;
-    qint16 checksum = qChecksum(data.data(), data.count());
+    bool crc32c = frame_version >= TRANSPORT_FRAME_VERSION_CRC32C;
+    qint32 overall_length = data.count() + sizeof(qint32)*2 + sizeof(qint16) + 
+                            (crc32c ? sizeof(quint32) : sizeof(qint16));
 
     write_stream << (qint32) overall_length
                  << data_type 
                  << (qint32) data.count();
 
     write_stream.writeRawData(data.data(), data.count());
-    write_stream << (qint16) checksum;
+
+    if (crc32c) write_stream << (quint32) Crc32c::checksum(data.data(), data.count());
+    else        write_stream << (qint16) qChecksum(data.data(), data.count());
 
     MYASSERT(enframed_data.count() == overall_length);
 
@@ -103,64 +109,135 @@ void TransportLayerIface::enframeData(qint16 data_type, const QByteArray& data,
 
 /////////////////////////////////////////////////////////////////////////////
 
-bool TransportLayerIface::deframeReceivedData(QByteArray& data,
-                                              qint16& data_type,
-                                              QByteArray& deframed_data)
+void TransportLayerIface::enframeFrameVersion(QByteArray& enframed_data)
 {
-    deframed_data.clear();
-    if (data.count() < (int)sizeof(qint32)) 
-    {
-//         qDebug("TransportLayerIface:deframeReceivedData: "
-//                "data count (%d) too small to read overall length",
-//                data.count());
-        return false;
-    }
+    QByteArray data;
+    QDataStream write_stream(&data, QIODevice::WriteOnly);
+    write_stream << (qint16) TRANSPORT_FRAME_VERSION;
+    enframeData(TRANSPORT_DATA_TYPE_FRAME_VERSION, data, enframed_data, TRANSPORT_FRAME_VERSION_CRC16);
+}
 
-    QDataStream read_stream(data);
+/////////////////////////////////////////////////////////////////////////////
 
-    qint32 overall_length;
-    read_stream >> overall_length;
+void TransportLayerReceiveBuffer::readFrom(QIODevice* device)
+{
+    MYASSERT(device != 0);
 
-    if (data.count() < overall_length) 
+    // only a partial frame is left behind the read position, if anything
+    if (m_read_pos > 0)
     {
-//         qDebug("TransportLayerIface:deframeReceivedData: "
-//                "data count (%d) < awaited overall length (%d)",
-//                data.count(), overall_length);
-        return false;
+        m_buffer.remove(0, m_read_pos);
+        m_read_pos = 0;
     }
 
-//     qDebug("TransportLayerIface:deframeReceivedData: got %d bytes, awaited %d", 
-//            data.count(), overall_length);
-    
-    qint32 data_length;
-    read_stream >> data_type >> data_length;
+    qint64 available = device->bytesAvailable();
+    if (available <= 0) return;
 
-    deframed_data.resize(data_length);
-    int read_bytes = read_stream.readRawData(deframed_data.data(), data_length);
-    MYASSERT(read_bytes == data_length);
-    MYASSERT(deframed_data.count() == data_length);
-    qint16 our_checksum = qChecksum(deframed_data.data(), deframed_data.count());
+    int old_count = m_buffer.count();
+    m_buffer.resize(old_count + available);
+    qint64 read_bytes = device->read(m_buffer.data() + old_count, available);
+    m_buffer.resize(old_count + qMax(read_bytes, (qint64)0));
+}
 
-    qint16 received_checksum;
-    read_stream >> received_checksum;
+/////////////////////////////////////////////////////////////////////////////
 
-    data.remove(0, overall_length);
+void TransportLayerReceiveBuffer::clear()
+{
+    m_buffer.clear();
+    m_read_pos = 0;
+}
 
-    if (our_checksum  != received_checksum)
-    {
-        qCritical("TransportLayerIface:deframeReceivedData: "
-                  "Checksum error (overall len: %d, data len:%d): our (%d) != received(%d)",
-                  overall_length, data_length, our_checksum, received_checksum);
+/////////////////////////////////////////////////////////////////////////////
+
+void TransportLayerReceiveBuffer::reset()
+{
+    clear();
+    m_peer_frame_version = TRANSPORT_FRAME_VERSION_CRC16;
+}
+
+/////////////////////////////////////////////////////////////////////////////
 
-        deframed_data.clear();
-        return false;
+bool TransportLayerReceiveBuffer::deframe(qint16& data_type, QByteArray& deframed_data)
+{
+    static const int header_length = sizeof(qint32)*2 + sizeof(qint16);
+    static const int frame_overhead = header_length + sizeof(qint16);
+    static const int crc32c_frame_overhead = header_length + sizeof(quint32);
+
+    deframed_data.clear();
+
+    while (pendingBytes() >= (int)sizeof(qint32))
+    {
+        const uchar* frame = (const uchar*)m_buffer.constData() + m_read_pos;
+
+        qint32 overall_length = (qint32)qFromBigEndian<quint32>(frame);
+        if (overall_length < frame_overhead)
+        {
+            qCritical("TransportLayerReceiveBuffer:deframe: "
+                      "invalid frame length %d - dropping %d bytes", overall_length, pendingBytes());
+            clear();
+            return false;
+        }
+
+        if (pendingBytes() < overall_length) 
+        {
+//             qDebug("TransportLayerReceiveBuffer:deframe: "
+//                    "data count (%d) < awaited overall length (%d)",
+//                    pendingBytes(), overall_length);
+            return false;
+        }
+
+        m_read_pos += overall_length;
+
+        data_type = (qint16)qFromBigEndian<quint16>(frame + sizeof(qint32));
+        qint32 data_length = (qint32)qFromBigEndian<quint32>(frame + sizeof(qint32) + sizeof(qint16));
+        const char* payload = (const char*)frame + header_length;
+        const uchar* checksum = frame + header_length + data_length;
+
+        quint32 our_checksum = 0;
+        quint32 received_checksum = 0;
+
+        if (data_length == overall_length - frame_overhead)
+        {
+            our_checksum = qChecksum(payload, data_length);
+            received_checksum = qFromBigEndian<quint16>(checksum);
+        }
+        else if (data_length == overall_length - crc32c_frame_overhead)
+        {
+            our_checksum = Crc32c::checksum(payload, data_length);
+            received_checksum = qFromBigEndian<quint32>(checksum);
+        }
+        else
+        {
+            qCritical("TransportLayerReceiveBuffer:deframe: "
+                      "data length %d does not match overall length %d - skipping frame",
+                      data_length, overall_length);
+            continue;
+        }
+
+        if (our_checksum != received_checksum)
+        {
+            qCritical("TransportLayerReceiveBuffer:deframe: "
+                      "Checksum error (overall len: %d, data len:%d): our (%u) != received(%u)",
+                      overall_length, data_length, our_checksum, received_checksum);
+            continue;
+        }
+
+        if (data_type == TRANSPORT_DATA_TYPE_FRAME_VERSION)
+        {
+            if (data_length >= (int)sizeof(qint16))
+            {
+                qint16 peer_version = (qint16)qFromBigEndian<quint16>((const uchar*)payload);
+                m_peer_frame_version = qMax(TRANSPORT_FRAME_VERSION_CRC16, 
+                                            qMin((int)peer_version, TRANSPORT_FRAME_VERSION));
+            }
+            continue;
+        }
+
+        deframed_data = QByteArray::fromRawData(payload, data_length);
+        return true;
     }
-    
-//     qDebug("TransportLayerIface:deframeReceivedData: "
-//            "received real data (%d), overall (%d)",
-//            deframed_data.count(), overall_length);
 
-    return true;
+    return false;
 }
 
 /////////////////////////////////////////////////////////////////////////////
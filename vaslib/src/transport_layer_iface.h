@@ -27,12 +27,26 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QIODevice>
 #include <QAbstractSocket>
 
 #include "assert.h"
 
 //#include "serialization_layer_iface.h"
 
+//! frames of version 1 end with a CRC-16 (qChecksum), frames of version 2
+//! with a CRC-32C (see Crc32c). The receiver tells them apart by their length.
+#define TRANSPORT_FRAME_VERSION_CRC16 1
+#define TRANSPORT_FRAME_VERSION_CRC32C 2
+
+//! the highest frame version we read, announced to the peer on connect.
+//! We send the highest version both sides announced.
+#define TRANSPORT_FRAME_VERSION TRANSPORT_FRAME_VERSION_CRC32C
+
+//! data type of the frame announcing the frame version, it is always sent
+//! as version 1 and never passed on by the receive buffer
+#define TRANSPORT_DATA_TYPE_FRAME_VERSION -1
+
 //! raw transport layer
 /*! more details ...
  */
@@ -64,19 +78,19 @@ public:
     //! returns a the error text of the given socket error
     static QString getSocketErrorText(QAbstractSocket::SocketError error);
 
-    //! adds a frame to the data and returns the framed data in "enframed_data".
-    static void enframeData(qint16 data_type, const QByteArray& data, QByteArray& enframed_data);
+    //! adds a frame of the given version to the data and returns the framed
+    //! data in "enframed_data".
+    static void enframeData(qint16 data_type, const QByteArray& data, QByteArray& enframed_data,
+                            int frame_version = TRANSPORT_FRAME_VERSION_CRC16);
+
+    //! returns the frame announcing our TRANSPORT_FRAME_VERSION in "enframed_data".
+    static void enframeFrameVersion(QByteArray& enframed_data);
 
-    //! tries to decode a frame from the data. Returnes true if a frame was
-    //! decoded successfully and returns the deframed data in "deframed_data".
-    //! Returns false on error.
-    static bool deframeReceivedData(QByteArray& data, 
-                                    qint16& data_type, 
-                                    QByteArray& deframed_data);
-    
 signals:
 
-    //! emitted when new data were received
+    //! emitted when new data were received. The data references the
+    //! receive buffer (see TransportLayerReceiveBuffer) and must be copied
+    //! when it is kept beyond the slot.
     void signalDataReceived(qint16 data_type, QByteArray& receive_buffer);
 
     void signalConnected();
@@ -90,6 +104,57 @@ private:
     const TransportLayerIface& operator = (const TransportLayerIface&);
 };
 
+/////////////////////////////////////////////////////////////////////////////
+
+//! Receive buffer of a connection which deframes the frames of
+//! TransportLayerIface::enframeData() in place. Deframed frames only
+//! advance the read position and the payload is handed out as a view into
+//! the buffer, the consumed bytes are dropped once before new data is
+//! read. So a burst of frames costs O(n) instead of moving the rest of the
+//! buffer for every frame.
+class TransportLayerReceiveBuffer
+{
+public:
+
+    //! Standard Constructor
+    TransportLayerReceiveBuffer() : m_read_pos(0), m_peer_frame_version(TRANSPORT_FRAME_VERSION_CRC16) {};
+
+    //! drops the deframed frames and appends all data available on the given
+    //! device. Invalidates the views returned by deframe() before.
+    void readFrom(QIODevice* device);
+
+    //! drops all data
+    void clear();
+
+    //! drops all data and forgets the frame version of the peer, called for a new connection
+    void reset();
+
+    //! tries to decode the next frame. Returns true if a frame was decoded
+    //! and returns its data in "deframed_data", which references the buffer
+    //! and stays valid until the next readFrom() or clear(). Frames with
+    //! checksum errors are skipped. Returns false if no complete frame is left.
+    bool deframe(qint16& data_type, QByteArray& deframed_data);
+
+    //! returns the number of bytes not deframed yet
+    inline int pendingBytes() const { return m_buffer.count() - m_read_pos; }
+
+    //! returns the frame version to send to the peer, version 1 until the
+    //! peer announced a higher one
+    inline int peerFrameVersion() const { return m_peer_frame_version; }
+
+protected:
+
+    QByteArray m_buffer;
+    int m_read_pos;
+    int m_peer_frame_version;
+
+private:
+    //! Hidden copy-constructor
+    TransportLayerReceiveBuffer(const TransportLayerReceiveBuffer&);
+    //! Hidden assignment operator
+    const TransportLayerReceiveBuffer& operator = (const TransportLayerReceiveBuffer&);
+};
+
 #endif /* __TRANSPORT_LAYER_IFACE_H__ */
 
 // End of file
@@ -63,7 +63,7 @@ void TransportLayerTCPClient::connectToHost(const QString& host, qint16 port)
     qDebug("TransportLayerTCPClient:connectToHost: (%s:%d):", host.toLatin1().data(), port);
 
     m_forced_disconnect = false;
-    m_receive_buffer.clear();
+    m_receive_buffer.reset();
 
     m_tcp_socket->connectToHost(m_host, m_port);
 }
@@ -92,6 +92,13 @@ void TransportLayerTCPClient::disconnectFromHost(bool forced)
 void TransportLayerTCPClient::slotConnected()
 {
     //qDebug("TransportLayerTCPClient:slotConnected");
+
+    // frames of the former connection are dropped, the server learns our frame version
+    m_receive_buffer.reset();
+    QByteArray framed_data;
+    enframeFrameVersion(framed_data);
+    m_tcp_socket->write(framed_data);
+
     emit signalConnected();
     m_forced_disconnect = false;
 }
@@ -128,15 +135,15 @@ void TransportLayerTCPClient::slotError(QAbstractSocket::SocketError error)
 
 void TransportLayerTCPClient::slotDataReceived()
 {
-    m_receive_buffer.append(m_tcp_socket->readAll());
+    m_receive_buffer.readFrom(m_tcp_socket);
     qint16 data_type = 0;
     QByteArray deframed_data;
-    while (deframeReceivedData(m_receive_buffer, data_type, deframed_data))
+    while (m_receive_buffer.deframe(data_type, deframed_data))
     {
         emit signalDataReceived(data_type, deframed_data);
     
 //         qDebug("TransportLayerTCPClient:slotDataReceived:"
-//                "reveive buffer size: %d", m_receive_buffer.count());
+//                "reveive buffer size: %d", m_receive_buffer.pendingBytes());
     }
 }
 
@@ -147,7 +154,7 @@ bool TransportLayerTCPClient::sendData(qint16 data_type, const QByteArray& data)
     if (!isConnected()) return false;
 
     QByteArray framed_data;
-    enframeData(data_type, data, framed_data);
+    enframeData(data_type, data, framed_data, m_receive_buffer.peerFrameVersion());
     qint64 bytes_written = m_tcp_socket->write(framed_data);
                                       
     if (bytes_written < 0 || bytes_written != framed_data.count())
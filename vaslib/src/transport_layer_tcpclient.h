@@ -80,7 +80,7 @@ protected:
 
     QTimer m_reconnect_timer;
 
-    QByteArray m_receive_buffer;
+    TransportLayerReceiveBuffer m_receive_buffer;
 
 private:
     //! Hidden copy-constructor
@@ -86,9 +86,6 @@ void TransportLayerTCPServer::slotIncomingConnection()
         MYASSERT(connect(client_buffer, SIGNAL(signalDataReceived(qint16, QByteArray&)),
                          this, SIGNAL(signalDataReceived(qint16, QByteArray&))));
 
-        MYASSERT(connect(this, SIGNAL(signalSendData(qint16, const QByteArray&)),
-                         client_buffer, SLOT(slotSendData(qint16, const QByteArray&))));
-
         m_client_buffer_hash.insert(client_socket, client_buffer);
 
 //         qDebug("TransportLayerTCPServerClientBuffer:slotIncomingConnection: "
@@ -117,8 +114,25 @@ void TransportLayerTCPServer::slotClientDisconnected(QTcpSocket* socket)
 
 bool TransportLayerTCPServer::sendData(qint16 data_type, const QByteArray& data)
 {
-    emit signalSendData(data_type, data);
-    return data.count();
+    // the data is framed once for every frame version the clients read
+    QByteArray framed_data[TRANSPORT_FRAME_VERSION + 1];
+
+    // evicted clients remove themselves from the hash, so we iterate over a copy
+    bool sent = false;
+    QHashIterator<QTcpSocket*, TransportLayerTCPServerClientBuffer*> iter(m_client_buffer_hash);
+    while (iter.hasNext()) 
+    {
+        iter.next();
+
+        int frame_version = iter.value()->peerFrameVersion();
+        MYASSERT(frame_version <= TRANSPORT_FRAME_VERSION);
+        if (framed_data[frame_version].isEmpty())
+            TransportLayerIface::enframeData(data_type, data, framed_data[frame_version], frame_version);
+
+        if (iter.value()->queueFrame(framed_data[frame_version])) sent = true;
+    }
+
+    return sent;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -59,7 +59,8 @@ public:
     //! Returns true if connected and ready, false otherwise.
     virtual bool isConnected() const { return m_tcp_server->isListening(); }
 
-    //! sends the given data, returns the true on success, false otherwise.
+    //! frames the given data once and queues it to all clients, returns
+    //! false if no client took it. Clients which do not keep up are evicted.
     virtual bool sendData(qint16 data_type, const QByteArray& data);
 
     //! returns the number of connected clients
@@ -69,8 +70,6 @@ signals:
 
     void signalClientConnected();
 
-    void signalSendData(qint16 data_type, const QByteArray& data);
-
 protected slots:
 
     //! called for connecing clients
@@ -29,11 +29,17 @@
 
 TransportLayerTCPServerClientBuffer::TransportLayerTCPServerClientBuffer(
     QObject* parent, QTcpSocket* socket) :
-    QObject(parent), m_tcp_socket(socket)
+    QObject(parent), m_tcp_socket(socket), m_queued_bytes(0), m_evicted(false)
 {
     MYASSERT(m_tcp_socket);
     MYASSERT(connect(m_tcp_socket, SIGNAL(readyRead()), this, SLOT(slotDataReceived())));
     MYASSERT(connect(socket, SIGNAL(disconnected()), this, SLOT(slotDisconnected())));
+    MYASSERT(connect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(slotBytesWritten(qint64))));
+    m_progress_timer.start();
+
+    QByteArray framed_data;
+    TransportLayerIface::enframeFrameVersion(framed_data);
+    queueFrame(framed_data);
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -47,15 +53,15 @@ TransportLayerTCPServerClientBuffer::~TransportLayerTCPServerClientBuffer()
 
 void TransportLayerTCPServerClientBuffer::slotDataReceived()
 {
-    m_receive_buffer.append(m_tcp_socket->readAll());
+    m_receive_buffer.readFrom(m_tcp_socket);
     qint16 data_type = 0;
     QByteArray deframed_data;
-    while (TransportLayerIface::deframeReceivedData(m_receive_buffer, data_type, deframed_data)) 
+    while (m_receive_buffer.deframe(data_type, deframed_data)) 
     {
         emit signalDataReceived(data_type, deframed_data);
 
 //         qDebug("TransportLayerTCPServerClientBuffer:slotDataReceived:"
-//                "reveive buffer size: %d", m_receive_buffer.count());
+//                "reveive buffer size: %d", m_receive_buffer.pendingBytes());
     }
 }
 
@@ -68,21 +74,85 @@ void TransportLayerTCPServerClientBuffer::slotDisconnected()
 
 /////////////////////////////////////////////////////////////////////////////
 
-void TransportLayerTCPServerClientBuffer::slotSendData(qint16 data_type, const QByteArray& data)
+bool TransportLayerTCPServerClientBuffer::queueFrame(const QByteArray& framed_data)
 {
-    QByteArray framed_data;
-    TransportLayerIface::enframeData(data_type, data, framed_data);
-    qint64 bytes_written = m_tcp_socket->write(framed_data);
+    if (m_evicted) return false;
+
+    if (m_queued_bytes + framed_data.count() > TCP_CLIENT_QUEUE_MAX_BYTES)
+    {
+        evict("send queue full");
+        return false;
+    }
 
-    if (bytes_written < 0 || bytes_written != framed_data.count())
+    if (isBacklogged())
+    {
+        if (m_progress_timer.elapsed() > TCP_CLIENT_STALL_MS)
+        {
+            evict("client stalled");
+            return false;
+        }
+    }
+    else
     {
-        qCritical("TransportLayerTCPServerClientBuffer:slotSendData: "
-                  "Could not write data to client %s:%d",
-                  m_tcp_socket->peerName().toLatin1().data(),
-                  m_tcp_socket->peerPort());
+        m_progress_timer.start();
+    }
+
+    // the frame is shared with the queues of the other clients
+    m_send_queue.enqueue(framed_data);
+    m_queued_bytes += framed_data.count();
+
+    writeQueuedFrames();
+    return !m_evicted;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void TransportLayerTCPServerClientBuffer::slotBytesWritten(qint64)
+{
+    m_progress_timer.start();
+    writeQueuedFrames();
+}
+
+/////////////////////////////////////////////////////////////////////////////
 
-        emit signalClientDisconnected(m_tcp_socket);
+void TransportLayerTCPServerClientBuffer::writeQueuedFrames()
+{
+    while (!m_evicted && !m_send_queue.isEmpty() &&
+           m_tcp_socket->bytesToWrite() < TCP_CLIENT_SOCKET_BUFFER_BYTES)
+    {
+        QByteArray framed_data = m_send_queue.dequeue();
+        m_queued_bytes -= framed_data.count();
+
+        qint64 bytes_written = m_tcp_socket->write(framed_data);
+        if (bytes_written < 0 || bytes_written != framed_data.count())
+        {
+            qCritical("TransportLayerTCPServerClientBuffer:writeQueuedFrames: "
+                      "Could not write data to client %s:%d",
+                      m_tcp_socket->peerName().toLatin1().data(),
+                      m_tcp_socket->peerPort());
+
+            evict("write failed");
+        }
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+void TransportLayerTCPServerClientBuffer::evict(const char* reason)
+{
+    qCritical("TransportLayerTCPServerClientBuffer:evict: "
+              "Disconnecting client %s:%d (%s), %d bytes queued",
+              m_tcp_socket->peerName().toLatin1().data(),
+              m_tcp_socket->peerPort(), reason, m_queued_bytes);
+
+    m_evicted = true;
+    m_send_queue.clear();
+    m_queued_bytes = 0;
+
+    m_tcp_socket->abort();
+    emit signalClientDisconnected(m_tcp_socket);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 // End of file
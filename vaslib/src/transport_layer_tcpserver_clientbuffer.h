@@ -28,9 +28,26 @@
 #include <QByteArray>
 #include <QTcpSocket>
 #include <QObject>
+#include <QQueue>
+
+#include "clock.h"
+#include "transport_layer_iface.h"
+
+//! frames are only handed to the socket while it buffers less than that
+#define TCP_CLIENT_SOCKET_BUFFER_BYTES (64*1024)
+
+//! a client with more frames queued is evicted
+#define TCP_CLIENT_QUEUE_MAX_BYTES (1024*1024)
+
+//! a client which did not take any data for that long is evicted
+#define TCP_CLIENT_STALL_MS 10000
 
 /////////////////////////////////////////////////////////////////////////////
 
+//! Connection of the TCP server to one client. The frames sent to all
+//! clients are framed once, the queue of each client only holds references
+//! to them. A client which does not keep up is disconnected before its
+//! queue grows beyond TCP_CLIENT_QUEUE_MAX_BYTES.
 class TransportLayerTCPServerClientBuffer : public QObject
 {
     Q_OBJECT
@@ -41,6 +58,16 @@ public:
 
     virtual ~TransportLayerTCPServerClientBuffer();
 
+    //! queues the given framed data for sending, returns false if the
+    //! client was evicted
+    bool queueFrame(const QByteArray& framed_data);
+
+    //! returns the number of bytes queued and not yet handed to the socket
+    inline int queuedBytes() const { return m_queued_bytes; }
+
+    //! returns the frame version the client reads
+    inline int peerFrameVersion() const { return m_receive_buffer.peerFrameVersion(); }
+
 signals:
 
     void signalDataReceived(qint16 data_type, QByteArray& data);
@@ -50,12 +77,30 @@ public slots:
 
     void slotDataReceived();
     void slotDisconnected();
-    void slotSendData(qint16 data_type, const QByteArray& data);
+    void slotBytesWritten(qint64 bytes);
+
+protected:
+
+    //! hands queued frames to the socket until its buffer is full
+    void writeQueuedFrames();
+
+    //! returns true while data waits to be sent
+    bool isBacklogged() const { return !m_send_queue.isEmpty() || m_tcp_socket->bytesToWrite() > 0; }
+
+    //! drops the queue and disconnects the client
+    void evict(const char* reason);
 
 protected:
 
     QTcpSocket* m_tcp_socket;
-    QByteArray m_receive_buffer;
+    TransportLayerReceiveBuffer m_receive_buffer;
+
+    QQueue<QByteArray> m_send_queue;
+    int m_queued_bytes;
+    bool m_evicted;
+
+    //! restarted whenever the client took data
+    ClockTimer m_progress_timer;
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -25,9 +25,8 @@
 #ifndef TREND_H
 #define TREND_H
 
-#include <QTime>
-
 #include "logger.h"
+#include "clock.h"
 
 /////////////////////////////////////////////////////////////////////////////
 
@@ -66,7 +65,7 @@ protected:
 
     bool m_init;
     TYPE m_last_value;
-    QTime m_last_value_dt;
+    ClockTimer m_last_value_dt;
     TYPE m_last_trend;
 };
 
@@ -77,14 +77,17 @@ withfgfs {
 HEADERS += \
     ptrlist.h \
     assert.h \
+    clock.h \
     config.h \
     configwidget.h \
     logger.h \
     meanvalue.h \
+    metrics.h \
     median.h \
     pushbutton.h \
     mouse_input_area.h \
     smoothing.h \
+    smoothing_engine.h \
     waypoint.h \
     waypoint_hdg_to_alt.h \
     waypoint_hdg_to_intercept.h \
@@ -118,6 +121,8 @@ HEADERS += \
     transport_layer_tcpclient.h \
     transport_layer_tcpserver.h \ 
     transport_layer_tcpserver_clientbuffer.h \
+    delta_sync.h \
+    crc32c.h \
 #    serialization_layer_iface.h \
 #    serialization_layer_plain.h \
     containerfactory.h \
@@ -146,21 +151,33 @@ HEADERS += \
 
 # Disable X-Plane access in gauge
 !gauge {
-    SOURCES += fsaccess_xplane.cpp
+    SOURCES += \
+        fsaccess_xplane.cpp \
+        fsaccess_xplane_replay.cpp \
+        fsaccess_xplane_receiver.cpp \
+        fsaccess_xplane_shm_receiver.cpp \
+        datagram_recorder.cpp
     HEADERS += \
         fsaccess_xplane_defines.h \
         fsaccess_xplane.h \
+        fsaccess_xplane_replay.h \
+        fsaccess_xplane_receiver.h \
+        fsaccess_xplane_shm_receiver.h \
+        datagram_recorder.h \
         canas.h
 }
 
 SOURCES += \
     assert.cpp \
+    clock.cpp \
     config.cpp \
     configwidget.cpp \
     logger.cpp \
+    metrics.cpp \
     pushbutton.cpp \
     mouse_input_area.cpp \
     smoothing.cpp \
+    smoothing_engine.cpp \
     waypoint.cpp \
     airport.cpp \
     runway.cpp \
@@ -190,6 +207,8 @@ SOURCES += \
     transport_layer_tcpclient.cpp \
     transport_layer_tcpserver.cpp \ 
     transport_layer_tcpserver_clientbuffer.cpp \
+    delta_sync.cpp \
+    crc32c.cpp \
 #    serialization_layer_iface.cpp \
 #    serialization_layer_plain.cpp \
     containerfactory.cpp \
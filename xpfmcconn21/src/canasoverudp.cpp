@@ -67,9 +67,8 @@ unsigned char getUCharFromCan(can_t can, uint8_t position = 0)
     return can.msg.aero.data.uChar[position];
 }
 
-int CanASOverUDP::sendRequest(uint8_t service_code)
+static void initRequest(can_t& request, uint8_t service_code)
 {
-    can_t request;
     request.id = htonl(NSH_CH0_REQ);
     request.dlc = 4;
     request.id_is_29 = PLUGIN_USES_ID29;
@@ -77,25 +76,64 @@ int CanASOverUDP::sendRequest(uint8_t service_code)
     request.msg.aero.dataType = AS_NODATA;
     request.msg.aero.serviceCode = service_code;
     request.msg.aero.messageCode = 0;
+}
 
+int CanASOverUDP::sendRequest(uint8_t service_code)
+{
+    can_t request;
+    initRequest(request, service_code);
     return writeSock->write(&request,sizeof(can_t));
 }
 
+int CanASOverUDP::sendRequest(uint8_t service_code, const SubscriberList::Subscriber& subscriber)
+{
+    can_t request;
+    initRequest(request, service_code);
+    // node services always go over UDP, also to the reader of the shared memory ring
+    struct sockaddr_in address = subscriber.address;
+    address.sin_port = htons(writeSock->port());
+    return writeSock->writeTo(&request, sizeof(can_t), &address, 1);
+}
+
+void CanASOverUDP::keepSubscribersAlive(double secs)
+{
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; i++)
+    {
+        SubscriberList::Subscriber& subscriber = m_subscribers.at(i);
+        if (subscriber.last_heard + SUBSCRIBER_KEEPALIVE_SECS < secs &&
+            subscriber.last_keepalive + SUBSCRIBER_KEEPALIVE_RETRY_SECS < secs)
+        {
+            sendRequest(STS, subscriber);
+            subscriber.last_keepalive = secs;
+        }
+    }
+}
+
 CanASOverUDP::CanASOverUDP(std::ostream& logfile):
         LogicHandler(logfile),
         messageCode(0),
         readSock(new UDPReadSocket()),
         writeSock(new UDPWriteSocket()),
+        m_ring_destinations(false),
         configured(false),
         m_logfile(logfile),
         m_enabled(true)
 {
-    casprotocol = new Casprotocol(m_logfile, writeSock, PLUGIN_NODE_ID, PLUGIN_USES_ID29);
+    sharedMemory = new SharedMemoryWriter(writeSock);
+    casprotocol = new Casprotocol(m_logfile, sharedMemory, PLUGIN_NODE_ID, PLUGIN_USES_ID29);
+    stateVector = new StateVectorWriter();
+    m_destinations.reserve(MAX_SUBSCRIBERS);
+    m_state_vector_destinations.reserve(MAX_SUBSCRIBERS);
+    m_failed_destinations.reserve(MAX_SUBSCRIBERS);
 }
 
 CanASOverUDP::~CanASOverUDP()
 {
     m_logfile << "Calling destructor of CanASOverUDP " << configured << m_enabled;
+    delete stateVector;
+    stateVector = 0;
+    delete sharedMemory;
+    sharedMemory = 0;
     if(readSock) {
         delete readSock;
         readSock = 0;
@@ -113,6 +151,7 @@ bool CanASOverUDP::configure() {
 
     readSock->configure(CFG_HOSTADDRESS_DEFAULT,
                         CFG_PORT_TO_SIM_DEFAULT);
+    sharedMemory->open();
     configured = true;
     return true;
 }
@@ -121,7 +160,7 @@ bool CanASOverUDP::processOutput(DataContainer<int>& intData, DataContainer<floa
                             DataContainer<double>& doubleData, DataContainer<bool>& boolData,
                             DataContainer<std::vector<float> >& floatvectorData,
                             DataContainer<std::vector<int> >& ,
-                            DataContainer<std::string>& stringData, std::vector<LogicHandler*> vct,
+                            DataContainer<std::string>& stringData, const std::vector<LogicHandler*>& vct,
                             int ticks, double secs, unsigned int maxDataItems)
 {
     if (m_enabled) {
@@ -139,9 +178,106 @@ bool CanASOverUDP::processOutput(DataContainer<int>& intData, DataContainer<floa
     return true;
 }
 
-void CanASOverUDP::flush(unsigned int maxDataItems)
+unsigned int CanASOverUDP::flush(unsigned int maxDataItems)
 {
-    casprotocol->writeMax(maxDataItems);
+    return casprotocol->writeMax(maxDataItems);
+}
+
+void CanASOverUDP::writeStateVector(DataContainer<double>& doubleData, DataContainer<float>& floatData, double secs)
+{
+    if (!m_enabled || !stateVector->enabled())
+        return;
+
+    // each subscriber gets the state vectors at its own rate, but all get the keyframes
+    bool keyframe = stateVector->keyframeDue(secs);
+    bool ring = false;
+    m_state_vector_destinations.clear();
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; i++)
+    {
+        SubscriberList::Subscriber& subscriber = m_subscribers.at(i);
+        if (!keyframe && secs - subscriber.last_state_vector < subscriber.state_vector_interval)
+            continue;
+        subscriber.last_state_vector = secs;
+        if (subscriber.shared_memory && sharedMemory->active())
+        {
+            ring = true;
+            continue;
+        }
+        struct sockaddr_in address = subscriber.address;
+        address.sin_port = htons(writeSock->port());
+        bool known = false;
+        for (unsigned int j = 0 ; j < m_state_vector_destinations.size() ; j++)
+            if (m_state_vector_destinations[j].sin_addr.s_addr == address.sin_addr.s_addr)
+                known = true;
+        if (!known)
+            m_state_vector_destinations.push_back(address);
+    }
+    if (!ring && m_state_vector_destinations.empty())
+        return;
+
+    // serialise once, then only the destinations differ
+    size_t size = stateVector->build(secs, doubleData.valueAtId(LAT), doubleData.valueAtId(LON), doubleData.valueAtId(TALT),
+                                     floatData.valueAtId(THDG), floatData.valueAtId(PITCH), floatData.valueAtId(BANK));
+    if (ring)
+        sharedMemory->writeRing(stateVector->datagram(), size);
+    if (m_state_vector_destinations.empty())
+        return;
+    if (writeSock->isMulticast())
+        writeSock->write(stateVector->datagram(), size);
+    else
+        writeSock->writeTo(stateVector->datagram(), size, &m_state_vector_destinations[0], m_state_vector_destinations.size());
+}
+
+void CanASOverUDP::updateModes(DataContainer<double>& doubleData, DataContainer<float>& floatData)
+{
+    bool batched = m_subscribers.allBatched();
+    if (casprotocol->batchedFrames() != batched)
+    {
+        casprotocol->setBatchedFrames(batched);
+        m_logfile << (batched ? "Switching to batched frames" : "Switching to single messages") << std::endl;
+    }
+    bool state_vectors = m_subscribers.allStateVectors();
+    if (stateVector->enabled() != state_vectors)
+    {
+        setStateVectors(state_vectors, doubleData, floatData);
+        m_logfile << (state_vectors ? "Switching to state vectors for position and attitude"
+                                    : "Switching to single messages for position and attitude") << std::endl;
+    }
+    // the ring has a single reader, the others still need UDP
+    int reader = m_subscribers.sharedMemoryReader();
+    if (reader < 0)
+        sharedMemory->deactivate();
+    sharedMemory->setUdpEnabled(reader < 0 || m_subscribers.size() > 1);
+    if (sharedMemory->active() != m_ring_destinations)
+        updateDestinations();
+}
+
+void CanASOverUDP::updateDestinations()
+{
+    // the reader of the active ring must not get the datagrams a second time by UDP
+    m_ring_destinations = sharedMemory->active();
+    m_subscribers.destinations(writeSock->port(), m_ring_destinations, m_destinations);
+    writeSock->setDestinations(m_destinations);
+}
+
+void CanASOverUDP::setStateVectors(bool enabled, DataContainer<double>& doubleData, DataContainer<float>& floatData)
+{
+    if (stateVector->enabled() == enabled)
+        return;
+    stateVector->setEnabled(enabled);
+    // the state vector resolves finer than the deadband of the single messages
+    doubleData.setFullPrecision(LAT, enabled);
+    doubleData.setFullPrecision(LON, enabled);
+    doubleData.setFullPrecision(TALT, enabled);
+    floatData.setFullPrecision(THDG, enabled);
+    floatData.setFullPrecision(PITCH, enabled);
+    floatData.setFullPrecision(BANK, enabled);
+    doubleData.setSendEnabled(LAT, !enabled);
+    doubleData.setSendEnabled(LON, !enabled);
+    doubleData.setSendEnabled(TALT, !enabled);
+    floatData.setSendEnabled(THDG, !enabled);
+    floatData.setSendEnabled(PITCH, !enabled);
+    floatData.setSendEnabled(BANK, !enabled);
 }
 
 bool CanASOverUDP::processInput(DataContainer<int>& intData, DataContainer<float>& floatData,
@@ -149,7 +285,7 @@ bool CanASOverUDP::processInput(DataContainer<int>& intData, DataContainer<float
                            DataContainer<std::vector<float> >& floatvectorData ,
                            DataContainer<std::vector<int> >& ,
                            DataContainer<std::string>&,
-                           std::vector<LogicHandler*> Handlers,
+                           const std::vector<LogicHandler*>& Handlers,
                            int ticks, double secs)
 {
 
@@ -158,6 +294,34 @@ bool CanASOverUDP::processInput(DataContainer<int>& intData, DataContainer<float
     struct sockaddr_in fromaddr;
     socklen_t fromaddr_len;
 
+    if (m_subscribers.expire(secs) > 0)
+    {
+        updateDestinations();
+        updateModes(doubleData, floatData);
+    }
+
+    // a subscriber the datagrams could not be sent to is dropped, it subscribes again with its next message
+    if (writeSock->takeFailedDestinations(m_failed_destinations) &&
+        m_subscribers.removeUnreachable(m_failed_destinations) > 0)
+    {
+        updateDestinations();
+        updateModes(doubleData, floatData);
+    }
+
+    // fall back to UDP if the reader of the shared memory ring stalled or did not keep up
+    int reader = m_subscribers.sharedMemoryReader();
+    if (reader >= 0 && !sharedMemory->checkReader(secs))
+    {
+        m_subscribers.at(reader).shared_memory = false;
+        updateModes(doubleData, floatData);
+    }
+    // the ring may have been deactivated by an overflow, its reader needs UDP again
+    if (sharedMemory->active() != m_ring_destinations)
+        updateDestinations();
+
+    // a quiet subscriber gets its own STS while the others keep talking
+    keepSubscribersAlive(secs);
+
     // check if we were connected to vasfmc in the last 15 seconds, if not, send a state transmission service request
     if (m_last_heared_from_vasfmc + 15.0f < secs && last_sent_sts + 15.0f < secs)
     {
@@ -168,6 +332,9 @@ bool CanASOverUDP::processInput(DataContainer<int>& intData, DataContainer<float
     if (m_last_heared_from_vasfmc + 17.0f < secs && m_enabled)
     {
         m_enabled=false;
+        // the next vasFMC may not know batched frames or state vectors
+        casprotocol->setBatchedFrames(false);
+        setStateVectors(false, doubleData, floatData);
         for ( std::vector<LogicHandler*>::const_iterator it = Handlers.begin () ; it!= Handlers.end() ; ++it )
             (*it)->suspend(true);
         m_logfile << "Timeout from vasFMC, going offline" << std::endl;
@@ -176,9 +343,14 @@ bool CanASOverUDP::processInput(DataContainer<int>& intData, DataContainer<float
     for ( std::vector<LogicHandler*>::const_iterator it = Handlers.begin () ; it!= Handlers.end() ; ++it )
         if ( (*it)->name() == "APXPlane9Standard")
             apHandler = *it;
+    // the socket drains its queue with few calls, but never more than
+    // CANAS_MAX_READ_PER_CALL messages per callback to not stall the flight loop
     can_t message;
-    while ( readSock->read(&message, sizeof(message), fromaddr, fromaddr_len) > 0)
+    unsigned int messages_read = 0;
+    while ( messages_read < CANAS_MAX_READ_PER_CALL &&
+            readSock->read(&message, sizeof(message), fromaddr, fromaddr_len) > 0)
     {
+        messages_read++;
         // if we receive a message from vasfmc while being disabled, enabled all handlers and start sending again
         if (!m_enabled)
         {
@@ -188,6 +360,10 @@ bool CanASOverUDP::processInput(DataContainer<int>& intData, DataContainer<float
             m_logfile << "Data from vasFMC again, going online" << std::endl;
         }
         m_last_heared_from_vasfmc = secs;
+        unsigned int subscriber_count = m_subscribers.size();
+        SubscriberList::Subscriber& subscriber = m_subscribers.heardFrom(fromaddr, secs);
+        if (m_subscribers.size() != subscriber_count)
+            updateDestinations();
         float f;
         int i;
         bool b;
@@ -203,6 +379,11 @@ bool CanASOverUDP::processInput(DataContainer<int>& intData, DataContainer<float
                 switch (message.msg.aero.serviceCode)
                 {
                     case 0: // handle IDS
+                        // a (re)connecting vasFMC negotiates batched frames and state vectors after the IDS
+                        subscriber.batched = false;
+                        subscriber.state_vectors = false;
+                        subscriber.shared_memory = false;
+                        updateModes(doubleData, floatData);
                         can_t response;
                         response.id = htonl(NSH_CH0_RES);
                         response.dlc = 8;
@@ -224,6 +405,48 @@ bool CanASOverUDP::processInput(DataContainer<int>& intData, DataContainer<float
                         boolData.outDateAll();
                         floatvectorData.outDateAll();
                         break;
+                    case BFS: // vasFMC can receive batched frames
+                        if (message.msg.aero.dataType == AS_UCHAR &&
+                            message.msg.aero.data.uChar[0] == CANAS_FRAME_VERSION)
+                        {
+                            subscriber.batched = true;
+                            updateModes(doubleData, floatData);
+                        } else
+                        {
+                            m_logfile << "Batched frame version not supported, keeping single messages" << std::endl;
+                        }
+                        break;
+                    case SVS: // vasFMC can receive state vectors
+                        if ((message.msg.aero.dataType == AS_UCHAR || message.msg.aero.dataType == AS_UCHAR4) &&
+                            message.msg.aero.data.uChar[0] == CANAS_STATE_VERSION)
+                        {
+                            // the second byte limits the state vectors per second, 0 for no limit
+                            unsigned int rate = 0;
+                            if (message.msg.aero.dataType == AS_UCHAR4)
+                                rate = message.msg.aero.data.uChar[1];
+                            subscriber.state_vectors = true;
+                            subscriber.state_vector_interval = (rate > 0) ? 1.0 / rate : 0.0;
+                            updateModes(doubleData, floatData);
+                        } else
+                        {
+                            m_logfile << "State vector version not supported, keeping single messages" << std::endl;
+                        }
+                        break;
+                    case SHS: // vasFMC on this host reads the shared memory ring
+                        if (message.msg.aero.dataType != AS_UCHAR ||
+                            message.msg.aero.data.uChar[0] != CANAS_SHM_VERSION || !sharedMemory->isOpen())
+                        {
+                            m_logfile << "Shared memory not available, keeping UDP" << std::endl;
+                        } else if (m_subscribers.sharedMemoryReader() >= 0 && !subscriber.shared_memory)
+                        {
+                            m_logfile << "Shared memory already read by an other subscriber, keeping UDP" << std::endl;
+                        } else
+                        {
+                            subscriber.shared_memory = true;
+                            sharedMemory->activate(secs);
+                            updateModes(doubleData, floatData);
+                        }
+                        break;
                     default: m_logfile << "ERROR: Cannot handle Node Service Request with service code " << message.msg.aero.serviceCode << std::endl;
                 }
                 // requests handled, no further processing necessary, continue loop immediately to fetch fresh data
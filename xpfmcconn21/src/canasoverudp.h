@@ -6,6 +6,9 @@
 #include "udpreadsocket.h"
 #include "udpwritesocket.h"
 #include "casprotocol.h"
+#include "sharedmemorywriter.h"
+#include "statevector.h"
+#include "subscribers.h"
 #include "myassert.h"
 #include "canas.h"
 
@@ -22,12 +25,12 @@ public:
     virtual bool processOutput(DataContainer<int>&, DataContainer<float>&, DataContainer<double>&,
                                DataContainer<bool>&, DataContainer<std::vector<float> >&,
                                DataContainer<std::vector<int> >&, DataContainer<std::string>&,
-                               std::vector<LogicHandler*>, int ticks = 0, double secs = 0.0f, unsigned int maxDataItems = 256);
+                               const std::vector<LogicHandler*>&, int ticks = 0, double secs = 0.0f, unsigned int maxDataItems = 256);
 
     virtual bool processInput(DataContainer<int>&, DataContainer<float>&, DataContainer<double>&,
                                DataContainer<bool>&, DataContainer<std::vector<float> >&,
                                DataContainer<std::vector<int> >&, DataContainer<std::string>&,
-                               std::vector<LogicHandler*>, int ticks = 0, double secs = 0.0f);
+                               const std::vector<LogicHandler*>&, int ticks = 0, double secs = 0.0f);
 
     virtual bool registerDataRefs();
 
@@ -54,7 +57,19 @@ public:
 
     virtual std::string name() { return "CanASOverUDP";}
 
-    void flush(unsigned int maxDataItems);
+    /**
+      * @return number of messages written
+      */
+    unsigned int flush(unsigned int maxDataItems);
+
+    unsigned int queueLength() { return casprotocol->lengthOfQueue(); }
+
+    /**
+      * write position and attitude as state vector, if vasFMC requested state vectors
+      */
+    void writeStateVector(DataContainer<double>& doubleData, DataContainer<float>& floatData, double secs);
+
+    bool stateVectorsEnabled() { return m_enabled && stateVector->enabled(); }
 
 private:
 
@@ -62,13 +77,62 @@ private:
 
     int sendRequest(uint8_t service_code);
 
+    /**
+      * send the node service request to the given subscriber only
+      */
+    int sendRequest(uint8_t service_code, const SubscriberList::Subscriber& subscriber);
+
+    /**
+      * send an STS to the subscribers which are about to time out
+      */
+    void keepSubscribersAlive(double secs);
+
+    /**
+      * switch state vectors on or off, the data carried by the state vector
+      * is not sent as single messages while they are on
+      */
+    void setStateVectors(bool enabled, DataContainer<double>& doubleData, DataContainer<float>& floatData);
+
+    /**
+      * use batched frames and state vectors only if all subscribers understand them,
+      * UDP only if a subscriber does not read the shared memory ring
+      */
+    void updateModes(DataContainer<double>& doubleData, DataContainer<float>& floatData);
+
+    /**
+      * hand the addresses of the subscribers to the write socket for fan out,
+      * without the reader of the shared memory ring while the ring is active
+      */
+    void updateDestinations();
+
     uint8_t messageCode;
 
     UDPReadSocket* readSock;
 
     UDPWriteSocket* writeSock;
 
-    ProtocolStreamer* casprotocol;
+    Casprotocol* casprotocol;
+
+    /**
+      * writes to the shared memory ring and/or writeSock, the messages are written to it
+      */
+    SharedMemoryWriter* sharedMemory;
+
+    StateVectorWriter* stateVector;
+
+    SubscriberList m_subscribers;
+
+    /**
+      * scratch lists of addresses, reserved for MAX_SUBSCRIBERS
+      */
+    std::vector<struct sockaddr_in> m_destinations;
+    std::vector<struct sockaddr_in> m_state_vector_destinations;
+    std::vector<struct sockaddr_in> m_failed_destinations;
+
+    /**
+      * the reader of the shared memory ring was left out of m_destinations
+      */
+    bool m_ring_destinations;
 
     bool configured;
 
@@ -0,0 +1,69 @@
+#ifndef CANQUEUE_H
+#define CANQUEUE_H
+
+#include <vector>
+#include "canas.h"
+
+    /**
+     * FIFO of CAN messages in a ring of preallocated storage.
+     * Unlike std::queue, pushing and popping does not allocate once the ring
+     * has grown to the usual queue length; the ring only grows when it is full.
+     * @file canqueue.h
+     */
+class CanQueue
+{
+public:
+    /**
+      * @param capacity number of messages the ring can hold before it has to grow
+      */
+    CanQueue(unsigned int capacity = 1024):
+            m_ring(capacity),
+            m_head(0),
+            m_count(0)
+    {}
+
+    bool empty() const { return m_count == 0; }
+
+    unsigned int size() const { return m_count; }
+
+    const can_t& front() const { return m_ring[m_head]; }
+
+    void push(const can_t& can)
+    {
+        if (m_count == m_ring.size())
+            grow();
+        m_ring[(m_head + m_count) % m_ring.size()] = can;
+        m_count++;
+    }
+
+    void pop()
+    {
+        m_head = (m_head + 1) % m_ring.size();
+        m_count--;
+    }
+
+    void clear()
+    {
+        m_head = 0;
+        m_count = 0;
+    }
+
+private:
+    /**
+      * double the capacity, keeping the order of the queued messages
+      */
+    void grow()
+    {
+        std::vector<can_t> ring(m_ring.size() * 2);
+        for (unsigned int i = 0 ; i < m_count ; i++)
+            ring[i] = m_ring[(m_head + i) % m_ring.size()];
+        m_ring.swap(ring);
+        m_head = 0;
+    }
+
+    std::vector<can_t> m_ring;
+    unsigned int m_head;
+    unsigned int m_count;
+};
+
+#endif // CANQUEUE_H
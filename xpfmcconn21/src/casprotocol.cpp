@@ -1,6 +1,8 @@
 #include "casprotocol.h"
 #include "myassert.h"
 
+#include <cstring>
+
 #ifdef WIN_32
 #include <windows.h>
 #else
@@ -9,37 +11,37 @@
 
 void Casprotocol::protocolWrite(DataToSend<int>& data)
 {
-    protocolWrite(data.id(), data.data(), data.messageCode());
+    protocolWrite(data.id(), data.data(), data.messageCode(), data.prio());
     data.incMessageCode();
 }
 
 void Casprotocol::protocolWrite(DataToSend<float>& data)
 {
-    protocolWrite(data.id(), data.data(), data.messageCode());
+    protocolWrite(data.id(), data.data(), data.messageCode(), data.prio());
     data.incMessageCode();
 }
 
 void Casprotocol::protocolWrite(DataToSend<double>& data)
 {
-    protocolWrite(data.id(), float(data.data()), data.messageCode());
+    protocolWrite(data.id(), float(data.data()), data.messageCode(), data.prio());
     data.incMessageCode();
 }
 
 void Casprotocol::protocolWrite(DataToSend<bool>& data)
 {
-    protocolWrite(data.id(), data.data(), data.messageCode());
+    protocolWrite(data.id(), data.data(), data.messageCode(), data.prio());
     data.incMessageCode();
 }
 
 void Casprotocol::protocolWrite(DataToSend<std::string>& data)
 {
-    protocolWrite(data.id(), data.data(), data.messageCode());
+    protocolWrite(data.id(), data.data(), data.messageCode(), data.prio());
     data.incMessageCode();
 }
 
 void Casprotocol::protocolWrite(DataToSend<std::vector<float> >& data)
 {
-    for (uint i = 0 ; i < data.data().size() ; i++)
+    for (uint i = 0 ; i < data.itemCount() ; i++)
     {
         canAS_t message;
         can_t can;
@@ -49,17 +51,17 @@ void Casprotocol::protocolWrite(DataToSend<std::vector<float> >& data)
         message.messageCode = data.messageCode();
         data.incMessageCode();
         message.serviceCode = i;
-        message.data.flt = data.data().at(i);
+        message.data.flt = data.itemValue(i);
         message.data.sLong = htonl(message.data.sLong);
         message.dataType = AS_FLOAT;
         can.dlc = 8;
         can.msg.aero = message;
-        m_sendqueue.push(can);
+        sendQueue(data.prio()).push(can);
     }
 }
 
 
-void Casprotocol::protocolWrite(uint32_t id, float data, uint8_t message_code)
+void Casprotocol::protocolWrite(uint32_t id, float data, uint8_t message_code, unsigned char prio)
 {
     canAS_t message;
     can_t can;
@@ -73,10 +75,10 @@ void Casprotocol::protocolWrite(uint32_t id, float data, uint8_t message_code)
     message.dataType = AS_FLOAT;
     can.dlc = 8;
     can.msg.aero = message;
-    m_sendqueue.push(can);
+    sendQueue(prio).push(can);
 }
 
-void Casprotocol::protocolWrite(uint32_t id, int data, uint8_t message_code)
+void Casprotocol::protocolWrite(uint32_t id, int data, uint8_t message_code, unsigned char prio)
 {
     canAS_t message;
     can_t can;
@@ -89,10 +91,10 @@ void Casprotocol::protocolWrite(uint32_t id, int data, uint8_t message_code)
     message.dataType = AS_LONG;
     can.dlc = 8;
     can.msg.aero = message;
-    m_sendqueue.push(can);
+    sendQueue(prio).push(can);
 }
 
-void Casprotocol::protocolWrite(uint32_t id, bool data, uint8_t message_code)
+void Casprotocol::protocolWrite(uint32_t id, bool data, uint8_t message_code, unsigned char prio)
 {
     canAS_t message;
     can_t can;
@@ -105,9 +107,9 @@ void Casprotocol::protocolWrite(uint32_t id, bool data, uint8_t message_code)
     message.dataType = AS_UCHAR;
     can.dlc = 5;
     can.msg.aero = message;
-    m_sendqueue.push(can);
+    sendQueue(prio).push(can);
 }
-void Casprotocol::protocolWrite(uint32_t id, std::string data, uint8_t message_code)
+void Casprotocol::protocolWrite(uint32_t id, std::string data, uint8_t message_code, unsigned char prio)
 {
     int strlen = data.size();
     if (strlen > 0)
@@ -137,45 +139,104 @@ void Casprotocol::protocolWrite(uint32_t id, std::string data, uint8_t message_c
         message.dataType = FP_ACHAR5;
         can.dlc = 4+strlen;
         can.msg.aero = message;
-        m_sendqueue.push(can);
+        sendQueue(prio).push(can);
         }
 }
 
+unsigned int Casprotocol::lengthOfQueue()
+{
+    unsigned int length = 0;
+    for (unsigned int i = 0 ; i < PrioType::prioCount ; i++)
+        length += m_sendqueue[i].size();
+    return length;
+}
+
+CanQueue* Casprotocol::nextQueue()
+{
+    // the queues are ordered from PrioType::High to PrioType::Constant
+    for (unsigned int i = 0 ; i < PrioType::prioCount ; i++)
+        if (!m_sendqueue[i].empty())
+            return &m_sendqueue[i];
+    return 0;
+}
+
 unsigned int Casprotocol::writeAll()
+{
+    return writeQueued(lengthOfQueue());
+}
+
+unsigned int Casprotocol::writeQueued(unsigned int max)
 {
     unsigned int i = 0;
-    while (!m_sendqueue.empty())
+    if (m_batched)
     {
-        can_t can = m_sendqueue.front();
-        if( !( m_writer->write(&can, sizeof(can)) == sizeof(can_t)))
+        while (nextQueue() != 0 && i < max)
+            i += writeFrame(max - i);
+        return i;
+    }
+    // hand the messages to the writer in batches, so they can be sent with one call
+    can_t batch[CASPROTOCOL_WRITE_BATCH];
+    CanQueue* queue;
+    while ((queue = nextQueue()) != 0 && i < max )
+    {
+        unsigned int count = 0;
+        while (queue != 0 && i + count < max && count < CASPROTOCOL_WRITE_BATCH)
+        {
+            batch[count++] = queue->front();
+            queue->pop();
+            if (queue->empty())
+                queue = nextQueue();
+        }
+        if( !( m_writer->writeMany(batch, sizeof(can_t), count) == long(count)))
             m_logfile << "Not all bytes were sent. This indicates network problems." << std::endl;
-        m_sendqueue.pop();
-        i++;
+        i += count;
     }
     return i;
 }
 
+unsigned int Casprotocol::writeFrame(unsigned int max)
+{
+    unsigned int count = 0;
+    char* record = m_frame + sizeof(canAS_frame_header_t);
+    CanQueue* queue = nextQueue();
+    while (queue != 0 && count < max && count < CANAS_FRAME_MAX_RECORDS)
+    {
+        memcpy(record, &queue->front(), sizeof(can_t));
+        queue->pop();
+        if (queue->empty())
+            queue = nextQueue();
+        record += sizeof(can_t);
+        count++;
+    }
+
+    canAS_frame_header_t header;
+    header.magic = htonl(CANAS_FRAME_MAGIC);
+    header.count = htons(uint16_t(count));
+    header.sequence = htons(m_frame_sequence++);
+    memcpy(m_frame, &header, sizeof(header));
+
+    size_t size = sizeof(canAS_frame_header_t) + count * sizeof(can_t);
+    if( !( m_writer->write(m_frame, size) == long(size)))
+        m_logfile << "Not all bytes were sent. This indicates network problems." << std::endl;
+    return count;
+}
+
 unsigned int Casprotocol::writeMax(unsigned int max)
 {
     static unsigned int history_queue_length = 0;
     static unsigned int grown_in_a_row = 0;
-    unsigned int i = 0;
-    while (!m_sendqueue.empty() && i < max )
-    {
-        can_t can = m_sendqueue.front();
-        if( !( m_writer->write(&can, sizeof(can)) == sizeof(can_t)))
-            m_logfile << "Not all bytes were sent. This indicates network problems." << std::endl;
-        m_sendqueue.pop();
-        i++;
-    }
-    if (history_queue_length < m_sendqueue.size())
+    // the budget of the link is spent from the highest priority down, so
+    // position and attitude data never waits behind lower priority data
+    unsigned int i = writeQueued(max);
+    unsigned int queue_length = lengthOfQueue();
+    if (history_queue_length < queue_length)
         grown_in_a_row++;
-    history_queue_length = m_sendqueue.size();
-    if (grown_in_a_row > 5 && m_sendqueue.size()>150)
+    history_queue_length = queue_length;
+    if (grown_in_a_row > 5 && queue_length>150)
     {
-        m_logfile << "The sendqueue grows too large, skipping old items now." << std::endl;
-        while (!m_sendqueue.empty())
-            m_sendqueue.pop();
+        m_logfile << "The sendqueue grows too large, skipping old items of lower priority now." << std::endl;
+        for (unsigned int q = 1 ; q < PrioType::prioCount ; q++)
+            m_sendqueue[q].clear();
         grown_in_a_row = 0;
     }
     return i;
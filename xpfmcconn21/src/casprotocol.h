@@ -5,10 +5,13 @@
 #include "paketwriter.h"
 #include "datatosend.h"
 #include "canas.h"
+#include "canqueue.h"
 #include <string>
-#include <queue>
 #include <stdint.h>
 
+// max. number of single messages handed to PaketWriter::writeMany at once
+#define CASPROTOCOL_WRITE_BATCH 64
+
 class Casprotocol : public ProtocolStreamer
 {
 public:
@@ -17,7 +20,9 @@ public:
             m_writer(paketwriter),
             m_node_id(node_id),
             m_id29(id29),
-            m_logfile(logfile)
+            m_logfile(logfile),
+            m_batched(false),
+            m_frame_sequence(0)
     {}
     virtual ~Casprotocol(){}
     virtual void protocolWrite(DataToSend<int>& data);
@@ -26,19 +31,45 @@ public:
     virtual void protocolWrite(DataToSend<bool>& data);
     virtual void protocolWrite(DataToSend<std::string>& data);
     virtual void protocolWrite(DataToSend<std::vector<float> >& data);
-    virtual void protocolWrite(uint32_t id, float data, uint8_t message_code);
-    virtual void protocolWrite(uint32_t id, int data, uint8_t message_code);
-    virtual void protocolWrite(uint32_t id, bool data, uint8_t message_code);
-    virtual void protocolWrite(uint32_t id, std::string data, uint8_t message_code);
+    virtual void protocolWrite(uint32_t id, float data, uint8_t message_code, unsigned char prio = PrioType::Middle);
+    virtual void protocolWrite(uint32_t id, int data, uint8_t message_code, unsigned char prio = PrioType::Middle);
+    virtual void protocolWrite(uint32_t id, bool data, uint8_t message_code, unsigned char prio = PrioType::Middle);
+    virtual void protocolWrite(uint32_t id, std::string data, uint8_t message_code, unsigned char prio = PrioType::Middle);
     virtual unsigned int writeAll();
     virtual unsigned int writeMax(unsigned int max);
-    unsigned int lengthOfQueue() {return m_sendqueue.size();}
+    unsigned int lengthOfQueue();
+
+    /**
+      * switch between one can_t per datagram and batched frames (see canAS_frame_header_t).
+      * Batched frames must only be used after the receiver requested them.
+      */
+    void setBatchedFrames(bool batched) { m_batched = batched; }
+    bool batchedFrames() { return m_batched; }
 private:
+    /**
+      * write up to max queued messages, one per datagram or batched into frames
+      */
+    unsigned int writeQueued(unsigned int max);
+    unsigned int writeFrame(unsigned int max);
+    /**
+      * @return the queue of messages with the given priority (see PrioType)
+      */
+    CanQueue& sendQueue(unsigned char prio) { return m_sendqueue[(prio >> 6) & 3]; }
+    /**
+      * @return the non-empty queue with the highest priority, 0 if all queues are empty
+      */
+    CanQueue* nextQueue();
     PaketWriter* m_writer;
     uint8_t m_node_id;
     bool m_id29;
     std::ostream& m_logfile;
-    std::queue<can_t> m_sendqueue;
+    /**
+      * one queue per priority, index 0 holds PrioType::High
+      */
+    CanQueue m_sendqueue[PrioType::prioCount];
+    bool m_batched;
+    uint16_t m_frame_sequence;
+    char m_frame[CANAS_FRAME_MAX_BYTES];
 };
 
 #endif // CASPROTOCOL_H
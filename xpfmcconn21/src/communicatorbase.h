@@ -26,12 +26,12 @@ public:
     virtual bool processOutput(DataContainer<int>&, DataContainer<float>&, DataContainer<double>&,
                                DataContainer<bool>&, DataContainer<std::vector<float> >&,
                                DataContainer<std::vector<int> >&, DataContainer<std::string>&,
-                               std::vector<LogicHandler*>, int ticks= 0, double secs =0.0f, unsigned int maxDataItems=256) = 0;
+                               const std::vector<LogicHandler*>&, int ticks= 0, double secs =0.0f, unsigned int maxDataItems=256) = 0;
 
     virtual bool processInput(DataContainer<int>&, DataContainer<float>&, DataContainer<double>&,
                                DataContainer<bool>&, DataContainer<std::vector<float> >&,
                                DataContainer<std::vector<int> >&, DataContainer<std::string>&,
-                               std::vector<LogicHandler*>, int ticks=0, double secs=0.0f) = 0;
+                               const std::vector<LogicHandler*>&, int ticks=0, double secs=0.0f) = 0;
 };
 
 #endif // COMMUNICATORBASE_H
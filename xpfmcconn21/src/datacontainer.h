@@ -28,6 +28,7 @@
 
 #include "protocolstreamer.h"
 #include "datatosend.h"
+#include "plugin_defines.h"
 
 using std::pair;
 using std::queue;
@@ -38,7 +39,16 @@ using std::queue;
   * and to write id and data-packets to a buffer, sending either all data or only a max number
   * of data that is really is outdated or outtimed. Keeps track on which data has been sent
   * the last call.
-  * @version 0.2
+  * The slot of each id is kept in a dense index, so the access by id does not search.
+  * The send state (priority, send interval, deadline, pending flag) is kept in
+  * arrays parallel to the slots, so the update and send loops only touch the
+  * items that are polled or sent.
+  * Sending is event driven: an item becomes due when it changed by more than its
+  * epsilon (it is appended to the due list right when the change is taken over)
+  * or when its deadline expires. Deadlines are kept in a timing wheel of
+  * SEND_WHEEL_BUCKETS buckets of SEND_WHEEL_TICK_SECS, so writeOutdated() only
+  * visits the buckets that expired since the last call, not every item.
+  * @version 0.4
   * @author Philipp Muenzel
   * @file datacontainer.h
   */
@@ -85,10 +95,31 @@ class DataContainer : private std::vector<DataToSend<T> > {
       */
     T valueAtId(uint32_t id);
 
+    /**
+      * write all data which changed or whose deadline expired and schedule
+      * the next deadline of the written items
+      * @return number of written items
+      */
     unsigned int writeOutdated(ProtocolStreamer* streamer, int ticks, double secs);
 
+    /**
+      * force all data to be sent with the next writeOutdated()
+      */
     void outDateAll();
 
+    /**
+      * switch sending of the data with the given id on or off, e.g. when it is
+      * carried by an other message. The data is still polled and scheduled.
+      * @param id the id as defined in refids enum
+      */
+    void setSendEnabled(uint32_t id, bool enabled);
+
+    /**
+      * switch the eps of the data with the given id off or on again, see SimData::setFullPrecision()
+      * @param id the id as defined in refids enum
+      */
+    void setFullPrecision(uint32_t id, bool full_precision);
+
     /**
       * set the dataref with id internally to value data
       * @param id the id as defined in refids enum
@@ -99,31 +130,216 @@ class DataContainer : private std::vector<DataToSend<T> > {
 
  private:
 
+    /**
+      * @return the slot of the id or -1 if the id is not in the container
+      */
+    int slotOfId(uint32_t id) const
+    {
+        return (id < m_slotOfId.size()) ? m_slotOfId[id] : -1;
+    }
+
+    /**
+      * take over the changed flag set by poll() or set() into the send state
+      */
+    void takeChanged(unsigned int slot)
+    {
+        if (this->at(slot).hasChanged())
+        {
+            markDue(slot);
+            this->at(slot).resetChanged();
+        }
+    }
+
+    /**
+      * append the slot to the due list unless it is already pending
+      */
+    void markDue(unsigned int slot)
+    {
+        if (!m_pending[slot])
+        {
+            m_pending[slot] = 1;
+            m_dueSlots.push_back(slot);
+        }
+    }
+
+    /**
+      * @return the wheel tick at the given time
+      */
+    static long tickOf(double secs) { return long(secs / SEND_WHEEL_TICK_SECS); }
+
+    /**
+      * @return the bucket of the wheel holding the deadlines of the given tick
+      */
+    static int bucketOf(long tick) { return int(((tick % SEND_WHEEL_BUCKETS) + SEND_WHEEL_BUCKETS) % SEND_WHEEL_BUCKETS); }
+
+    /**
+      * insert the slot into the bucket of its deadline tick
+      */
+    void wheelInsert(unsigned int slot);
+
+    /**
+      * remove the slot from the bucket it is linked into, if any
+      */
+    void wheelRemove(unsigned int slot);
+
+    /**
+      * move the slots of all buckets which expired up to the given tick to the due list
+      */
+    void advanceWheel(long tick);
+
+    /**
+      * rebuild the id index, the list of high priority slots, the due list and the timing wheel
+      */
+    void reindex();
+
     void resetPositionPointer() { m_pos = 0; }
 
     unsigned int m_counter;
 
     unsigned int m_pos;
 
+    /**
+      * slot in the vector for each id, -1 for ids not in the container
+      */
+    std::vector<int> m_slotOfId;
+
+    /**
+      * slots of the data with PrioType::High
+      */
+    std::vector<unsigned int> m_highPrioSlots;
+
+    /**
+      * send state, one entry per slot
+      */
+    std::vector<unsigned char> m_prio;
+    std::vector<long> m_intervalTicks;
+    std::vector<long> m_deadlineTick;
+    std::vector<char> m_pending;
+    std::vector<char> m_sendEnabled;
+
+    /**
+      * slots which are pending, in the order they became due
+      */
+    std::vector<unsigned int> m_dueSlots;
+
+    /**
+      * timing wheel: first slot per bucket and a doubly linked list through the slots, -1 terminated
+      */
+    std::vector<int> m_wheelHead;
+    std::vector<int> m_wheelNext;
+    std::vector<int> m_wheelPrev;
+
+    /**
+      * bucket the slot is linked into, -1 if it is not in the wheel
+      */
+    std::vector<int> m_wheelBucket;
+
+    /**
+      * last tick the wheel was advanced to
+      */
+    long m_wheelTick;
 };
 
 template <typename T>
 DataContainer<T>::DataContainer():
     std::vector<DataToSend<T> >(),
     m_counter(0),
-    m_pos(0)
+    m_pos(0),
+    m_wheelHead(SEND_WHEEL_BUCKETS, -1),
+    m_wheelTick(-1)
 {
 }
 
 template <typename T>
-void DataContainer<T>::removeAtId(uint32_t id)
+void DataContainer<T>::wheelInsert(unsigned int slot)
 {
-    for ( unsigned int i = 0 ; i<this->size() ; i++)
-        if ( this->at(i).id() == id )
+    int bucket = bucketOf(m_deadlineTick[slot]);
+    m_wheelPrev[slot] = -1;
+    m_wheelNext[slot] = m_wheelHead[bucket];
+    if (m_wheelHead[bucket] >= 0)
+        m_wheelPrev[m_wheelHead[bucket]] = slot;
+    m_wheelHead[bucket] = slot;
+    m_wheelBucket[slot] = bucket;
+}
+
+template <typename T>
+void DataContainer<T>::wheelRemove(unsigned int slot)
+{
+    int bucket = m_wheelBucket[slot];
+    if (bucket < 0)
+        return;
+    if (m_wheelPrev[slot] >= 0)
+        m_wheelNext[m_wheelPrev[slot]] = m_wheelNext[slot];
+    else
+        m_wheelHead[bucket] = m_wheelNext[slot];
+    if (m_wheelNext[slot] >= 0)
+        m_wheelPrev[m_wheelNext[slot]] = m_wheelPrev[slot];
+    m_wheelBucket[slot] = -1;
+}
+
+template <typename T>
+void DataContainer<T>::advanceWheel(long tick)
+{
+    if (m_wheelTick < 0 || tick - m_wheelTick > SEND_WHEEL_BUCKETS)
+        m_wheelTick = tick - SEND_WHEEL_BUCKETS;
+    while (m_wheelTick < tick)
+    {
+        m_wheelTick++;
+        int slot = m_wheelHead[bucketOf(m_wheelTick)];
+        while (slot >= 0)
         {
-            this->erase(this->begin()+i);
-            m_counter--;
+            int next = m_wheelNext[slot];
+            if (m_deadlineTick[slot] <= tick)
+            {
+                wheelRemove(slot);
+                markDue(slot);
+            }
+            slot = next;
         }
+    }
+}
+
+template <typename T>
+void DataContainer<T>::reindex()
+{
+    m_slotOfId.assign(m_slotOfId.size(), -1);
+    m_highPrioSlots.clear();
+    m_dueSlots.clear();
+    m_dueSlots.reserve(this->size());
+    m_wheelHead.assign(SEND_WHEEL_BUCKETS, -1);
+    m_wheelNext.assign(this->size(), -1);
+    m_wheelPrev.assign(this->size(), -1);
+    m_wheelBucket.assign(this->size(), -1);
+    for ( unsigned int i = 0 ; i < this->size() ; i++ )
+    {
+        uint32_t id = this->at(i).id();
+        if (id >= m_slotOfId.size())
+            m_slotOfId.resize(id + 1, -1);
+        m_slotOfId[id] = i;
+        if (m_prio[i] == PrioType::High)
+            m_highPrioSlots.push_back(i);
+        if (m_pending[i])
+            m_dueSlots.push_back(i);
+        else
+            wheelInsert(i);
+    }
+}
+
+template <typename T>
+void DataContainer<T>::removeAtId(uint32_t id)
+{
+    int slot = slotOfId(id);
+    if (slot < 0)
+        return;
+
+    this->erase(this->begin() + slot);
+    m_prio.erase(m_prio.begin() + slot);
+    m_intervalTicks.erase(m_intervalTicks.begin() + slot);
+    m_deadlineTick.erase(m_deadlineTick.begin() + slot);
+    m_pending.erase(m_pending.begin() + slot);
+    m_sendEnabled.erase(m_sendEnabled.begin() + slot);
+    m_counter--;
+    reindex();
 }
 
 template <typename T>
@@ -131,14 +347,18 @@ void DataContainer<T>::addDataRef(uint32_t id, short readWrite, const std::strin
                             const std::string& dataRefIdentifier, unsigned char prio,
                             double eps, double scale, double offset, int no_of_items)
 {
-    bool exists = false;
-    for (uint i = 0 ; i < this->size() ; i++)
-        if (this->at(i).id() == id)
-            exists = true;
-    if (!exists)
+    if (slotOfId(id) < 0)
     {
         this->push_back( DataToSend<T>( id, readWrite, name, dataRefIdentifier, prio, eps, scale, offset, no_of_items) );
+        m_prio.push_back(prio);
+        m_intervalTicks.push_back(long(DataToSend<T>::sendInterval(prio) / SEND_WHEEL_TICK_SECS + 0.5));
+        m_deadlineTick.push_back(0);
+        // new data is sent with the next writeOutdated()
+        m_pending.push_back(1);
+        m_sendEnabled.push_back(1);
+        this->back().resetChanged();
         m_counter++;
+        reindex();
     } else
     {
         m_logfile << "DataRef with id " << id << "name : " << name
@@ -150,61 +370,93 @@ template <typename T>
 void DataContainer<T>::updateAll()
 {
     for ( unsigned int i = 0 ; i < this->size() ; i++ )
+    {
         this->at(i).poll();
+        takeChanged(i);
+    }
 }
 
 template <typename T>
 void DataContainer<T>::updateHighPrio()
 {
-    for ( unsigned int i = 0; i < this->size() ; i++ )
-        if ( this->at(i).prio() == PrioType::High )
-            this->at(i).poll();
+    for ( unsigned int i = 0; i < m_highPrioSlots.size() ; i++ )
+    {
+        this->at(m_highPrioSlots[i]).poll();
+        takeChanged(m_highPrioSlots[i]);
+    }
 }
 
 template <typename T>
 T DataContainer<T>::valueAtId(uint32_t id)
 {
-    for ( unsigned int i = 0 ; i<this->size() ; i++ )
-        if ( this->at(i).id() == id )
-            return this->at(i).data();
-    return T(0);
+    int slot = slotOfId(id);
+    if (slot < 0)
+        return T(0);
+    return this->at(slot).data();
 }
 
 template <typename T>
-unsigned int DataContainer<T>::writeOutdated(ProtocolStreamer* streamer, int ticks, double secs)
+unsigned int DataContainer<T>::writeOutdated(ProtocolStreamer* streamer, int, double secs)
 {
+    long tick = tickOf(secs);
+    advanceWheel(tick);
+
     unsigned int no_of_sent_items = 0;
-    for ( unsigned int i = 0 ; i < this->size() ; i++ )
+    for ( unsigned int i = 0 ; i < m_dueSlots.size() ; i++ )
         {
-            if (this->at(i).needsSending(ticks,secs))
+            unsigned int slot = m_dueSlots[i];
+            if (m_sendEnabled[slot])
             {
-                streamer->protocolWrite(this->at(i));
-                this->at(i).markAsSent(ticks, secs);
+                streamer->protocolWrite(this->at(slot));
                 no_of_sent_items++;
             }
+            m_pending[slot] = 0;
+            // changed data is sent before its deadline, so move it to its new bucket
+            wheelRemove(slot);
+            m_deadlineTick[slot] = tick + m_intervalTicks[slot];
+            wheelInsert(slot);
         }
+    m_dueSlots.clear();
     return no_of_sent_items;
 }
 
 template <typename T>
 void DataContainer<T>::outDateAll()
 {
-    for ( unsigned int i = 0 ; i<this->size() ; i++ )
-    {
-        this->at(i).makeOutDated();
-    }
+    for ( unsigned int i = 0 ; i < m_pending.size() ; i++ )
+        markDue(i);
+}
+
+template <typename T>
+void DataContainer<T>::setSendEnabled(uint32_t id, bool enabled)
+{
+    int slot = slotOfId(id);
+    if (slot < 0)
+        return;
+    m_sendEnabled[slot] = enabled ? 1 : 0;
+    // send the current value right away when switched on again
+    if (enabled)
+        markDue(slot);
+}
+
+template <typename T>
+void DataContainer<T>::setFullPrecision(uint32_t id, bool full_precision)
+{
+    int slot = slotOfId(id);
+    if (slot < 0)
+        return;
+    this->at(slot).setFullPrecision(full_precision);
 }
 
 template <typename T>
 bool DataContainer<T>::setDataRefAtId(uint32_t id, T data)
 {
-    for ( unsigned int i = 0 ; i<this->size() ; i++ )
-    {
-        if ( this->at(i).id() == id) {
-            return this->at(i).set(data);
-        }
-    }
-    return false;
+    int slot = slotOfId(id);
+    if (slot < 0)
+        return false;
+    bool result = this->at(slot).set(data);
+    takeChanged(slot);
+    return result;
 }
 
 #endif
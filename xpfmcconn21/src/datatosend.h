@@ -31,7 +31,8 @@
 
 
     /**
-     *  Simdata that keeps track of when it needs to be synced with outside, e.g. via UDP
+     *  Simdata with the id, priority and message code needed to sync it with outside, e.g. via UDP.
+     *  When it needs to be sent is tracked by the DataContainer holding it.
      *  @author Philipp Muenzel
      * @version 0.2
      * @file datatosend.h
@@ -68,21 +69,11 @@ class DataToSend: public SimData<T> {
 
 
     /**
-     *  has the value changed or has time passed longer than priority permits
-     * @param int ticks internal tick counter at the moment
-     * @param double secs internal seconds counter at the moment
+     *  maximum time between two transmissions of a value with the given priority
+     * @param prio priority as defined by PrioType
+     * @return interval in seconds
      */
-    virtual bool needsSending(int, double);
-
-
-    /**
-     *  reset counters
-     * @param int ticks internal tick counter at the moment
-     * @param double secs internal seconds counter at the moment
-     */
-    virtual bool markAsSent(int, double);
-
-    void makeOutDated();
+    static float sendInterval(unsigned char prio);
 
     uint8_t messageCode() { return m_message_code; }
 
@@ -90,16 +81,6 @@ class DataToSend: public SimData<T> {
 
  private:
 
-    /**
-     *  ticks by last markAsSent()
-     */
-    int m_ticksLastSent;
-
-    /**
-     *  seconds by last markAsSent()-call
-     */
-    float m_secsLastSent;
-
     /**
      *  priority mask according to PrioType
      */
@@ -110,8 +91,6 @@ class DataToSend: public SimData<T> {
      */
     uint32_t m_id;
 
-    bool m_force_outdated;
-
     uint8_t m_message_code;
 
 };
@@ -123,46 +102,23 @@ DataToSend<T>::DataToSend(uint32_t id, short readWrite, const std::string& name,
     SimData<T>(dataRefIdentifier, name, readWrite, eps, scale, offset, no_of_items),
     m_priority(prio),
     m_id(id),
-    m_force_outdated(false),
     m_message_code(0)
 {
 }
 
 
 template <typename T>
-bool DataToSend<T>::needsSending(int, double secs)
+float DataToSend<T>::sendInterval(unsigned char prio)
 {
-    double interval;
     //TODO: Check for ticks if necessary
-    switch (m_priority)
+    switch (prio)
     {
-        case PrioType::High : interval = 0.5;
-            break;
-        case PrioType::Middle : interval = 1;
-            break;
-        case PrioType::Low : interval = 3;
-            break;
-        case PrioType::Constant : interval = 15;
-            break;
-        default: interval = 15;
+        case PrioType::High : return 0.5;
+        case PrioType::Middle : return 1;
+        case PrioType::Low : return 3;
+        case PrioType::Constant : return 15;
+        default: return 15;
     }
-    return (this->m_hasChanged || secs - m_secsLastSent > interval || m_force_outdated);
-}
-
-template <typename T>
-bool DataToSend<T>::markAsSent(int ticks, double secs)
-{
-    m_ticksLastSent = ticks;
-    m_secsLastSent = secs;
-    m_force_outdated = false;
-    this->m_hasChanged = false;
-    return (m_ticksLastSent != 0);
-}
-
-template <typename T>
-void DataToSend<T>::makeOutDated()
-{
-    m_force_outdated = true;
 }
 
 #endif
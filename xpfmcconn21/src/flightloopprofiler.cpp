@@ -0,0 +1,209 @@
+#include "flightloopprofiler.h"
+#include "owneddata.h"
+#include "plugin_defines.h"
+
+#ifdef WIN_32
+#include <windows.h>
+#elif defined(__linux__)
+#include <time.h>
+#else
+#include <sys/time.h>
+#endif
+
+#define PROFILER_DATAREF_PREFIX "plugins/org/vasproject/xpfmcconn/profiler/"
+
+FlightLoopProfiler::Section::Section(const std::string& section_name):
+        name(section_name),
+        calls(0),
+        totalMicros(0),
+        maxMicros(0),
+        avgRef(0),
+        maxRef(0),
+        callsRef(0)
+{}
+
+FlightLoopProfiler::FlightLoopProfiler(std::ostream& logfile):
+        m_logfile(logfile),
+        m_published(false),
+        m_windowStart(-1),
+        m_lastDump(0),
+        m_messages(0),
+        m_queueDepth(0),
+        m_totalRef(0),
+        m_messagesRef(0),
+        m_queueDepthRef(0),
+        m_logIntervalRef(0)
+{
+    m_sections.reserve(callbackCount + 8);
+    addSection("high_prio");
+    addSection("prepare_send");
+    addSection("send_queued");
+    addSection("read_data");
+}
+
+FlightLoopProfiler::~FlightLoopProfiler()
+{
+    unpublishData();
+}
+
+double FlightLoopProfiler::nowMicros()
+{
+#ifdef WIN_32
+    static LARGE_INTEGER frequency = { { 0, 0 } };
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return double(counter.QuadPart) * 1e6 / double(frequency.QuadPart);
+#elif defined(__linux__)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+#else
+    struct timeval now;
+    gettimeofday(&now, 0);
+    return now.tv_sec * 1e6 + now.tv_usec;
+#endif
+}
+
+int FlightLoopProfiler::addSection(const std::string& name)
+{
+    for (unsigned int i = 0 ; i < m_sections.size() ; i++)
+        if (m_sections[i].name == name)
+            return i;
+    m_sections.push_back(Section(name));
+    if (m_published)
+        publishSection(m_sections.back());
+    return m_sections.size() - 1;
+}
+
+void FlightLoopProfiler::record(int section, double micros)
+{
+    Section& s = m_sections[section];
+    s.calls++;
+    s.totalMicros += micros;
+    if (micros > s.maxMicros)
+        s.maxMicros = micros;
+}
+
+void FlightLoopProfiler::update(double secs)
+{
+    if (m_windowStart < 0 || secs < m_windowStart)
+    {
+        m_windowStart = secs;
+        m_lastDump = secs;
+        return;
+    }
+    double window = secs - m_windowStart;
+    if (window < PROFILER_WINDOW_SECS)
+        return;
+
+    double total = 0;
+    for (unsigned int i = 0 ; i < m_sections.size() ; i++)
+    {
+        Section& s = m_sections[i];
+        total += s.totalMicros;
+        if (!m_published)
+            continue;
+        s.avgRef->set(s.calls > 0 ? float(s.totalMicros / s.calls) : 0.0f);
+        s.maxRef->set(float(s.maxMicros));
+        s.callsRef->set(float(s.calls / window));
+    }
+    if (m_published)
+    {
+        m_totalRef->set(float(total / window));
+        m_messagesRef->set(float(m_messages / window));
+        m_queueDepthRef->set(int(m_queueDepth));
+
+        int log_interval = m_logIntervalRef->data();
+        if (log_interval > 0 && secs - m_lastDump >= log_interval)
+        {
+            dump(window);
+            m_lastDump = secs;
+        }
+    }
+
+    for (unsigned int i = 0 ; i < m_sections.size() ; i++)
+    {
+        m_sections[i].calls = 0;
+        m_sections[i].totalMicros = 0;
+        m_sections[i].maxMicros = 0;
+    }
+    m_messages = 0;
+    m_windowStart = secs;
+}
+
+void FlightLoopProfiler::dump(double window)
+{
+    m_logfile << "Profiler: " << m_totalRef->data() << " us/s, " << m_messagesRef->data() << " msgs/s, queue "
+            << m_queueDepth << " (last " << window << " s)" << std::endl;
+    for (unsigned int i = 0 ; i < m_sections.size() ; i++)
+    {
+        Section& s = m_sections[i];
+        m_logfile << "Profiler:   " << s.name << " avg " << s.avgRef->data() << " us, max "
+                << s.maxRef->data() << " us, " << s.callsRef->data() << " calls/s" << std::endl;
+    }
+}
+
+void FlightLoopProfiler::publishSection(Section& section)
+{
+    std::string prefix = PROFILER_DATAREF_PREFIX + section.name + "/";
+    section.avgRef = new OwnedData<float>(prefix + "avg_us");
+    section.maxRef = new OwnedData<float>(prefix + "max_us");
+    section.callsRef = new OwnedData<float>(prefix + "calls_per_sec");
+    section.avgRef->registerRead();
+    section.maxRef->registerRead();
+    section.callsRef->registerRead();
+}
+
+void FlightLoopProfiler::unpublishSection(Section& section)
+{
+    section.avgRef->unregister();
+    section.maxRef->unregister();
+    section.callsRef->unregister();
+    delete section.avgRef;
+    delete section.maxRef;
+    delete section.callsRef;
+    section.avgRef = 0;
+    section.maxRef = 0;
+    section.callsRef = 0;
+}
+
+void FlightLoopProfiler::publishData()
+{
+    if (m_published)
+        return;
+    m_totalRef = new OwnedData<float>(PROFILER_DATAREF_PREFIX "us_per_sec");
+    m_messagesRef = new OwnedData<float>(PROFILER_DATAREF_PREFIX "msgs_per_sec");
+    m_queueDepthRef = new OwnedData<int>(PROFILER_DATAREF_PREFIX "queue_depth");
+    m_logIntervalRef = new OwnedData<int>(PROFILER_DATAREF_PREFIX "log_interval");
+    m_totalRef->registerRead();
+    m_messagesRef->registerRead();
+    m_queueDepthRef->registerRead();
+    m_logIntervalRef->registerReadWrite();
+    m_logIntervalRef->set(PROFILER_LOG_INTERVAL_SECS);
+    for (unsigned int i = 0 ; i < m_sections.size() ; i++)
+        publishSection(m_sections[i]);
+    m_published = true;
+}
+
+void FlightLoopProfiler::unpublishData()
+{
+    if (!m_published)
+        return;
+    m_published = false;
+    for (unsigned int i = 0 ; i < m_sections.size() ; i++)
+        unpublishSection(m_sections[i]);
+    m_totalRef->unregister();
+    m_messagesRef->unregister();
+    m_queueDepthRef->unregister();
+    m_logIntervalRef->unregister();
+    delete m_totalRef;
+    delete m_messagesRef;
+    delete m_queueDepthRef;
+    delete m_logIntervalRef;
+    m_totalRef = 0;
+    m_messagesRef = 0;
+    m_queueDepthRef = 0;
+    m_logIntervalRef = 0;
+}
@@ -0,0 +1,121 @@
+#ifndef FLIGHTLOOPPROFILER_H
+#define FLIGHTLOOPPROFILER_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+template <typename T>
+class OwnedData;
+
+    /**
+     * measures the time spent in the flight loop callbacks of the plugin and in
+     * the processState of each LogicHandler, together with the send queue depth
+     * and the messages sent per second. The figures of the last
+     * PROFILER_WINDOW_SECS are published as datarefs below
+     * plugins/org/vasproject/xpfmcconn/profiler/ and, if the writable dataref
+     * profiler/log_interval is set to a number of seconds, dumped to the log
+     * that often.
+     * @file flightloopprofiler.h
+     */
+class FlightLoopProfiler
+{
+public:
+    /**
+      * the sections of the flight loop callbacks, the LogicHandlers are added behind
+      */
+    enum Callback {
+        HighPrio,
+        PrepareSend,
+        SendQueued,
+        ReadData,
+        callbackCount
+    };
+
+    FlightLoopProfiler(std::ostream& logfile);
+    ~FlightLoopProfiler();
+
+    /**
+      * @return a monotonic time stamp in microseconds, with the best resolution of the platform
+      */
+    static double nowMicros();
+
+    /**
+      * add a section, its datarefs are published along with the others
+      * @return index of the section for record()
+      */
+    int addSection(const std::string& name);
+
+    void record(int section, double micros);
+
+    void countMessages(unsigned int count) { m_messages += count; }
+
+    void setQueueDepth(unsigned int depth) { m_queueDepth = depth; }
+
+    /**
+      * close the window after PROFILER_WINDOW_SECS, publish it and dump it to the log if due
+      * @param secs elapsed sim time
+      */
+    void update(double secs);
+
+    void publishData();
+
+    void unpublishData();
+
+private:
+    class Section
+    {
+    public:
+        Section(const std::string& section_name);
+        std::string name;
+        unsigned int calls;
+        double totalMicros;
+        double maxMicros;
+        OwnedData<float>* avgRef;
+        OwnedData<float>* maxRef;
+        OwnedData<float>* callsRef;
+    };
+
+    void publishSection(Section& section);
+    void unpublishSection(Section& section);
+    void dump(double window);
+
+    std::ostream& m_logfile;
+    std::vector<Section> m_sections;
+    bool m_published;
+
+    double m_windowStart;
+    double m_lastDump;
+    unsigned int m_messages;
+    unsigned int m_queueDepth;
+
+    OwnedData<float>* m_totalRef;
+    OwnedData<float>* m_messagesRef;
+    OwnedData<int>* m_queueDepthRef;
+    OwnedData<int>* m_logIntervalRef;
+};
+
+    /**
+     * times its own lifetime and records it in the given section
+     */
+class ProfilerScope
+{
+public:
+    ProfilerScope(FlightLoopProfiler& profiler, int section):
+            m_profiler(profiler),
+            m_section(section),
+            m_start(FlightLoopProfiler::nowMicros())
+    {}
+
+    ~ProfilerScope()
+    {
+        m_profiler.record(m_section, FlightLoopProfiler::nowMicros() - m_start);
+    }
+
+private:
+    FlightLoopProfiler& m_profiler;
+    int m_section;
+    double m_start;
+};
+
+#endif // FLIGHTLOOPPROFILER_H
@@ -7,3 +7,8 @@
 #include <ctime>		// time related stuff
 
 #define BUFF_LEN 50
+
+// max. number of datagrams sent or received with one sendmmsg/recvmmsg call
+#define UDP_MMSG_MAX_MESSAGES 64
+// max. size of a datagram received with recvmmsg
+#define UDP_MMSG_MAX_DATAGRAM 1472
@@ -1,9 +1,11 @@
 #include "logichandler.h"
 #include "XPLMProcessing.h"
+#include "flightloopprofiler.h"
 #include <iostream>
 #include <fstream>
 
 extern std::fstream m_logfile;
+extern FlightLoopProfiler flightLoopProfiler;
 
 float HandlerCallbackInit(float, float, int, void* inRefCon)
 {
@@ -16,7 +18,12 @@ float HandlerCallbackProcess(float, float, int, void* inRefCon)
 {
     LogicHandler* handler = static_cast<LogicHandler*>(inRefCon);
     if (!handler->isSuspended())
+    {
+        if (handler->m_profilerSection < 0)
+            handler->m_profilerSection = flightLoopProfiler.addSection(handler->name());
+        ProfilerScope scope(flightLoopProfiler, handler->m_profilerSection);
         handler->processState();
+    }
     else
         m_logfile << "Handler suspended " << handler->name() << std::endl;
     return handler->processingFrequency();
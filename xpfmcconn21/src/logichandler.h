@@ -15,7 +15,7 @@ class LogicHandler {
 
  public:
 
-    LogicHandler(std::ostream&) {}
+    LogicHandler(std::ostream&): m_profilerSection(-1) {}
 
     virtual ~LogicHandler(){}
 
@@ -84,6 +84,13 @@ class LogicHandler {
 
     void hookMeOff();
 
+ private:
+
+    /**
+      * section of the processState timing in the flight loop profiler, -1 until the first call
+      */
+    int m_profilerSection;
+
 };
 
 #endif
@@ -1,12 +1,28 @@
 #ifndef PAKETWRITER_H
 #define PAKETWRITER_H
 
+#include <cstddef>
+
 class PaketWriter
 {
 public:
     PaketWriter(){}
     virtual ~PaketWriter() {}
     virtual long write(const void* data, size_t size) = 0;
+
+    /**
+      * writes count datagrams of the given size, which are stored one after
+      * the other in data. The default writes them one by one.
+      * @return the number of completely written datagrams
+      */
+    virtual long writeMany(const void* data, size_t size, unsigned int count)
+    {
+        const char* datagram = static_cast<const char*>(data);
+        long written = 0;
+        for (unsigned int i = 0; i < count; i++, datagram += size)
+            if (write(datagram, size) == long(size)) written++;
+        return written;
+    }
 };
 
 #endif // PAKETWRITER_H
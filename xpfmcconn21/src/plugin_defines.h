@@ -17,6 +17,40 @@
 #define CFG_FAST_NETWORK_DEFAULT "true"
 #define CFG_POLLING_POLICY_DEFAULT "time"
 
+// max. number of messages from vasFMC processed in one flight loop callback
+#define CANAS_MAX_READ_PER_CALL 256
+
+// timing wheel of the send deadlines in DataContainer, it must span the longest send interval
+#define SEND_WHEEL_BUCKETS 256
+#define SEND_WHEEL_TICK_SECS 0.1
+
+// interval of the state vector keyframes, deltas to the last keyframe are sent in between
+#define STATE_KEYFRAME_INTERVAL_SECS 1.0
+// flight loops between two state vectors, the high priority data is read this often then
+#define STATE_VECTOR_LOOPS 2
+
+// vasFMC instances receiving the data, a subscriber not heard of for the timeout is removed
+#define MAX_SUBSCRIBERS 8
+#define SUBSCRIBER_TIMEOUT_SECS 17.0
+// a subscriber not heard of for that long gets an STS every retry interval, its answer keeps it subscribed
+#define SUBSCRIBER_KEEPALIVE_SECS 14.0
+#define SUBSCRIBER_KEEPALIVE_RETRY_SECS 1.0
+
+// a vasFMC reading the shared memory ring must show it is alive this often, else UDP is used again
+#define SHM_READER_TIMEOUT_SECS 1.0
+
+// navaid lookup of RadioNav: tables per frequency and region (degrees), the resolved
+// navaids are cached per tile (degrees) and looked up again after the aircraft moved
+#define NAVAID_REGION_DEG 10
+#define NAVAID_CACHE_TILE_DEG 1
+#define NAVAID_CACHE_MAX 1024
+#define NAVAID_REQUERY_NM 5.0
+
+// the flight loop profiler publishes its figures this often, and dumps them to the log
+// every log interval seconds if the interval is not 0 (it can be changed by its dataref)
+#define PROFILER_WINDOW_SECS 1.0
+#define PROFILER_LOG_INTERVAL_SECS 0
+
 #define PLUGIN_VERSION 210
 
 #endif // PLUGIN_DEFINES_H
@@ -6,6 +6,8 @@
 
 #include <stdint.h>
 
+#include "priotype.h"
+
 template<typename T>
 class DataToSend;
 
@@ -20,10 +22,10 @@ public:
     virtual void protocolWrite(DataToSend<bool>& data) = 0;
     virtual void protocolWrite(DataToSend<std::string>& data) = 0;
     virtual void protocolWrite(DataToSend<std::vector<float> >& data) = 0;
-    virtual void protocolWrite(uint32_t id, float data, uint8_t message_code) = 0;
-    virtual void protocolWrite(uint32_t id, int data, uint8_t message_code) = 0;
-    virtual void protocolWrite(uint32_t id, bool data, uint8_t message_code) = 0;
-    virtual void protocolWrite(uint32_t id, std::string data, uint8_t message_code) = 0;
+    virtual void protocolWrite(uint32_t id, float data, uint8_t message_code, unsigned char prio = PrioType::Middle) = 0;
+    virtual void protocolWrite(uint32_t id, int data, uint8_t message_code, unsigned char prio = PrioType::Middle) = 0;
+    virtual void protocolWrite(uint32_t id, bool data, uint8_t message_code, unsigned char prio = PrioType::Middle) = 0;
+    virtual void protocolWrite(uint32_t id, std::string data, uint8_t message_code, unsigned char prio = PrioType::Middle) = 0;
     virtual unsigned int writeAll() = 0;
     virtual unsigned int writeMax(unsigned int max) = 0;
 };
@@ -3,6 +3,7 @@
 #include "owneddata.h"
 #include "navcalc.h"
 #include "protocolstreamer.h"
+#include "plugin_defines.h"
 
 #include "fsaccess_xplane_refids.h"
 
@@ -11,8 +12,30 @@
 
 #include "stdint.h"
 
+static int tileOf(double lat, double lon, int tile_deg)
+{
+    int row = int(floor((lat + 90.0) / tile_deg));
+    int col = int(floor((lon + 180.0) / tile_deg));
+    int cols = 360 / tile_deg;
+    col = ((col % cols) + cols) % cols;
+    return row * cols + col;
+}
+
+static int64_t regionKey(int freq, int region)
+{
+    return (int64_t(freq) << 32) | region;
+}
+
+static int64_t cacheKey(int freq, XPLMNavType type, double lat, double lon)
+{
+    return (int64_t(freq) << 32) | (int64_t(type) << 16) | tileOf(lat, lon, NAVAID_CACHE_TILE_DEG);
+}
+
 RadioNav::RadioNav(std::ostream& logfile):
         LogicHandler(logfile),
+    m_lookupValid(false),
+    m_lookupLat(0),
+    m_lookupLon(0),
     m_navReceiverStates(0),
     m_nav1Freq(0),
     m_nav2Freq(0),
@@ -118,6 +141,7 @@ bool RadioNav::initState()
         m_n2HasDME->poll();
         m_airplaneLat->poll();
         m_airplaneLon->poll();
+        buildNavAidTables();
         m_logfile << "RadioNav Handler initialized (from com.flightpanels.universal_communications_bus)" << std::endl;
     }
     return false;
@@ -137,12 +161,18 @@ bool RadioNav::processState()
     m_n2HasDME->poll();
     m_airplaneLat->poll();
     m_airplaneLon->poll();
+    // the nearest navaid on a frequency only changes after a long way
+    bool moved = !m_lookupValid ||
+                 range(m_lookupLat, m_lookupLon, m_airplaneLat->data(), m_airplaneLon->data()) > NAVAID_REQUERY_NM;
     if (m_nav1Freq->hasChanged() || m_nav2Freq->hasChanged() ||
         m_adf1Freq->hasChanged() || m_adf2Freq->hasChanged() ||
         m_n1HasDME->hasChanged() || m_n2HasDME->hasChanged() ||
-        m_navReceiverStates->hasChanged() || true )
+        m_navReceiverStates->hasChanged() || moved )
     {
         m_has_changed = true;
+        m_lookupValid = true;
+        m_lookupLat = m_airplaneLat->data();
+        m_lookupLon = m_airplaneLon->data();
         const std::vector<int>& navmode = m_navReceiverStates->data();
         std::vector<int> freqs;
         freqs.push_back(m_nav1Freq->data()); freqs.push_back(m_nav2Freq->data());
@@ -553,9 +583,83 @@ bool RadioNav::writeToStream(ProtocolStreamer* streamer)
     return true;
 }
 
+void RadioNav::buildNavAidTables()
+{
+    m_regionTables.clear();
+    m_navaidCache.clear();
+    XPLMNavType types = xplm_Nav_NDB | xplm_Nav_VOR | xplm_Nav_ILS | xplm_Nav_Localizer;
+    unsigned int count = 0;
+    for (XPLMNavRef ref = XPLMGetFirstNavAid() ; ref != XPLM_NAV_NOT_FOUND ; ref = XPLMGetNextNavAid(ref))
+    {
+        tableEntry entry;
+        int freq = 0;
+        entry.ref = ref;
+        XPLMGetNavAidInfo(ref, &entry.type, &entry.lat, &entry.lon, NULL, &freq, NULL, NULL, NULL, NULL);
+        if ((entry.type & types) == 0)
+            continue;
+        m_regionTables[regionKey(freq, tileOf(entry.lat, entry.lon, NAVAID_REGION_DEG))].push_back(entry);
+        count++;
+    }
+    m_logfile << "RadioNav: " << count << " navaids in " << m_regionTables.size() << " frequency/region tables" << std::endl;
+}
+
+XPLMNavRef RadioNav::findInTables(int freq, float lat, float lon, XPLMNavType type)
+{
+    XPLMNavRef nearest = XPLM_NAV_NOT_FOUND;
+    float nearest_dist = 0;
+    // the neighbours cover more than the range of any navaid
+    for (int dlat = -1 ; dlat <= 1 ; dlat++)
+    {
+        double region_lat = lat + dlat * NAVAID_REGION_DEG;
+        if (region_lat < -90.0 || region_lat >= 90.0)
+            continue;
+        for (int dlon = -1 ; dlon <= 1 ; dlon++)
+        {
+            std::map<int64_t, std::vector<tableEntry> >::const_iterator table =
+                    m_regionTables.find(regionKey(freq, tileOf(region_lat, lon + dlon * NAVAID_REGION_DEG, NAVAID_REGION_DEG)));
+            if (table == m_regionTables.end())
+                continue;
+            const std::vector<tableEntry>& entries = table->second;
+            for (unsigned int i = 0 ; i < entries.size() ; i++)
+            {
+                if ((entries[i].type & type) == 0)
+                    continue;
+                float dist = range(entries[i].lat, entries[i].lon, lat, lon);
+                if (nearest == XPLM_NAV_NOT_FOUND || dist < nearest_dist)
+                {
+                    nearest = entries[i].ref;
+                    nearest_dist = dist;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
 navaid RadioNav::locateNavAid(int freq, float lat, float lon, XPLMNavType type, bool has_dme)
 {
-    XPLMNavRef navaidref = XPLMFindNavAid(NULL,NULL,&lat,&lon,&freq,type);
+    int64_t key = cacheKey(freq, type, lat, lon);
+    std::map<int64_t, navaid>::iterator cached = m_navaidCache.find(key);
+    if (cached != m_navaidCache.end())
+    {
+        navaid out = cached->second;
+        out.HasDME = has_dme;
+        return out;
+    }
+
+    XPLMNavRef navaidref = findInTables(freq, lat, lon, type);
+    if (navaidref == XPLM_NAV_NOT_FOUND)
+        navaidref = XPLMFindNavAid(NULL,NULL,&lat,&lon,&freq,type);
+
+    if (m_navaidCache.size() >= NAVAID_CACHE_MAX)
+        m_navaidCache.clear();
+    navaid out = navAidInfo(navaidref, type, has_dme);
+    m_navaidCache[key] = out;
+    return out;
+}
+
+navaid RadioNav::navAidInfo(XPLMNavRef navaidref, XPLMNavType type, bool has_dme)
+{
     if(navaidref == XPLM_NAV_NOT_FOUND)
         return navaid();
     XPLMNavType outType = 0;
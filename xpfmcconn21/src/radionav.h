@@ -4,9 +4,13 @@
 #include "logichandler.h"
 
 #include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
 #include "XPLMNavigation.h"
 
 struct navaid {
+    navaid(): Lat(0), Lon(0), Freq(0), HasDME(false), HasLoc(false), crs(0) {}
     std::string Id,
                 Name;
     float Lat, Lon;
@@ -87,8 +91,49 @@ public:
 
     bool m_has_changed;
 
+    /**
+      * the navaid with the given frequency and type nearest to the position,
+      * from the cache or the region tables, the SDK is only asked if the tables know none
+      */
     navaid locateNavAid(int freq, float lat, float lon, XPLMNavType type, bool has_dme=false);
 
+    /**
+      * the navaid with the given frequency and type nearest to the position in the region
+      * of the position and its neighbours, XPLM_NAV_NOT_FOUND if there is none
+      */
+    XPLMNavRef findInTables(int freq, float lat, float lon, XPLMNavType type);
+
+    navaid navAidInfo(XPLMNavRef navaidref, XPLMNavType type, bool has_dme);
+
+    /**
+      * sort the NDBs, VORs and localizers of the nav database into tables per
+      * frequency and region, done once at plane load
+      */
+    void buildNavAidTables();
+
+    struct tableEntry {
+        XPLMNavRef ref;
+        XPLMNavType type;
+        float lat, lon;
+    };
+
+    /**
+      * navaids by frequency and region of NAVAID_REGION_DEG, see regionKey()
+      */
+    std::map<int64_t, std::vector<tableEntry> > m_regionTables;
+
+    /**
+      * resolved navaids by frequency, type and tile of NAVAID_CACHE_TILE_DEG, see cacheKey()
+      */
+    std::map<int64_t, navaid> m_navaidCache;
+
+    /**
+      * position of the last lookup, the navaids are looked up again after NAVAID_REQUERY_NM
+      */
+    bool m_lookupValid;
+    double m_lookupLat;
+    double m_lookupLon;
+
     SimData<std::vector<int> >* m_navReceiverStates;
     SimData<int>* m_nav1Freq;
     SimData<int>* m_nav2Freq;
@@ -0,0 +1,239 @@
+#include "sharedmemorywriter.h"
+#include "plugin_defines.h"
+
+#include <cstring>
+#include <fstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+extern std::fstream m_logfile;
+
+SharedMemoryWriter::SharedMemoryWriter(PaketWriter* udp):
+        m_udp(udp),
+        m_fd(-1),
+        m_ring(0),
+        m_records(0),
+        m_active(false),
+        m_udp_enabled(true),
+        m_last_heartbeat(0),
+        m_heartbeat_secs(0),
+        m_overflow_count(0)
+{}
+
+SharedMemoryWriter::~SharedMemoryWriter()
+{
+    close();
+}
+
+bool SharedMemoryWriter::open()
+{
+#ifdef __linux__
+    if (m_ring)
+        return true;
+
+    shm_unlink(CANAS_SHM_NAME);
+    m_fd = shm_open(CANAS_SHM_NAME, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (m_fd < 0)
+    {
+        m_logfile << "Could not create shared memory " << CANAS_SHM_NAME << ", using UDP only" << std::endl;
+        return false;
+    }
+
+    size_t bytes = sizeof(canAS_shm_ring_t) + CANAS_SHM_CAPACITY;
+    void* memory = MAP_FAILED;
+    if (ftruncate(m_fd, bytes) == 0)
+        memory = mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        m_logfile << "Could not map shared memory " << CANAS_SHM_NAME << ", using UDP only" << std::endl;
+        ::close(m_fd);
+        m_fd = -1;
+        shm_unlink(CANAS_SHM_NAME);
+        return false;
+    }
+
+    m_ring = static_cast<canAS_shm_ring_t*>(memory);
+    m_records = static_cast<char*>(memory) + sizeof(canAS_shm_ring_t);
+    memset(m_ring, 0, sizeof(canAS_shm_ring_t));
+    m_ring->version = CANAS_SHM_VERSION;
+    m_ring->capacity = CANAS_SHM_CAPACITY;
+    m_ring->writer_pid = getpid();
+    // readers only accept the ring once the magic is there
+    __atomic_store_n(&m_ring->magic, CANAS_SHM_MAGIC, __ATOMIC_RELEASE);
+    m_logfile << "Shared memory " << CANAS_SHM_NAME << " ready for vasFMC on this host" << std::endl;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SharedMemoryWriter::close()
+{
+#ifdef __linux__
+    m_active = false;
+    if (!m_ring)
+        return;
+    munmap(m_ring, sizeof(canAS_shm_ring_t) + CANAS_SHM_CAPACITY);
+    m_ring = 0;
+    m_records = 0;
+    ::close(m_fd);
+    m_fd = -1;
+    shm_unlink(CANAS_SHM_NAME);
+#endif
+}
+
+void SharedMemoryWriter::activate(double secs)
+{
+#ifdef __linux__
+    if (!m_ring || m_active)
+        return;
+    m_active = true;
+    __atomic_store_n(&m_ring->ring_active, 1, __ATOMIC_RELEASE);
+    m_last_heartbeat = __atomic_load_n(&m_ring->reader_heartbeat, __ATOMIC_ACQUIRE);
+    m_heartbeat_secs = secs;
+    m_logfile << "Writing to shared memory" << std::endl;
+#else
+    (void)secs;
+#endif
+}
+
+void SharedMemoryWriter::deactivate()
+{
+    if (!m_active)
+        return;
+    m_active = false;
+#ifdef __linux__
+    // cleared before the datagrams go to UDP, so the reader does not take them for duplicates
+    __atomic_store_n(&m_ring->ring_active, 0, __ATOMIC_RELEASE);
+#endif
+    m_logfile << "Stopped writing to shared memory, using UDP" << std::endl;
+}
+
+bool SharedMemoryWriter::checkReader(double secs)
+{
+#ifdef __linux__
+    if (!m_active)
+        return false;
+
+    uint32_t heartbeat = __atomic_load_n(&m_ring->reader_heartbeat, __ATOMIC_ACQUIRE);
+    if (heartbeat != m_last_heartbeat || secs < m_heartbeat_secs)
+    {
+        m_last_heartbeat = heartbeat;
+        m_heartbeat_secs = secs;
+        return true;
+    }
+    if (secs - m_heartbeat_secs < SHM_READER_TIMEOUT_SECS)
+        return true;
+
+    m_logfile << "Shared memory reader stalled" << std::endl;
+    deactivate();
+    return false;
+#else
+    (void)secs;
+    return false;
+#endif
+}
+
+bool SharedMemoryWriter::push(const void* data, size_t size)
+{
+#ifdef __linux__
+    uint64_t head = m_ring->head;
+    uint64_t tail = __atomic_load_n(&m_ring->tail, __ATOMIC_ACQUIRE);
+    uint32_t offset = uint32_t(head % CANAS_SHM_CAPACITY);
+    uint32_t to_end = CANAS_SHM_CAPACITY - offset;
+    uint32_t record = CANAS_SHM_RECORD_BYTES(size);
+
+    // a record never wraps, the rest of the ring is skipped instead
+    uint64_t needed = record;
+    if (record > to_end)
+        needed += to_end;
+    if (head - tail + needed > CANAS_SHM_CAPACITY)
+        return false;
+
+    if (record > to_end)
+    {
+        uint32_t wrap = CANAS_SHM_WRAP;
+        memcpy(m_records + offset, &wrap, sizeof(wrap));
+        head += to_end;
+        offset = 0;
+    }
+
+    uint32_t record_size = uint32_t(size);
+    memcpy(m_records + offset, &record_size, sizeof(record_size));
+    memcpy(m_records + offset + sizeof(record_size), data, size);
+    __atomic_store_n(&m_ring->head, head + record, __ATOMIC_SEQ_CST);
+    return true;
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+void SharedMemoryWriter::wake()
+{
+#ifdef __linux__
+    // the reader checks the head after announcing that it waits, so either
+    // it sees the new records or the changed futex word lets it return at once
+    __atomic_add_fetch(&m_ring->wakeup, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&m_ring->reader_waiting, __ATOMIC_SEQ_CST))
+        syscall(SYS_futex, &m_ring->wakeup, FUTEX_WAKE, 1, 0, 0, 0);
+#endif
+}
+
+void SharedMemoryWriter::overflow()
+{
+    m_overflow_count++;
+    m_logfile << "Shared memory ring full" << std::endl;
+    deactivate();
+}
+
+bool SharedMemoryWriter::writeRing(const void* data, size_t size)
+{
+    if (!m_active)
+        return false;
+    if (!push(data, size))
+    {
+        overflow();
+        return false;
+    }
+    wake();
+    return true;
+}
+
+long SharedMemoryWriter::write(const void* data, size_t size)
+{
+    writeRing(data, size);
+    if (useUdp())
+        return m_udp->write(data, size);
+    return size;
+}
+
+long SharedMemoryWriter::writeMany(const void* data, size_t size, unsigned int count)
+{
+    if (m_active)
+    {
+        const char* datagram = static_cast<const char*>(data);
+        unsigned int pushed = 0;
+        while (pushed < count && push(datagram + pushed * size, size))
+            pushed++;
+        if (pushed > 0)
+            wake();
+        if (pushed < count)
+        {
+            overflow();
+            // the rest goes to UDP only
+            if (!m_udp_enabled)
+                return pushed + m_udp->writeMany(datagram + pushed * size, size, count - pushed);
+        }
+    }
+    if (useUdp())
+        return m_udp->writeMany(data, size, count);
+    return count;
+}
@@ -0,0 +1,106 @@
+#ifndef SHAREDMEMORYWRITER_H
+#define SHAREDMEMORYWRITER_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "canas.h"
+#include "paketwriter.h"
+
+    /**
+     * writes the datagrams into the shared memory ring (see canAS_shm_ring_t)
+     * read by a vasFMC on the same host, and to the UDP writer as long as
+     * other subscribers need them. When the reader does not keep up or stops
+     * incrementing its heartbeat, the writer switches back to UDP on its own.
+     * The ring only exists on linux, elsewhere open() fails and everything
+     * goes to UDP.
+     * @file sharedmemorywriter.h
+     */
+class SharedMemoryWriter : public PaketWriter
+{
+public:
+    /**
+      * @param udp writer used when the ring is not active, the caller keeps the ownership
+      */
+    SharedMemoryWriter(PaketWriter* udp);
+    virtual ~SharedMemoryWriter();
+
+    /**
+      * create the ring, a ring left over by a crashed simulator is replaced
+      * @return false if shared memory is not available
+      */
+    bool open();
+
+    void close();
+
+    bool isOpen() { return m_ring != 0; }
+
+    /**
+      * start writing into the ring, the reader requested it with SHS
+      * @param secs elapsed sim time, the heartbeat of the reader is checked from then on
+      */
+    void activate(double secs);
+
+    void deactivate();
+
+    bool active() { return m_active; }
+
+    /**
+      * the datagrams are written to UDP as well while enabled, they always are while the ring is not active
+      */
+    void setUdpEnabled(bool enabled) { m_udp_enabled = enabled; }
+
+    /**
+      * deactivate the ring if the reader did not increment its heartbeat for SHM_READER_TIMEOUT_SECS
+      * @return true if the ring is still active
+      */
+    bool checkReader(double secs);
+
+    virtual long write(const void* data, size_t size);
+
+    /**
+      * writes the datagrams into the ring with one wake up of the reader
+      */
+    virtual long writeMany(const void* data, size_t size, unsigned int count);
+
+    /**
+      * write the datagram into the ring only
+      * @return false if the ring is not active or was full, the ring is deactivated then
+      */
+    bool writeRing(const void* data, size_t size);
+
+    /**
+      * @return how often the ring was full and the writer fell back to UDP
+      */
+    unsigned long overflowCount() { return m_overflow_count; }
+
+private:
+    /**
+      * append one record, without waking up the reader
+      * @return false if the ring is full
+      */
+    bool push(const void* data, size_t size);
+
+    /**
+      * publish the records, wakes up the reader if it waits for them
+      */
+    void wake();
+
+    /**
+      * deactivate the ring after a failed push, the datagrams go to UDP from now on
+      */
+    void overflow();
+
+    bool useUdp() { return m_udp_enabled || !m_active; }
+
+    PaketWriter* m_udp;
+    int m_fd;
+    canAS_shm_ring_t* m_ring;
+    char* m_records;
+    bool m_active;
+    bool m_udp_enabled;
+    uint32_t m_last_heartbeat;
+    double m_heartbeat_secs;
+    unsigned long m_overflow_count;
+};
+
+#endif // SHAREDMEMORYWRITER_H
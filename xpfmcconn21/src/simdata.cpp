@@ -66,28 +66,46 @@ bool SimData<bool>::poll()
     return updateValue(((int)XPLMGetDatai(m_pDataRef))==1);
 }
 
+// takes over the polled items which differ by more than epsilon from the stored ones
+template <typename V>
+static bool mergePolledItems(std::vector<V>& data, const std::vector<V>& polled, double epsilon)
+{
+    bool changed = false;
+    for(uint i=0;i<polled.size();i++)
+    {
+        if (fabs(double(polled[i] - data[i])) > epsilon) {
+            data[i] = polled[i];
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 template <>
 bool SimData<std::vector<float> >::poll()
 {
-    float values[BUF_SIZE];
-
-    MYASSERT(m_no_of_items < BUF_SIZE);
-
     if(m_readWrite == RWType::WriteOnly) return false;
+    if (m_pollBuffer.empty()) return true;
 
-    XPLMGetDatavf(this->m_pDataRef,values,0,m_no_of_items);
+    // fetch the whole range of the array at once into the preallocated buffer
+    XPLMGetDatavf(this->m_pDataRef,&m_pollBuffer[0],0,m_pollBuffer.size());
 
-    return updateValue(std::vector<float>(values,values + m_no_of_items));
+    if (mergePolledItems(m_data, m_pollBuffer, epsilon()))
+        m_hasChanged = true;
+    return true;
 }
 
 template <>
 bool SimData<std::vector<int> >::poll()
 {
     if(m_readWrite == RWType::WriteOnly) return false;
-    MYASSERT(m_no_of_items < BUF_SIZE);
-    int values[BUF_SIZE];
-    XPLMGetDatavi(this->m_pDataRef,values,0,m_no_of_items);
-    return updateValue(std::vector<int>(values, values + sizeof(values)/sizeof(int)));
+    if (m_pollBuffer.empty()) return true;
+
+    XPLMGetDatavi(this->m_pDataRef,&m_pollBuffer[0],0,m_pollBuffer.size());
+
+    if (mergePolledItems(m_data, m_pollBuffer, epsilon()))
+        m_hasChanged = true;
+    return true;
 }
 
 template <>
@@ -97,8 +115,11 @@ bool SimData<std::string>::poll()
     if(m_readWrite == RWType::WriteOnly) return false;
     long n = XPLMGetDatab(this->m_pDataRef,NULL,0,0);
     MYASSERT(n < BUF_SIZE);
-    XPLMGetDatab(this->m_pDataRef, outString, 0, n);
-    return updateValue(std::string(outString));
+    n = XPLMGetDatab(this->m_pDataRef, outString, 0, n);
+    outString[n] = 0;
+    // only touch the stored string when it differs, assign() reuses its storage
+    if (m_data.compare(outString) == 0) return true;
+    return updateValue(outString);
 }
 
 /////////////////////////////
@@ -213,6 +234,7 @@ bool SimData<std::vector<float> >::checkDataType()
     if (m_no_of_items == 0)
         m_no_of_items = XPLMGetDatavf(this->m_pDataRef,NULL,0,0);
     m_data.resize(m_no_of_items);
+    m_pollBuffer.resize(m_no_of_items);
     return (DataTypeID == xplmType_FloatArray);
 }
 
@@ -223,6 +245,7 @@ bool SimData<std::vector<int> >::checkDataType()
     if (m_no_of_items == 0)
         m_no_of_items = XPLMGetDatavi(this->m_pDataRef,NULL,0,0);
     m_data.resize(m_no_of_items);
+    m_pollBuffer.resize(m_no_of_items);
     return (DataTypeID == xplmType_IntArray);
 }
 
@@ -249,7 +272,7 @@ bool SimData<bool>::updateValue(bool data)
 template <>
 bool SimData<int>::updateValue(int data)
 {
-    if (abs(m_data - data) > m_epsilon) {
+    if (abs(m_data - data) > epsilon()) {
         m_data = data;
         m_hasChanged = true;
         return (m_hasChanged);
@@ -263,7 +286,7 @@ bool SimData<std::vector<float> >::updateValue(std::vector<float> data)
 
     for(uint i=0;i<data.size();i++)
     {
-        if (fabs(data[i] - m_data[i]) > m_epsilon) {
+        if (fabs(data[i] - m_data[i]) > epsilon()) {
             m_data[i] = data[i];
             m_hasChanged = true;
         }
@@ -276,7 +299,7 @@ bool SimData<std::vector<int> >::updateValue(std::vector<int> data)
 {
     for(uint i=0;i<data.size();i++)
     {
-        if (abs(data[i] - m_data[i]) > m_epsilon) {
+        if (abs(data[i] - m_data[i]) > epsilon()) {
             m_data[i] = data[i];
             m_hasChanged = true;
         }
@@ -413,6 +436,24 @@ std::vector<int> SimData<std::vector<int> >::data()
     return std::vector<int>(returnvector.begin(),returnvector.end());
 }
 
+template <>
+float SimData<std::vector<float> >::itemValue(unsigned int index)
+{
+    MYASSERT(index < m_data.size());
+    if (m_scale == 1 && m_offset == 0)
+        return m_data[index];
+    return static_cast<float>(m_data[index]*m_scale + m_offset);
+}
+
+template <>
+float SimData<std::vector<int> >::itemValue(unsigned int index)
+{
+    MYASSERT(index < m_data.size());
+    if (m_scale == 1 && m_offset == 0)
+        return m_data[index];
+    return float(ceil(m_data[index]*m_scale + m_offset));
+}
+
 template<>
 std::string SimData<std::string>::data()
 {
@@ -33,9 +33,11 @@
 
 #include "XPLMDataAccess.h"
 
+#ifdef WIN_32
 #ifndef isnan
 #define isnan _isnan
 #endif
+#endif
 
 extern std::fstream m_logfile;
 
@@ -108,13 +110,42 @@ class SimData : public DataRef<T>{
       */
     virtual void resetChanged() { m_hasChanged = false; }
 
+    /**
+      * number of items of an array dataref
+      * @return the number of items polled from X-Plane (0 for scalar datarefs)
+      */
+    unsigned int itemCount() { return m_no_of_items; }
+
+    /**
+      * access to a single item of an array dataref without copying the whole array
+      * @param index index of the item, must be less than itemCount()
+      * @return the item, scale and offset applied (no polling occurs at that moment!)
+      */
+    float itemValue(unsigned int index);
+
+    /**
+      * take over every change on poll(), ignoring eps, e.g. while the value is sent
+      * in a message with a finer resolution than eps
+      */
+    void setFullPrecision(bool full_precision) { m_fullPrecision = full_precision; }
+
  protected:
 
+    /**
+      * @return the threshold for taking over a polled value
+      */
+    double epsilon() const { return m_fullPrecision ? 0.0 : m_epsilon; }
+
     /**
      *  internal value was changed since last resetChanged() call
      */
     bool m_hasChanged;
 
+    /**
+     *  reusable storage poll() reads array datarefs into, sized once in checkDataType()
+     */
+    T m_pollBuffer;
+
  private:
 
     /**
@@ -165,6 +196,11 @@ class SimData : public DataRef<T>{
      */
     double m_epsilon;
 
+    /**
+     *  eps is ignored, see setFullPrecision()
+     */
+    bool m_fullPrecision;
+
     /**
      *  scale to apply to the value to put it out in correct units of measure. it is applied when getting the data via data() or setting via set()
      */
@@ -183,9 +219,11 @@ template <typename T>
 SimData<T>::SimData(const std::string& dataRefIdentifier, const std::string& name, short readWrite, 
                     double eps, double scale, double offset, unsigned int no_of_items):
 DataRef<T>(dataRefIdentifier),
+m_pollBuffer(T()),
 m_name(name),
 m_readWrite(readWrite),
 m_epsilon(eps),
+m_fullPrecision(false),
 m_scale(scale),
 m_offset(offset),
 m_no_of_items(no_of_items)
@@ -232,6 +270,19 @@ bool SimData<std::vector<int> >::poll();
 template <>
 bool SimData<std::string>::poll();
 
+template <typename T>
+float SimData<T>::itemValue(unsigned int)
+{
+    m_logfile << "itemValue called with incorrect type for " << m_name << std::endl;
+    return 0;
+}
+
+// specialized functions defined in .cpp-File
+template <>
+float SimData<std::vector<float> >::itemValue(unsigned int index);
+template <>
+float SimData<std::vector<int> >::itemValue(unsigned int index);
+
 // is the same for double and float
 template <typename T>
 bool SimData<T>::set(T data)
@@ -303,7 +354,7 @@ bool SimData<T>::updateValue(T data)
         this->m_data = 0;
         //exit(1);
     }
-    if (fabs(this->m_data - data) > m_epsilon) {
+    if (fabs(this->m_data - data) > epsilon()) {
         this->m_data = data;
         m_hasChanged = true;
         return (m_hasChanged);
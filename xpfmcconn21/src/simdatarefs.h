@@ -0,0 +1,16 @@
+#ifndef SIMDATAREFS_H
+#define SIMDATAREFS_H
+
+#include <vector>
+
+#include "datacontainer.h"
+
+/**
+  * registers the X-Plane datarefs sent to vasFMC in the given containers.
+  * Used by the plugin and by the standalone plugin stand-in, so both send the same stream.
+  */
+void addSimDataRefs(DataContainer<double>& doubleData, DataContainer<float>& floatData,
+                    DataContainer<int>& intData, DataContainer<bool>& boolData,
+                    DataContainer<std::vector<float> >& floatvectorData);
+
+#endif // SIMDATAREFS_H
@@ -0,0 +1,111 @@
+#include "statevector.h"
+
+#include <cstring>
+#include <math.h>
+
+#ifdef WIN_32
+#include <windows.h>
+#else
+#include <netinet/in.h>
+#endif
+
+// splits the double into two 32 bit words in network byte order, high word first
+static void putDouble(uint32_t* words, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    words[0] = htonl(uint32_t(bits >> 32));
+    words[1] = htonl(uint32_t(bits & 0xffffffff));
+}
+
+static int32_t quantise(double value, double quantum)
+{
+    return int32_t(floor(value / quantum + 0.5));
+}
+
+StateVectorWriter::StateVectorWriter():
+        m_enabled(false),
+        m_is_keyframe(false),
+        m_keyframe_valid(false),
+        m_keyframe_secs(0),
+        m_keyframe_sequence(0),
+        m_sequence(0),
+        m_keyframe_lat(0),
+        m_keyframe_lon(0),
+        m_keyframe_alt_ft(0)
+{}
+
+void StateVectorWriter::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    m_keyframe_valid = false;
+}
+
+size_t StateVectorWriter::build(double secs, double lat, double lon, double alt_ft,
+                                double heading, double pitch, double bank)
+{
+    if (!m_enabled)
+        return 0;
+
+    canAS_state_attitude_t attitude;
+    int32_t hdg = quantise(heading, CANAS_STATE_ANGLE_QUANTUM) % 36000;
+    if (hdg < 0)
+        hdg += 36000;
+    attitude.heading = htons(uint16_t(hdg));
+    attitude.pitch = htons(uint16_t(int16_t(quantise(pitch, CANAS_STATE_ANGLE_QUANTUM))));
+    attitude.bank = htons(uint16_t(int16_t(quantise(bank, CANAS_STATE_ANGLE_QUANTUM))));
+    attitude.reserved = 0;
+
+    m_is_keyframe = keyframeDue(secs);
+    if (m_is_keyframe)
+    {
+        m_keyframe_secs = secs;
+        return buildKeyframe(lat, lon, alt_ft, attitude);
+    }
+    return buildDelta(lat, lon, alt_ft, attitude);
+}
+
+void StateVectorWriter::fillHeader(canAS_state_header_t& header, uint8_t type)
+{
+    header.magic = htonl(CANAS_STATE_MAGIC);
+    header.type = type;
+    header.keyframe = m_keyframe_sequence;
+    header.sequence = htons(m_sequence++);
+}
+
+size_t StateVectorWriter::buildKeyframe(double lat, double lon, double alt_ft, const canAS_state_attitude_t& attitude)
+{
+    m_keyframe_sequence++;
+    m_keyframe_valid = true;
+    m_keyframe_lat = lat;
+    m_keyframe_lon = lon;
+    m_keyframe_alt_ft = alt_ft;
+
+    canAS_state_keyframe_t keyframe;
+    fillHeader(keyframe.header, CANAS_STATE_KEYFRAME);
+    putDouble(keyframe.lat, lat);
+    putDouble(keyframe.lon, lon);
+    putDouble(keyframe.alt, alt_ft);
+    keyframe.attitude = attitude;
+    memcpy(m_datagram, &keyframe, sizeof(keyframe));
+    return sizeof(keyframe);
+}
+
+size_t StateVectorWriter::buildDelta(double lat, double lon, double alt_ft, const canAS_state_attitude_t& attitude)
+{
+    double delta_lon = lon - m_keyframe_lon;
+    // crossing the date line
+    if (delta_lon > 180.0)
+        delta_lon -= 360.0;
+    else if (delta_lon < -180.0)
+        delta_lon += 360.0;
+
+    canAS_state_delta_t delta;
+    fillHeader(delta.header, CANAS_STATE_DELTA);
+    delta.lat = htonl(uint32_t(quantise(lat - m_keyframe_lat, CANAS_STATE_LATLON_QUANTUM)));
+    delta.lon = htonl(uint32_t(quantise(delta_lon, CANAS_STATE_LATLON_QUANTUM)));
+    delta.alt = htonl(uint32_t(quantise(alt_ft - m_keyframe_alt_ft, CANAS_STATE_ALT_QUANTUM)));
+    delta.attitude = attitude;
+    memcpy(m_datagram, &delta, sizeof(delta));
+    return sizeof(delta);
+}
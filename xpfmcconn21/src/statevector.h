@@ -0,0 +1,83 @@
+#ifndef STATEVECTOR_H
+#define STATEVECTOR_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "canas.h"
+#include "plugin_defines.h"
+
+    /**
+     * serialises position and attitude as compact state vectors (see canAS_state_header_t).
+     * A keyframe with the full precision position is built every
+     * STATE_KEYFRAME_INTERVAL_SECS, in between only the quantised deltas to the
+     * last keyframe are built. State vectors are only sent after vasFMC
+     * requested them with the SVS node service.
+     * @file statevector.h
+     */
+class StateVectorWriter
+{
+public:
+    StateVectorWriter();
+
+    /**
+      * switch state vectors on or off, switching on forces a keyframe
+      */
+    void setEnabled(bool enabled);
+
+    bool enabled() { return m_enabled; }
+
+    /**
+      * @return true if the next build() at the given time will serialise a keyframe
+      */
+    bool keyframeDue(double secs)
+    {
+        return !m_keyframe_valid || secs - m_keyframe_secs >= STATE_KEYFRAME_INTERVAL_SECS || secs < m_keyframe_secs;
+    }
+
+    /**
+      * serialise the state vector once, a keyframe if the last one is too old, a delta otherwise
+      * @param secs elapsed sim time
+      * @param lat latitude in degrees
+      * @param lon longitude in degrees
+      * @param alt_ft true altitude in feet
+      * @param heading true heading in degrees
+      * @param pitch pitch in degrees as sent with PITCH
+      * @param bank bank in degrees as sent with BANK
+      * @return size of the datagram, see datagram()
+      */
+    size_t build(double secs, double lat, double lon, double alt_ft, double heading, double pitch, double bank);
+
+    /**
+      * @return the datagram serialised by the last build()
+      */
+    const void* datagram() { return m_datagram; }
+
+    /**
+      * @return true if the last build() serialised a keyframe, the following
+      * deltas are useless to a receiver missing it
+      */
+    bool isKeyframe() { return m_is_keyframe; }
+
+private:
+    size_t buildKeyframe(double lat, double lon, double alt_ft, const canAS_state_attitude_t& attitude);
+    size_t buildDelta(double lat, double lon, double alt_ft, const canAS_state_attitude_t& attitude);
+    void fillHeader(canAS_state_header_t& header, uint8_t type);
+
+    bool m_enabled;
+    bool m_is_keyframe;
+    bool m_keyframe_valid;
+    double m_keyframe_secs;
+    uint8_t m_keyframe_sequence;
+    uint16_t m_sequence;
+
+    /**
+      * position of the last keyframe, the deltas refer to it
+      */
+    double m_keyframe_lat;
+    double m_keyframe_lon;
+    double m_keyframe_alt_ft;
+
+    char m_datagram[sizeof(canAS_state_keyframe_t)];
+};
+
+#endif // STATEVECTOR_H
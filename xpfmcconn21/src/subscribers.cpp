@@ -0,0 +1,137 @@
+#include "subscribers.h"
+#include "plugin_defines.h"
+
+#include <cstring>
+#include <fstream>
+
+extern std::fstream m_logfile;
+
+SubscriberList::Subscriber::Subscriber(const struct sockaddr_in& from, double secs):
+        address(from),
+        last_heard(secs),
+        last_keepalive(secs),
+        batched(false),
+        state_vectors(false),
+        state_vector_interval(0),
+        last_state_vector(0),
+        shared_memory(false)
+{}
+
+SubscriberList::SubscriberList()
+{
+    m_subscribers.reserve(MAX_SUBSCRIBERS);
+}
+
+SubscriberList::Subscriber& SubscriberList::heardFrom(const struct sockaddr_in& from, double secs)
+{
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; i++)
+    {
+        Subscriber& subscriber = m_subscribers[i];
+        if (subscriber.address.sin_addr.s_addr == from.sin_addr.s_addr &&
+            subscriber.address.sin_port == from.sin_port)
+        {
+            subscriber.last_heard = secs;
+            return subscriber;
+        }
+    }
+
+    if (m_subscribers.size() >= MAX_SUBSCRIBERS)
+    {
+        // replace the one we did not hear of for the longest time
+        unsigned int oldest = 0;
+        for (unsigned int i = 1 ; i < m_subscribers.size() ; i++)
+            if (m_subscribers[i].last_heard < m_subscribers[oldest].last_heard)
+                oldest = i;
+        m_subscribers.erase(m_subscribers.begin() + oldest);
+    }
+
+    m_logfile << "New subscriber " << inet_ntoa(from.sin_addr) << ":" << ntohs(from.sin_port) << std::endl;
+    m_subscribers.push_back(Subscriber(from, secs));
+    return m_subscribers.back();
+}
+
+unsigned int SubscriberList::expire(double secs)
+{
+    unsigned int removed = 0;
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; )
+    {
+        if (m_subscribers[i].last_heard + SUBSCRIBER_TIMEOUT_SECS < secs)
+        {
+            m_logfile << "Subscriber " << inet_ntoa(m_subscribers[i].address.sin_addr)
+                    << ":" << ntohs(m_subscribers[i].address.sin_port) << " timed out" << std::endl;
+            m_subscribers.erase(m_subscribers.begin() + i);
+            removed++;
+        } else
+        {
+            i++;
+        }
+    }
+    return removed;
+}
+
+unsigned int SubscriberList::removeUnreachable(const std::vector<struct sockaddr_in>& destinations)
+{
+    unsigned int removed = 0;
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; )
+    {
+        // the subscribers of one host share the destination they listen on
+        bool unreachable = false;
+        for (unsigned int j = 0 ; j < destinations.size() ; j++)
+            if (m_subscribers[i].address.sin_addr.s_addr == destinations[j].sin_addr.s_addr)
+                unreachable = true;
+        if (unreachable)
+        {
+            m_logfile << "Subscriber " << inet_ntoa(m_subscribers[i].address.sin_addr)
+                    << ":" << ntohs(m_subscribers[i].address.sin_port) << " is unreachable" << std::endl;
+            m_subscribers.erase(m_subscribers.begin() + i);
+            removed++;
+        } else
+        {
+            i++;
+        }
+    }
+    return removed;
+}
+
+bool SubscriberList::allBatched() const
+{
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; i++)
+        if (!m_subscribers[i].batched)
+            return false;
+    return !m_subscribers.empty();
+}
+
+bool SubscriberList::allStateVectors() const
+{
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; i++)
+        if (!m_subscribers[i].state_vectors)
+            return false;
+    return !m_subscribers.empty();
+}
+
+int SubscriberList::sharedMemoryReader() const
+{
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; i++)
+        if (m_subscribers[i].shared_memory)
+            return i;
+    return -1;
+}
+
+void SubscriberList::destinations(unsigned short port, bool skip_shared_memory, std::vector<struct sockaddr_in>& addresses) const
+{
+    addresses.clear();
+    for (unsigned int i = 0 ; i < m_subscribers.size() ; i++)
+    {
+        if (skip_shared_memory && m_subscribers[i].shared_memory)
+            continue;
+        struct sockaddr_in address = m_subscribers[i].address;
+        address.sin_port = htons(port);
+        // several subscribers on one host share the port they listen on
+        bool known = false;
+        for (unsigned int j = 0 ; j < addresses.size() ; j++)
+            if (addresses[j].sin_addr.s_addr == address.sin_addr.s_addr)
+                known = true;
+        if (!known)
+            addresses.push_back(address);
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef SUBSCRIBERS_H
+#define SUBSCRIBERS_H
+
+#include <vector>
+#include "network_config.h"
+
+    /**
+     * the vasFMC instances (captain, FO, instructor, ...) receiving the data of the plugin.
+     * A subscriber is known by the address its requests come from, it is added
+     * with its first message and removed when it was not heard of for
+     * SUBSCRIBER_TIMEOUT_SECS. Each subscriber negotiates batched frames and
+     * state vectors on its own, the common stream only uses what all of them
+     * understand. One subscriber on the host of the simulator may read the
+     * shared memory ring.
+     * @file subscribers.h
+     */
+class SubscriberList
+{
+public:
+
+    class Subscriber
+    {
+    public:
+        Subscriber(const struct sockaddr_in& from, double secs);
+
+        /**
+          * address the messages of the subscriber come from
+          */
+        struct sockaddr_in address;
+        double last_heard;
+
+        /**
+          * when the last keep alive STS was sent to the subscriber
+          */
+        double last_keepalive;
+        bool batched;
+        bool state_vectors;
+
+        /**
+          * min. seconds between two state vectors, 0 for as often as they are written
+          */
+        double state_vector_interval;
+        double last_state_vector;
+
+        /**
+          * reads the shared memory ring instead of the UDP socket
+          */
+        bool shared_memory;
+    };
+
+    SubscriberList();
+
+    /**
+      * update the time the subscriber was heard of, adds it if it is not known yet
+      * @return the subscriber
+      */
+    Subscriber& heardFrom(const struct sockaddr_in& from, double secs);
+
+    /**
+      * remove the subscribers not heard of for SUBSCRIBER_TIMEOUT_SECS
+      * @return number of removed subscribers
+      */
+    unsigned int expire(double secs);
+
+    /**
+      * remove the subscribers on the host of a destination the datagrams could not be sent to
+      * @return number of removed subscribers
+      */
+    unsigned int removeUnreachable(const std::vector<struct sockaddr_in>& destinations);
+
+    /**
+      * @return true if there are subscribers and all of them requested batched frames
+      */
+    bool allBatched() const;
+
+    /**
+      * @return true if there are subscribers and all of them requested state vectors
+      */
+    bool allStateVectors() const;
+
+    /**
+      * @return index of the subscriber reading the shared memory ring, -1 if there is none
+      */
+    int sharedMemoryReader() const;
+
+    unsigned int size() const { return m_subscribers.size(); }
+
+    Subscriber& at(unsigned int index) { return m_subscribers[index]; }
+
+    /**
+      * addresses the subscribers listen on (their address with the given port)
+      * @param skip_shared_memory leave out the subscriber reading the shared memory ring
+      */
+    void destinations(unsigned short port, bool skip_shared_memory, std::vector<struct sockaddr_in>& addresses) const;
+
+private:
+    std::vector<Subscriber> m_subscribers;
+};
+
+#endif // SUBSCRIBERS_H
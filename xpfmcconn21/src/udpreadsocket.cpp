@@ -1,8 +1,11 @@
 #include "udpreadsocket.h"
 
 #include <fstream>
+#ifdef WIN_32
 #include <io.h>
+#endif
 #include <fcntl.h>
+#include <cerrno>
 
 extern std::fstream m_logfile;
 
@@ -27,6 +30,9 @@ int ready_read(int sock)
 }
 
 UDPReadSocket::UDPReadSocket()
+#ifdef __linux__
+    : m_batch(UDP_MMSG_MAX_MESSAGES * UDP_MMSG_MAX_DATAGRAM), m_batchCount(0), m_batchNext(0)
+#endif
 {
 
     // Create socket
@@ -116,11 +122,61 @@ void UDPReadSocket::configure(const std::string& host, int in_port)
     }
 }
 
+#ifdef __linux__
+unsigned int UDPReadSocket::fillBatch()
+{
+    struct mmsghdr headers[UDP_MMSG_MAX_MESSAGES];
+    struct iovec iovecs[UDP_MMSG_MAX_MESSAGES];
+
+    memset(headers, 0, sizeof(headers));
+    for (unsigned int i = 0; i < UDP_MMSG_MAX_MESSAGES; i++)
+    {
+        iovecs[i].iov_base = &m_batch[i * UDP_MMSG_MAX_DATAGRAM];
+        iovecs[i].iov_len = UDP_MMSG_MAX_DATAGRAM;
+        headers[i].msg_hdr.msg_name = &m_batchFrom[i];
+        headers[i].msg_hdr.msg_namelen = sizeof(m_batchFrom[i]);
+        headers[i].msg_hdr.msg_iov = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int received = recvmmsg(sockId, headers, UDP_MMSG_MAX_MESSAGES, MSG_DONTWAIT, 0);
+    if ( received < 0 )
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            received = 0;
+        else
+        {
+            m_logfile << "PERROR: recvmmsg" << std::endl;
+            exit (1);
+        }
+    }
+
+    for (int i = 0; i < received; i++)
+        m_batchSizes[i] = headers[i].msg_len;
+    m_batchCount = received;
+    m_batchNext = 0;
+    return m_batchCount;
+}
+#endif
+
 long UDPReadSocket::read(void* data, size_t maxsize, struct sockaddr_in& fromAddr, socklen_t& fromAddr_len)
 {
     fromAddr_len = sizeof (fromAddr);
     memset (&fromAddr, 0, fromAddr_len);
 
+#ifdef __linux__
+    // hand out the datagrams of one recvmmsg call before asking the kernel again
+    if (m_batchNext >= m_batchCount && fillBatch() == 0)
+        return 0;
+
+    size_t size = m_batchSizes[m_batchNext];
+    if (size > maxsize)
+        size = maxsize;
+    memcpy(data, &m_batch[m_batchNext * UDP_MMSG_MAX_DATAGRAM], size);
+    fromAddr = m_batchFrom[m_batchNext];
+    m_batchNext++;
+    return size;
+#else
     if (ready_read(sockId) == 1) {
         long bytesReceived =
 #ifdef WIN_32
@@ -137,4 +193,5 @@ long UDPReadSocket::read(void* data, size_t maxsize, struct sockaddr_in& fromAdd
     } else {
         return 0;
     }
+#endif
 }
@@ -3,10 +3,13 @@
 
 #include <string>
 #include <stdint.h>
+#include <vector>
 #include "my_include.h"
 #include "network_config.h"
 
+#ifdef WIN_32
 typedef int socklen_t;
+#endif
 
 class UDPReadSocket
 {
@@ -18,6 +21,17 @@ public:
 
 
 private:
+#ifdef __linux__
+    // fetches up to UDP_MMSG_MAX_MESSAGES pending datagrams with one recvmmsg call
+    unsigned int fillBatch();
+
+    // datagrams received by the last recvmmsg call, handed out one by one by read()
+    std::vector<char>   m_batch;
+    unsigned int        m_batchSizes[UDP_MMSG_MAX_MESSAGES];
+    struct sockaddr_in  m_batchFrom[UDP_MMSG_MAX_MESSAGES];
+    unsigned int        m_batchCount, m_batchNext;
+#endif
+
     int         sockId, charsReceived, port;
     uint32_t    address;
     char        msg[BUFF_LEN];
@@ -1,12 +1,34 @@
 #include "udpwritesocket.h"
+#include "plugin_defines.h"
 
 #include <fstream>
+#ifdef WIN_32
 #include <io.h>
+#endif
 #include <fcntl.h>
+#include <cerrno>
 
 extern std::fstream m_logfile;
 
-UDPWriteSocket::UDPWriteSocket()
+// a full send buffer or an interrupted call, the next datagram may go through
+static bool isTransientError()
+{
+#ifdef WIN_32
+    int error = WSAGetLastError();
+    return error == WSAEWOULDBLOCK || error == WSAENOBUFS || error == WSAEINTR;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS || errno == EINTR;
+#endif
+}
+
+static bool sameDestination(const struct sockaddr_in& a, const struct sockaddr_in& b)
+{
+    return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+}
+
+UDPWriteSocket::UDPWriteSocket():
+    m_multicast(false),
+    m_host_failed(false)
 {
     // Get a socket
     if ( (sockId = socket(PF_INET, SOCK_DGRAM, 0) ) < 0)
@@ -58,21 +80,139 @@ void UDPWriteSocket::configure(const std::string& host, int port)
     hostAddr.sin_family = AF_INET;
     hostAddr.sin_port = htons (destinationPort);
     hostAddr.sin_addr.s_addr = inet_addr (destinationAddr);
+
+    uint32_t address = ntohl(hostAddr.sin_addr.s_addr);
+    m_multicast = (address >= 0xe0000000 && address <= 0xefffffff) || address == INADDR_BROADCAST;
+    m_destinations.reserve(MAX_SUBSCRIBERS + 1);
+    m_destinations.assign(1, hostAddr);
+    m_failed.reserve(MAX_SUBSCRIBERS);
 }
 
-long UDPWriteSocket::write(const void* data, size_t size)
+void UDPWriteSocket::setDestinations(const std::vector<struct sockaddr_in>& destinations)
+{
+    m_destinations.assign(1, hostAddr);
+    // a group reaches all subscribers with one datagram
+    if (m_multicast)
+        return;
+    for (unsigned int i = 0; i < destinations.size(); i++)
+        if (destinations[i].sin_addr.s_addr != hostAddr.sin_addr.s_addr)
+            m_destinations.push_back(destinations[i]);
+}
+
+long UDPWriteSocket::writeToAddress(const void* data, size_t size, const struct sockaddr_in& address)
 {
     long bytes_written =
 #ifdef WIN_32
-            sendto (sockId, (const char*)data, size, 0, (struct sockaddr *)&hostAddr, sizeof(hostAddr));
+            sendto (sockId, (const char*)data, size, 0, (const struct sockaddr *)&address, sizeof(address));
 #else
-            sendto (sockId, data, size, 0, (struct sockaddr *)&hostAddr, sizeof(hostAddr));
+            sendto (sockId, data, size, 0, (const struct sockaddr *)&address, sizeof(address));
 #endif
     if ( bytes_written < 0 )
     {
-        m_logfile << "Sendto2 failed" << std::endl;
-        exit (1);
+        if (!isTransientError())
+            sendFailed(address);
+    } else if (m_host_failed && sameDestination(address, hostAddr))
+    {
+        m_logfile << "Sending to " << inet_ntoa(hostAddr.sin_addr) << " works again" << std::endl;
+        m_host_failed = false;
+    }
+
+    return bytes_written;
+}
+
+void UDPWriteSocket::sendFailed(const struct sockaddr_in& address)
+{
+    // the configured host stays, it is only logged once until it works again
+    if (sameDestination(address, hostAddr))
+    {
+        if (!m_host_failed)
+            m_logfile << "Sendto " << inet_ntoa(address.sin_addr) << " failed" << std::endl;
+        m_host_failed = true;
+        return;
     }
+    for (unsigned int i = 0; i < m_failed.size(); i++)
+        if (sameDestination(m_failed[i], address))
+            return;
+    m_logfile << "Sendto " << inet_ntoa(address.sin_addr) << " failed" << std::endl;
+    m_failed.push_back(address);
+}
+
+bool UDPWriteSocket::takeFailedDestinations(std::vector<struct sockaddr_in>& failed)
+{
+    failed.assign(m_failed.begin(), m_failed.end());
+    m_failed.clear();
+    return !failed.empty();
+}
+
+long UDPWriteSocket::writeTo(const void* data, size_t size, const struct sockaddr_in* addresses, unsigned int count)
+{
+    long written = 0;
+    for (unsigned int i = 0; i < count; i++)
+        if (writeToAddress(data, size, addresses[i]) == long(size)) written++;
+    return written;
+}
+
+long UDPWriteSocket::write(const void* data, size_t size)
+{
+    // the datagram is serialised once and only the destination differs
+    long bytes_written = writeToAddress(data, size, m_destinations[0]);
+    for (unsigned int i = 1; i < m_destinations.size(); i++)
+        writeToAddress(data, size, m_destinations[i]);
 
     return bytes_written;
 }
+
+#ifdef __linux__
+long UDPWriteSocket::writeMany(const void* data, size_t size, unsigned int count)
+{
+    struct mmsghdr headers[UDP_MMSG_MAX_MESSAGES];
+    struct iovec iovecs[UDP_MMSG_MAX_MESSAGES];
+    const char* datagrams = static_cast<const char*>(data);
+    unsigned int destinations = m_destinations.size();
+    // every datagram goes to every destination, datagram by datagram
+    unsigned int total = count * destinations;
+    long written = 0;
+    unsigned int sent = 0;
+
+    while (sent < total)
+    {
+        unsigned int batch = total - sent;
+        if (batch > UDP_MMSG_MAX_MESSAGES)
+            batch = UDP_MMSG_MAX_MESSAGES;
+
+        memset(headers, 0, sizeof(headers));
+        for (unsigned int i = 0; i < batch; i++)
+        {
+            unsigned int datagram = (sent + i) / destinations;
+            iovecs[i].iov_base = const_cast<char*>(datagrams + datagram * size);
+            iovecs[i].iov_len = size;
+            headers[i].msg_hdr.msg_name = &m_destinations[(sent + i) % destinations];
+            headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            headers[i].msg_hdr.msg_iov = &iovecs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int messages_sent = sendmmsg(sockId, headers, batch, 0);
+        if ( messages_sent <= 0 )
+        {
+            // the first message of the batch failed, skip it and go on with the rest
+            if ( messages_sent < 0 && !isTransientError() )
+                sendFailed(m_destinations[sent % destinations]);
+            sent += 1;
+            continue;
+        }
+
+        // count the datagrams written to the configured host
+        for (int i = 0; i < messages_sent; i++)
+            if ((sent + i) % destinations == 0 && headers[i].msg_len == size) written++;
+        if (m_host_failed && written > 0)
+        {
+            m_logfile << "Sending to " << inet_ntoa(hostAddr.sin_addr) << " works again" << std::endl;
+            m_host_failed = false;
+        }
+        sent += messages_sent;
+    }
+
+    return written;
+}
+#endif
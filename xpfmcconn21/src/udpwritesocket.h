@@ -2,6 +2,7 @@
 #define UDPWRITESOCKET_H
 
 #include <string>
+#include <vector>
 #include "my_include.h"
 #include "network_config.h"
 #include "paketwriter.h"
@@ -13,11 +14,55 @@ public:
     virtual ~UDPWriteSocket();
     void configure(const std::string& host, int port);
     virtual long write(const void* data, size_t size);
+#ifdef __linux__
+    // sends the datagrams with sendmmsg, UDP_MMSG_MAX_MESSAGES per call
+    virtual long writeMany(const void* data, size_t size, unsigned int count);
+#endif
+
+    /**
+      * true if the configured host is a multicast group or the broadcast address,
+      * one datagram then reaches all subscribers
+      */
+    bool isMulticast() { return m_multicast; }
+
+    /**
+      * set the addresses the datagrams are fanned out to when the configured host
+      * is a unicast address. The configured host is always written to.
+      */
+    void setDestinations(const std::vector<struct sockaddr_in>& destinations);
+
+    /**
+      * write the datagram to the given addresses only
+      * @return the number of addresses the datagram was completely written to
+      */
+    long writeTo(const void* data, size_t size, const struct sockaddr_in* addresses, unsigned int count);
+
+    /**
+      * hand over the destinations a send failed for with an other than a transient
+      * error since the last call, the configured host is never among them
+      * @return true if there were failed destinations
+      */
+    bool takeFailedDestinations(std::vector<struct sockaddr_in>& failed);
+
+    int port() { return destinationPort; }
 private:
+    // writes the datagram to one address, a failed address is logged and remembered
+    long writeToAddress(const void* data, size_t size, const struct sockaddr_in& address);
+    void sendFailed(const struct sockaddr_in& address);
+
     int     sockId, destinationPort;
     char    msg[BUFF_LEN];
     char*   destinationAddr;
     struct sockaddr_in hostAddr;
+    bool    m_multicast;
+
+    // the configured host followed by the fan out destinations
+    std::vector<struct sockaddr_in> m_destinations;
+
+    // the destinations a send failed for, reserved for MAX_SUBSCRIBERS
+    std::vector<struct sockaddr_in> m_failed;
+    // the last send to the configured host failed, it is logged once
+    bool    m_host_failed;
 };
 
 #endif // UDPWRITESOCKET_H
@@ -24,6 +24,8 @@ win32 {
 unix:!macx { 
     TARGET = xpfmcconn/lin.xpl
     DEFINES += APL=0 IBM=0 LIN=1
+    # shm_open of the shared memory ring
+    LIBS += -lrt
     QMAKE_CFLAGS += -fstack-protector
     QMAKE_CXXFLAGS += -fstack-protector
 }
@@ -48,6 +50,7 @@ HEADERS += \
     logichandler.h \
     owneddata.h \
     simdata.h \
+    simdatarefs.h \
     priotype.h \
     rwtype.h \
     radionav.h \
@@ -60,6 +63,11 @@ HEADERS += \
     udpreadsocket.h \
     protocolstreamer.h \
     casprotocol.h \
+    canqueue.h \
+    statevector.h \
+    subscribers.h \
+    sharedmemorywriter.h \
+    flightloopprofiler.h \
     paketwriter.h \
     plugin_defines.h \
     ../vaslib/src/fsaccess_xplane_refids.h \
@@ -71,6 +79,7 @@ SOURCES += \
     canasoverudp.cpp \
     owneddata.cpp \
     simdata.cpp \
+    simdatarefs.cpp \
     radionav.cpp \
     apxplane9standard.cpp \
     logichandler.cpp \
@@ -78,4 +87,8 @@ SOURCES += \
     navcalc.cpp \
     udpwritesocket.cpp \
     udpreadsocket.cpp \
-    casprotocol.cpp
+    casprotocol.cpp \
+    statevector.cpp \
+    subscribers.cpp \
+    sharedmemorywriter.cpp \
+    flightloopprofiler.cpp
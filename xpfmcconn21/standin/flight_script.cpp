@@ -0,0 +1,197 @@
+#include "flight_script.h"
+#include "navcalc.h"
+
+#include <math.h>
+
+static const double PI = 3.14159265358979;
+static const double METERS_PER_DEGREE = 111120.0;
+static const double KNOTS_TO_METER_PER_SECOND = 0.514444;
+static const double G = 9.81;
+
+FlightScript::FlightScript(StandinDataRefs& datarefs, double lat, double lon, double heading,
+                           double cruise_alt_ft, double cruise_secs):
+    m_datarefs(datarefs),
+    m_cruise_alt_ft(cruise_alt_ft),
+    m_cruise_secs(cruise_secs),
+    m_phase(TakeoffRoll),
+    m_phase_secs(0),
+    m_time_secs(0),
+    m_lat(lat),
+    m_lon(lon),
+    m_heading(heading),
+    m_alt_ft(0),
+    m_ias_kts(0),
+    m_vs_fpm(0),
+    m_pitch(0),
+    m_bank(0),
+    m_n1(20),
+    m_flaps(0.25),
+    m_gear(1)
+{
+    publish();
+}
+
+const char* FlightScript::phaseName()
+{
+    switch (m_phase)
+    {
+        case TakeoffRoll: return "takeoff roll";
+        case Climb: return "climb";
+        case Cruise: return "cruise";
+        case Descent: return "descent";
+        case Approach: return "approach";
+        case Landing: return "landing";
+        default: return "parked";
+    }
+}
+
+double FlightScript::approach(double value, double target, double max_change)
+{
+    if (value < target)
+        return (target - value > max_change) ? value + max_change : target;
+    return (value - target > max_change) ? value - max_change : target;
+}
+
+void FlightScript::advance(double dt)
+{
+    if (dt <= 0)
+        return;
+
+    m_time_secs += dt;
+    m_phase_secs += dt;
+
+    double target_bank = 0;
+    double target_pitch = 2.5;
+
+    switch (m_phase)
+    {
+        case TakeoffRoll:
+            m_n1 = approach(m_n1, 92, 10 * dt);
+            m_ias_kts += 3.5 * dt;
+            target_pitch = 0;
+            if (m_ias_kts >= 150)
+            {
+                m_phase = Climb;
+                m_phase_secs = 0;
+            }
+            break;
+        case Climb:
+            m_n1 = approach(m_n1, 88, 2 * dt);
+            m_vs_fpm = approach(m_vs_fpm, 2200, 500 * dt);
+            m_ias_kts = approach(m_ias_kts, m_alt_ft < 10000 ? 250 : 290, 2 * dt);
+            target_pitch = 8;
+            if (m_alt_ft > 400) m_gear = approach(m_gear, 0, 0.15 * dt);
+            if (m_alt_ft > 2000) m_flaps = approach(m_flaps, 0, 0.05 * dt);
+            if (m_alt_ft >= m_cruise_alt_ft - 300) m_vs_fpm = approach(m_vs_fpm, 0, 500 * dt);
+            if (m_alt_ft >= m_cruise_alt_ft)
+            {
+                m_alt_ft = m_cruise_alt_ft;
+                m_vs_fpm = 0;
+                m_phase = Cruise;
+                m_phase_secs = 0;
+            }
+            break;
+        case Cruise:
+            m_n1 = approach(m_n1, 82, 2 * dt);
+            m_ias_kts = approach(m_ias_kts, 270, 2 * dt);
+            // gentle S-turns to exercise heading and bank
+            target_bank = 15 * sin(2 * PI * m_phase_secs / 240);
+            if (m_phase_secs >= m_cruise_secs)
+            {
+                m_phase = Descent;
+                m_phase_secs = 0;
+            }
+            break;
+        case Descent:
+            m_n1 = approach(m_n1, 35, 2 * dt);
+            m_vs_fpm = approach(m_vs_fpm, m_alt_ft > 4000 ? -2200 : -800, 300 * dt);
+            m_ias_kts = approach(m_ias_kts, m_alt_ft > 10000 ? 280 : 220, 2 * dt);
+            target_pitch = -1;
+            if (m_alt_ft <= 3000)
+            {
+                m_phase = Approach;
+                m_phase_secs = 0;
+            }
+            break;
+        case Approach:
+            m_n1 = approach(m_n1, 55, 2 * dt);
+            m_ias_kts = approach(m_ias_kts, 140, 1.5 * dt);
+            m_vs_fpm = approach(m_vs_fpm, -750, 300 * dt);
+            m_flaps = approach(m_flaps, 1, 0.05 * dt);
+            m_gear = approach(m_gear, 1, 0.15 * dt);
+            target_pitch = 3;
+            if (m_alt_ft <= 0)
+            {
+                m_alt_ft = 0;
+                m_vs_fpm = 0;
+                m_phase = Landing;
+                m_phase_secs = 0;
+            }
+            break;
+        case Landing:
+            m_n1 = approach(m_n1, 20, 10 * dt);
+            m_ias_kts = approach(m_ias_kts, 0, 4 * dt);
+            target_pitch = 0;
+            if (m_ias_kts <= 0)
+            {
+                m_phase = Parked;
+                m_phase_secs = 0;
+            }
+            break;
+        case Parked:
+            break;
+    }
+
+    m_pitch = approach(m_pitch, target_pitch, 2 * dt);
+    m_bank = approach(m_bank, target_bank, 3 * dt);
+
+    m_alt_ft += m_vs_fpm / 60.0 * dt;
+    if (m_alt_ft < 0) m_alt_ft = 0;
+
+    // coordinated turn: rate = g * tan(bank) / v
+    double tas_ms = m_ias_kts * (1 + m_alt_ft / 1000.0 * 0.02) * KNOTS_TO_METER_PER_SECOND;
+    if (tas_ms > 1)
+        m_heading = Navcalc::trimHeading(m_heading + (G * tan(m_bank * PI / 180) / tas_ms) * 180 / PI * dt);
+
+    double distance_m = tas_ms * dt;
+    m_lat += distance_m * cos(m_heading * PI / 180) / METERS_PER_DEGREE;
+    m_lon += distance_m * sin(m_heading * PI / 180) / (METERS_PER_DEGREE * cos(m_lat * PI / 180));
+
+    publish();
+}
+
+void FlightScript::publish()
+{
+    double tas_ms = m_ias_kts * (1 + m_alt_ft / 1000.0 * 0.02) * KNOTS_TO_METER_PER_SECOND;
+    double sos_ms = (m_alt_ft < 36000) ? 340.3 - 0.00123 * m_alt_ft : 295.1;
+    bool on_ground = (m_phase == TakeoffRoll || m_phase == Landing || m_phase == Parked);
+
+    m_datarefs.set("sim/flightmodel/position/latitude", m_lat);
+    m_datarefs.set("sim/flightmodel/position/longitude", m_lon);
+    m_datarefs.set("sim/flightmodel/position/elevation", m_alt_ft / Navcalc::METER_TO_FEET);
+    m_datarefs.set("sim/flightmodel/position/y_agl", m_alt_ft / Navcalc::METER_TO_FEET);
+    m_datarefs.set("sim/flightmodel/misc/h_ind", m_alt_ft);
+    m_datarefs.set("sim/flightmodel/position/psi", m_heading);
+    m_datarefs.set("sim/flightmodel/position/indicated_airspeed", m_ias_kts);
+    m_datarefs.set("sim/flightmodel/position/true_airspeed", tas_ms);
+    m_datarefs.set("sim/flightmodel/position/groundspeed", tas_ms);
+    m_datarefs.set("sim/flightmodel/misc/machno", tas_ms / sos_ms);
+    m_datarefs.set("sim/weather/speed_sound_ms", sos_ms);
+    m_datarefs.set("sim/flightmodel/position/vh_ind_fpm", m_vs_fpm);
+    m_datarefs.set("sim/flightmodel/position/theta", m_pitch);
+    m_datarefs.set("sim/flightmodel/position/phi", m_bank);
+    m_datarefs.set("sim/weather/temperature_ambient_c", 15 - 1.98 * m_alt_ft / 1000);
+    m_datarefs.set("sim/time/zulu_time_sec", fmod(36000 + m_time_secs, 86400));
+    m_datarefs.set("sim/flightmodel/failures/onground_any", on_ground ? 1 : 0);
+    m_datarefs.set("sim/cockpit/electrical/landing_lights_on", m_alt_ft < 10000 ? 1 : 0);
+    m_datarefs.set("sim/cockpit/electrical/strobe_lights_on", m_phase != Parked ? 1 : 0);
+    m_datarefs.set("sim/cockpit/autopilot/altitude", m_cruise_alt_ft);
+    m_datarefs.set("sim/flightmodel/controls/flaprat", m_flaps);
+    m_datarefs.set("sim/flightmodel/controls/flaprqst", m_flaps);
+    m_datarefs.setItems("sim/flightmodel2/gear/deploy_ratio", m_gear);
+    m_datarefs.setItems("sim/flightmodel/engine/ENGN_N1_", m_n1);
+    m_datarefs.setItems("sim/flightmodel/engine/ENGN_N2_", 50 + m_n1 / 2);
+    m_datarefs.setItems("sim/flightmodel/engine/ENGN_EGT_c", 300 + 5 * m_n1);
+    m_datarefs.setItems("sim/flightmodel/engine/ENGN_FF_", 0.05 + 0.9 * m_n1 / 100);
+    m_datarefs.setItems("sim/flightmodel/engine/ENGN_thro", m_n1 / 100);
+}
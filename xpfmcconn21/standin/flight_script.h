@@ -0,0 +1,62 @@
+#ifndef FLIGHT_SCRIPT_H
+#define FLIGHT_SCRIPT_H
+
+#include "xplm_standin.h"
+
+/**
+  * Synthesises a simple flight (takeoff, climb, cruise with S-turns, descent, approach
+  * and landing) and writes it into the stand-in datarefs in X-Plane units.
+  * Kinematics only, no flight model: just enough to drive the FMC displays,
+  * the smoothing and the controllers with plausible and continuous data.
+  * @file flight_script.h
+  */
+class FlightScript
+{
+public:
+
+    FlightScript(StandinDataRefs& datarefs, double lat, double lon, double heading,
+                 double cruise_alt_ft = 35000, double cruise_secs = 600);
+
+    /**
+      * advance the flight by dt seconds and write the new state to the datarefs
+      */
+    void advance(double dt);
+
+    /**
+      * @return true after the landing
+      */
+    bool finished() { return m_phase == Parked; }
+
+    const char* phaseName();
+
+private:
+
+    enum Phase { TakeoffRoll, Climb, Cruise, Descent, Approach, Landing, Parked };
+
+    void publish();
+
+    double approach(double value, double target, double max_change);
+
+    StandinDataRefs& m_datarefs;
+
+    double m_cruise_alt_ft;
+    double m_cruise_secs;
+
+    Phase m_phase;
+    double m_phase_secs;
+    double m_time_secs;
+
+    double m_lat;
+    double m_lon;
+    double m_heading;
+    double m_alt_ft;
+    double m_ias_kts;
+    double m_vs_fpm;
+    double m_pitch;
+    double m_bank;
+    double m_n1;
+    double m_flaps;
+    double m_gear;
+};
+
+#endif // FLIGHT_SCRIPT_H
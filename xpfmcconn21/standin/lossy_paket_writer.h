@@ -0,0 +1,86 @@
+#ifndef LOSSY_PAKET_WRITER_H
+#define LOSSY_PAKET_WRITER_H
+
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#include "paketwriter.h"
+
+/**
+  * PaketWriter decorator simulating a bad network: drops datagrams with the given
+  * probability (loss_burst_length consecutive datagrams per loss event) and holds back
+  * datagrams until burst_length of them are collected, then writes them back to back.
+  * @file lossy_paket_writer.h
+  */
+class LossyPaketWriter : public PaketWriter
+{
+public:
+
+    LossyPaketWriter(PaketWriter* writer, double loss_probability = 0.0,
+                     unsigned int loss_burst_length = 1, unsigned int burst_length = 1):
+        m_writer(writer),
+        m_loss_probability(loss_probability),
+        m_loss_burst_length(loss_burst_length),
+        m_burst_length(burst_length),
+        m_losses_left(0),
+        m_written(0),
+        m_dropped(0)
+    {}
+
+    virtual ~LossyPaketWriter() { flush(); }
+
+    virtual long write(const void* data, size_t size)
+    {
+        if (m_losses_left == 0 && m_loss_probability > 0 && rand() < m_loss_probability * RAND_MAX)
+            m_losses_left = m_loss_burst_length;
+        if (m_losses_left > 0)
+        {
+            m_losses_left--;
+            m_dropped++;
+            // a lost UDP datagram looks like a sent one to the sender
+            return size;
+        }
+
+        if (m_burst_length <= 1)
+        {
+            m_written++;
+            return m_writer->write(data, size);
+        }
+
+        const char* bytes = static_cast<const char*>(data);
+        m_held.push_back(std::vector<char>(bytes, bytes + size));
+        if (m_held.size() >= m_burst_length)
+            flush();
+        return size;
+    }
+
+    /**
+      * write all held back datagrams
+      */
+    void flush()
+    {
+        for (unsigned int i = 0 ; i < m_held.size() ; i++)
+        {
+            m_writer->write(&m_held[i][0], m_held[i].size());
+            m_written++;
+        }
+        m_held.clear();
+    }
+
+    unsigned long written() { return m_written; }
+    unsigned long dropped() { return m_dropped; }
+
+private:
+
+    PaketWriter* m_writer;
+    double m_loss_probability;
+    unsigned int m_loss_burst_length;
+    unsigned int m_burst_length;
+    unsigned int m_losses_left;
+    unsigned long m_written;
+    unsigned long m_dropped;
+    std::vector<std::vector<char> > m_held;
+};
+
+#endif // LOSSY_PAKET_WRITER_H
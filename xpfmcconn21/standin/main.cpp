@@ -0,0 +1,346 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#include <netinet/in.h>
+
+#include "plugin_defines.h"
+#include "myassert.h"
+#include "datacontainer.h"
+#include "casprotocol.h"
+#include "udpreadsocket.h"
+#include "udpwritesocket.h"
+#include "simdatarefs.h"
+
+#include "xplm_standin.h"
+#include "flight_script.h"
+#include "recorded_flight.h"
+#include "lossy_paket_writer.h"
+
+// includes from vaslib
+#include "fsaccess_xplane_refids.h"
+#include "canas.h"
+
+/**
+  * Standalone stand-in for the xpfmcconn plugin. Sends the same CANaerospace UDP stream
+  * as the plugin running inside X-Plane, either for a scripted flight or by replaying a
+  * datagram recording of vasFMC, at a configurable multiple of the plugin message rates
+  * and with simulated packet loss and bursts.
+  * @file main.cpp
+  */
+
+std::fstream m_logfile;
+
+// send policy of the plugin, see main.cpp of xpfmcconn
+static const double PREPARE_INTERVAL_SECS = 0.17;
+static const double FLUSH_INTERVAL_SECS = 0.08;
+static const double READ_INTERVAL_SECS = 0.33;
+static const unsigned int maxDataItems = 30;
+
+struct Options
+{
+    std::string host;
+    int port_from_sim;
+    int port_to_sim;
+    std::string record_file;
+    double rate;
+    double speed;
+    double duration;
+    double loss;
+    unsigned int loss_burst;
+    unsigned int burst;
+    double cruise_alt_ft;
+    double cruise_secs;
+    unsigned int seed;
+    std::string log_file;
+};
+
+DataContainer<double> doubleData;
+DataContainer<float> floatData;
+DataContainer<int> intData;
+DataContainer<bool> boolData;
+DataContainer<std::vector<float> > floatvectorData;
+
+static void usage()
+{
+    std::cout << "usage: xpfmcconn_standin [options]" << std::endl
+              << "  --host ADDRESS      multicast group or host of vasFMC (" << CFG_HOSTADDRESS_DEFAULT << ")" << std::endl
+              << "  --port PORT         port vasFMC reads from (" << CFG_PORT_FROM_SIM_DEFAULT << ")" << std::endl
+              << "  --listen PORT       port vasFMC writes to (" << CFG_PORT_TO_SIM_DEFAULT << ")" << std::endl
+              << "  --record FILE       replay a vasFMC datagram recording instead of the scripted flight" << std::endl
+              << "  --speed FACTOR      replay speed of the recording (1)" << std::endl
+              << "  --rate FACTOR       multiple of the plugin message rates (1)" << std::endl
+              << "  --duration SECS     stop after the given time (end of flight)" << std::endl
+              << "  --loss PROBABILITY  probability of a loss event per datagram (0)" << std::endl
+              << "  --loss-burst N      datagrams dropped per loss event (1)" << std::endl
+              << "  --burst N           hold back datagrams and send them in bursts of N (1)" << std::endl
+              << "  --cruise-alt FEET   cruise altitude of the scripted flight (35000)" << std::endl
+              << "  --cruise-time SECS  cruise time of the scripted flight (600)" << std::endl
+              << "  --seed N            random seed for the loss simulation" << std::endl
+              << "  --log FILE          log file ($TMPDIR/xpfmcconn_standin.log)" << std::endl;
+}
+
+static bool parseOptions(int argc, char** argv, Options& options)
+{
+    options.host = CFG_HOSTADDRESS_DEFAULT;
+    options.port_from_sim = CFG_PORT_FROM_SIM_DEFAULT;
+    options.port_to_sim = CFG_PORT_TO_SIM_DEFAULT;
+    options.rate = 1;
+    options.speed = 1;
+    options.duration = 0;
+    options.loss = 0;
+    options.loss_burst = 1;
+    options.burst = 1;
+    options.cruise_alt_ft = 35000;
+    options.cruise_secs = 600;
+    options.seed = (unsigned int)time(0);
+    const char* tmpdir = getenv("TMPDIR");
+    options.log_file = std::string(tmpdir != 0 && *tmpdir != 0 ? tmpdir : "/tmp") + "/xpfmcconn_standin.log";
+
+    for (int i = 1 ; i < argc ; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        const char* value = argv[++i];
+        if (arg == "--host") options.host = value;
+        else if (arg == "--port") options.port_from_sim = atoi(value);
+        else if (arg == "--listen") options.port_to_sim = atoi(value);
+        else if (arg == "--record") options.record_file = value;
+        else if (arg == "--speed") options.speed = atof(value);
+        else if (arg == "--rate") options.rate = atof(value);
+        else if (arg == "--duration") options.duration = atof(value);
+        else if (arg == "--loss") options.loss = atof(value);
+        else if (arg == "--loss-burst") options.loss_burst = atoi(value);
+        else if (arg == "--burst") options.burst = atoi(value);
+        else if (arg == "--cruise-alt") options.cruise_alt_ft = atof(value);
+        else if (arg == "--cruise-time") options.cruise_secs = atof(value);
+        else if (arg == "--seed") options.seed = atoi(value);
+        else if (arg == "--log") options.log_file = value;
+        else return false;
+    }
+    return options.rate > 0 && options.speed > 0 && options.loss >= 0 && options.loss <= 1;
+}
+
+static double nowSecs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void sleepUntil(double secs)
+{
+    double wait = secs - nowSecs();
+    if (wait > 0)
+        usleep((useconds_t)(wait * 1e6));
+}
+
+/**
+  * answer the node service requests of vasFMC like the plugin does (IDS, STS, BFS)
+  * @param casprotocol is switched to batched frames on request, may be 0
+  */
+static void processRequests(UDPReadSocket& read_socket, PaketWriter& writer, Casprotocol* casprotocol)
+{
+    struct sockaddr_in fromaddr;
+    socklen_t fromaddr_len;
+    can_t message;
+    while (read_socket.read(&message, sizeof(message), fromaddr, fromaddr_len) > 0)
+    {
+        if (ntohl(message.id) != NSH_CH0_REQ)
+            continue;
+        if (message.msg.aero.nodeId != 0 && message.msg.aero.nodeId != PLUGIN_NODE_ID)
+            continue;
+
+        if (message.msg.aero.serviceCode == IDS)
+        {
+            if (casprotocol != 0)
+                casprotocol->setBatchedFrames(false);
+            can_t response;
+            response.id = htonl(NSH_CH0_RES);
+            response.dlc = 8;
+            response.id_is_29 = PLUGIN_USES_ID29;
+            response.msg.aero.nodeId = PLUGIN_NODE_ID;
+            response.msg.aero.dataType = AS_UCHAR4;
+            response.msg.aero.serviceCode = 0;
+            response.msg.aero.messageCode = message.msg.aero.messageCode;
+            response.msg.aero.data.uChar[0] = PLUGIN_HARDWARE_REVISION;
+            response.msg.aero.data.uChar[1] = PLUGIN_SOFTWARE_REVISION;
+            response.msg.aero.data.uChar[2] = DISTRIBUTION_FP;
+            response.msg.aero.data.uChar[3] = HEADER_TYPE_CANAS;
+            writer.write(&response, sizeof(can_t));
+            m_logfile << "Answered IDS request" << std::endl;
+        }
+        else if (message.msg.aero.serviceCode == STS)
+        {
+            intData.outDateAll();
+            floatData.outDateAll();
+            doubleData.outDateAll();
+            boolData.outDateAll();
+            floatvectorData.outDateAll();
+        }
+        else if (message.msg.aero.serviceCode == BFS && casprotocol != 0 &&
+                 message.msg.aero.data.uChar[0] == CANAS_FRAME_VERSION)
+        {
+            casprotocol->setBatchedFrames(true);
+            m_logfile << "Switching to batched frames" << std::endl;
+        }
+    }
+}
+
+static void printStatistics(double secs, LossyPaketWriter& writer)
+{
+    std::cout << "t=" << secs << "s sent=" << writer.written() << " dropped=" << writer.dropped()
+              << " msgs/s=" << (secs > 0 ? writer.written() / secs : 0) << std::endl;
+}
+
+static int runScriptedFlight(const Options& options, UDPReadSocket& read_socket,
+                             UDPWriteSocket& write_socket, LossyPaketWriter& writer)
+{
+    StandinDataRefs::instance().declareSimDataRefs();
+    addSimDataRefs(doubleData, floatData, intData, boolData, floatvectorData);
+
+    FlightScript script(StandinDataRefs::instance(), 48.11, 16.57, 115,
+                        options.cruise_alt_ft, options.cruise_secs);
+    Casprotocol casprotocol(m_logfile, &writer, PLUGIN_NODE_ID, PLUGIN_USES_ID29);
+
+    double start = nowSecs();
+    double last = start;
+    double next_prepare = start, next_flush = start, next_read = start, next_statistics = start + 5;
+    int ticks = 0;
+
+    while (!script.finished() && (options.duration <= 0 || last - start < options.duration))
+    {
+        double now = nowSecs();
+        script.advance(now - last);
+        last = now;
+        ticks++;
+
+        // the send policy of the data runs faster by the rate factor
+        double secs = (now - start) * options.rate;
+
+        doubleData.updateHighPrio();
+        floatData.updateHighPrio();
+
+        if (now >= next_prepare)
+        {
+            doubleData.updateAll();
+            floatData.updateAll();
+            boolData.updateAll();
+            intData.updateAll();
+            floatvectorData.updateAll();
+
+            doubleData.writeOutdated(&casprotocol, ticks, secs);
+            floatData.writeOutdated(&casprotocol, ticks, secs);
+            intData.writeOutdated(&casprotocol, ticks, secs);
+            boolData.writeOutdated(&casprotocol, ticks, secs);
+            floatvectorData.writeOutdated(&casprotocol, ticks, secs);
+            next_prepare += PREPARE_INTERVAL_SECS / options.rate;
+        }
+        if (now >= next_flush)
+        {
+            casprotocol.writeMax(maxDataItems);
+            next_flush += FLUSH_INTERVAL_SECS / options.rate;
+        }
+        if (now >= next_read)
+        {
+            processRequests(read_socket, write_socket, &casprotocol);
+            next_read += READ_INTERVAL_SECS;
+        }
+        if (now >= next_statistics)
+        {
+            std::cout << script.phaseName() << ": ";
+            printStatistics(now - start, writer);
+            next_statistics += 5;
+        }
+
+        double next = next_prepare < next_flush ? next_prepare : next_flush;
+        sleepUntil(next < next_read ? next : next_read);
+    }
+
+    writer.flush();
+    printStatistics(nowSecs() - start, writer);
+    return 0;
+}
+
+static int runRecordedFlight(const Options& options, UDPReadSocket& read_socket,
+                             UDPWriteSocket& write_socket, LossyPaketWriter& writer)
+{
+    RecordedFlight recording;
+    if (!recording.open(options.record_file))
+    {
+        std::cerr << "could not read recording " << options.record_file << std::endl;
+        return 1;
+    }
+
+    uint32_t timestamp_ms;
+    std::vector<char> data;
+    double start = nowSecs();
+    double next_read = start, next_statistics = start + 5;
+
+    while (recording.next(timestamp_ms, data))
+    {
+        double now = nowSecs();
+        if (options.duration > 0 && now - start >= options.duration)
+            break;
+
+        // the rate factor repeats every datagram, the speed factor compresses the time
+        sleepUntil(start + timestamp_ms / 1000.0 / options.speed);
+        if (!data.empty())
+            for (int i = 0 ; i < int(options.rate + 0.5) || i == 0 ; i++)
+                writer.write(&data[0], data.size());
+
+        if (now >= next_read)
+        {
+            processRequests(read_socket, write_socket, 0);
+            next_read += READ_INTERVAL_SECS;
+        }
+        if (now >= next_statistics)
+        {
+            printStatistics(now - start, writer);
+            next_statistics += 5;
+        }
+    }
+
+    writer.flush();
+    printStatistics(nowSecs() - start, writer);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage();
+        return 1;
+    }
+
+    m_logfile.open(options.log_file.c_str(), std::ios_base::trunc | std::ios_base::out);
+    if (!m_logfile)
+    {
+        std::cerr << "could not open log file " << options.log_file << std::endl;
+        return 1;
+    }
+    srand(options.seed);
+
+    UDPWriteSocket write_socket;
+    write_socket.configure(options.host, options.port_from_sim);
+    UDPReadSocket read_socket;
+    read_socket.configure(options.host, options.port_to_sim);
+
+    LossyPaketWriter writer(&write_socket, options.loss, options.loss_burst, options.burst);
+
+    int result;
+    if (options.record_file.empty())
+        result = runScriptedFlight(options, read_socket, write_socket, writer);
+    else
+        result = runRecordedFlight(options, read_socket, write_socket, writer);
+
+    m_logfile.close();
+    return result;
+}
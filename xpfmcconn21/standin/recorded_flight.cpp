@@ -0,0 +1,49 @@
+#include "recorded_flight.h"
+
+static const uint32_t RECORD_MAGIC = 0x56464452; // "VFDR"
+static const uint32_t RECORD_VERSION = 1;
+
+extern std::fstream m_logfile;
+
+bool RecordedFlight::open(const std::string& filename)
+{
+    m_file.open(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!m_file)
+    {
+        m_logfile << "RecordedFlight: could not open " << filename << std::endl;
+        return false;
+    }
+
+    uint32_t magic, version, reserved;
+    if (!readUInt(magic, 4) || !readUInt(version, 2) || !readUInt(reserved, 2) ||
+        magic != RECORD_MAGIC || version != RECORD_VERSION)
+    {
+        m_logfile << "RecordedFlight: " << filename << " is no datagram recording" << std::endl;
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool RecordedFlight::next(uint32_t& timestamp_ms, std::vector<char>& data)
+{
+    uint32_t size;
+    if (!readUInt(timestamp_ms, 4) || !readUInt(size, 2))
+        return false;
+    data.resize(size);
+    if (size > 0)
+        m_file.read(&data[0], size);
+    return bool(m_file);
+}
+
+bool RecordedFlight::readUInt(uint32_t& value, unsigned int bytes)
+{
+    unsigned char buffer[4];
+    m_file.read(reinterpret_cast<char*>(buffer), bytes);
+    if (!m_file)
+        return false;
+    value = 0;
+    for (unsigned int i = 0 ; i < bytes ; i++)
+        value = (value << 8) | buffer[i];
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef RECORDED_FLIGHT_H
+#define RECORDED_FLIGHT_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/**
+  * Reads the datagram recordings written by vasFMC (record_file of the X-Plane access,
+  * see vaslib datagram_recorder.h): big endian magic "VFDR", uint16 version, uint16 reserved,
+  * then per datagram: uint32 ms since start, uint16 size, raw data.
+  * @file recorded_flight.h
+  */
+class RecordedFlight
+{
+public:
+
+    RecordedFlight() {}
+
+    /**
+      * @return false if the file can't be opened or is no datagram recording
+      */
+    bool open(const std::string& filename);
+
+    /**
+      * read the next datagram
+      * @return false at the end of the recording
+      */
+    bool next(uint32_t& timestamp_ms, std::vector<char>& data);
+
+private:
+
+    bool readUInt(uint32_t& value, unsigned int bytes);
+
+    std::ifstream m_file;
+};
+
+#endif // RECORDED_FLIGHT_H
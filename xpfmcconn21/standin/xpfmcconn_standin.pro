@@ -0,0 +1,51 @@
+TEMPLATE = app
+
+# Standalone stand-in for the xpfmcconn plugin, without any Qt functionality
+QT -= gui core
+
+CONFIG += warn_on debug console
+CONFIG -= rtti exceptions thread qt app_bundle
+
+TARGET = xpfmcconn_standin
+
+INCLUDEPATH += ../src
+INCLUDEPATH += ../src/include/udp
+INCLUDEPATH += ../src/include/XPLM
+INCLUDEPATH += ../../vaslib/src
+
+unix:!macx {
+    DEFINES += APL=0 IBM=0 LIN=1
+    LIBS += -lrt
+}
+
+macx {
+    DEFINES += APL=1 IBM=0 LIN=0
+}
+
+HEADERS += \
+    xplm_standin.h \
+    flight_script.h \
+    recorded_flight.h \
+    lossy_paket_writer.h \
+    ../src/datacontainer.h \
+    ../src/datatosend.h \
+    ../src/simdata.h \
+    ../src/simdatarefs.h \
+    ../src/casprotocol.h \
+    ../src/udpwritesocket.h \
+    ../src/udpreadsocket.h \
+    ../src/navcalc.h \
+    ../src/myassert.h
+
+SOURCES += \
+    main.cpp \
+    xplm_standin.cpp \
+    flight_script.cpp \
+    recorded_flight.cpp \
+    ../src/simdata.cpp \
+    ../src/simdatarefs.cpp \
+    ../src/casprotocol.cpp \
+    ../src/udpwritesocket.cpp \
+    ../src/udpreadsocket.cpp \
+    ../src/navcalc.cpp \
+    ../src/myassert.cpp
@@ -0,0 +1,235 @@
+#include "xplm_standin.h"
+#include "myassert.h"
+
+#include <cstring>
+#include <fstream>
+
+extern std::fstream m_logfile;
+
+StandinDataRefs& StandinDataRefs::instance()
+{
+    static StandinDataRefs datarefs;
+    return datarefs;
+}
+
+void StandinDataRefs::declare(const std::string& name, XPLMDataTypeID type, double value,
+                              unsigned int no_of_items, bool writeable)
+{
+    Entry& entry = m_entries[name];
+    entry.name = name;
+    entry.type = type;
+    entry.writeable = writeable;
+    entry.value = value;
+    entry.items.assign(no_of_items, float(value));
+}
+
+void StandinDataRefs::declareSimDataRefs(unsigned int no_of_engines)
+{
+    const XPLMDataTypeID xplmType_FloatDouble = xplmType_Float | xplmType_Double;
+
+    declare("sim/flightmodel/position/latitude", xplmType_FloatDouble);
+    declare("sim/flightmodel/position/longitude", xplmType_FloatDouble);
+    declare("sim/flightmodel/position/elevation", xplmType_FloatDouble);
+    declare("sim/time/local_date_days", xplmType_Int, 180);
+    declare("sim/time/zulu_time_sec", xplmType_Float, 36000);
+    declare("sim/aircraft/view/acf_Vso", xplmType_Float, 110);
+    declare("sim/aircraft/view/acf_Vs", xplmType_Float, 140);
+    declare("sim/aircraft/view/acf_Vno", xplmType_Float, 340);
+    declare("sim/aircraft/view/acf_Mmo", xplmType_Float, 0.82);
+    declare("sim/aircraft/view/acf_Vfe", xplmType_Float, 180);
+    declare("sim/weather/speed_sound_ms", xplmType_Float, 340.3);
+    declare("sim/flightmodel/position/y_agl", xplmType_Float);
+    declare("sim/flightmodel/misc/h_ind", xplmType_Float);
+    declare("sim/flightmodel/position/psi", xplmType_Float);
+    declare("sim/flightmodel/position/indicated_airspeed", xplmType_Float);
+    declare("sim/flightmodel/misc/machno", xplmType_Float);
+    declare("sim/flightmodel/position/vh_ind_fpm", xplmType_Float);
+    declare("sim/flightmodel/position/theta", xplmType_Float);
+    declare("sim/flightmodel/position/phi", xplmType_Float);
+    declare("sim/flightmodel/position/groundspeed", xplmType_Float);
+    declare("sim/flightmodel/position/true_airspeed", xplmType_Float);
+    declare("sim/flightmodel/position/magnetic_variation", xplmType_Float, -2);
+    declare("sim/weather/wind_speed_kt", xplmType_Float);
+    declare("sim/weather/wind_direction_degt", xplmType_Float);
+    declare("sim/weather/barometer_sealevel_inhg", xplmType_Float, 29.92);
+    declare("sim/weather/temperature_ambient_c", xplmType_Float, 15);
+    declare("sim/weather/dewpoi_sealevel_c", xplmType_Float, 10);
+    declare("sim/weather/temperature_le_c", xplmType_Float, 15);
+    declare("sim/cockpit/autopilot/altitude", xplmType_Float);
+    declare("sim/cockpit/autopilot/airspeed", xplmType_Float);
+    declare("sim/cockpit/misc/barometer_setting", xplmType_Float, 29.92);
+    declare("sim/cockpit/radios/adf1_dir_degt", xplmType_Float);
+    declare("sim/cockpit/radios/adf2_dir_degt", xplmType_Float);
+    declare("sim/cockpit/radios/nav1_dme_dist_m", xplmType_Float);
+    declare("sim/cockpit/radios/nav2_dme_dist_m", xplmType_Float);
+    declare("sim/cockpit/radios/nav1_hdef_dot", xplmType_Float);
+    declare("sim/cockpit/radios/nav2_hdef_dot", xplmType_Float);
+    declare("sim/cockpit/radios/nav1_vdef_dot", xplmType_Float);
+    declare("sim/cockpit/autopilot/airspeed_is_mach", xplmType_Int);
+    declare("sim/cockpit2/EFIS/EFIS_1_selection_pilot", xplmType_Int, 1);
+    declare("sim/cockpit2/EFIS/EFIS_2_selection_pilot", xplmType_Int, 1);
+    declare("sim/cockpit/autopilot/autopilot_mode", xplmType_Int, 1);
+    declare("sim/cockpit/radios/nav1_freq_hz", xplmType_Int, 11030);
+    declare("sim/cockpit/radios/nav2_freq_hz", xplmType_Int, 11370);
+    declare("sim/cockpit/radios/adf1_freq_hz", xplmType_Int, 350);
+    declare("sim/cockpit/radios/adf2_freq_hz", xplmType_Int, 410);
+    declare("sim/cockpit/radios/nav1_fromto", xplmType_Int);
+    declare("sim/cockpit/radios/nav2_fromto", xplmType_Int);
+    declare("sim/cockpit/radios/nav1_has_dme", xplmType_Int);
+    declare("sim/cockpit/radios/nav2_has_dme", xplmType_Int);
+    declare("sim/cockpit/radios/nav1_obs_degm", xplmType_Float);
+    declare("sim/cockpit/radios/nav2_obs_degm", xplmType_Float);
+    declare("sim/cockpit/autopilot/flight_director_roll", xplmType_Float);
+    declare("sim/cockpit/autopilot/flight_director_pitch", xplmType_Float);
+    declare("sim/flightmodel/weight/m_total", xplmType_Float, 65000);
+    declare("sim/flightmodel/weight/m_fuel_total", xplmType_Float, 12000);
+    declare("sim/aircraft/weight/acf_m_fuel_tot", xplmType_Float, 19000);
+    declare("sim/flightmodel/engine/ENGN_N1_", xplmType_FloatArray, 20, no_of_engines);
+    declare("sim/flightmodel/engine/ENGN_N2_", xplmType_FloatArray, 60, no_of_engines);
+    declare("sim/flightmodel/engine/ENGN_EGT_c", xplmType_FloatArray, 400, no_of_engines);
+    declare("sim/flightmodel/engine/ENGN_FF_", xplmType_FloatArray, 0.1, no_of_engines);
+    declare("sim/cockpit/switches/anti_ice_engine_air", xplmType_FloatArray, 0, no_of_engines);
+    declare("sim/flightmodel2/engines/thrust_reverser_deploy_ratio", xplmType_FloatArray, 0, no_of_engines);
+    declare("sim/flightmodel/engine/ENGN_thro", xplmType_FloatArray, 0, no_of_engines);
+    declare("sim/aircraft/engine/acf_num_engines", xplmType_Int, no_of_engines);
+    declare("sim/cockpit/electrical/avionics_on", xplmType_Int, 1);
+    declare("sim/cockpit/electrical/battery_on", xplmType_Int, 1);
+    declare("sim/flightmodel/failures/onground_any", xplmType_Int, 1);
+    declare("sim/cockpit/electrical/beacon_lights_on", xplmType_Int, 1);
+    declare("sim/cockpit/electrical/strobe_lights_on", xplmType_Int);
+    declare("sim/cockpit/electrical/landing_lights_on", xplmType_Int);
+    declare("sim/cockpit/electrical/taxi_light_on", xplmType_Int);
+    declare("sim/cockpit/electrical/nav_lights_on", xplmType_Int, 1);
+    declare("sim/cockpit/switches/pitot_heat_on", xplmType_Int);
+    declare("sim/time/paused", xplmType_Int);
+    declare("sim/flightmodel/controls/parkbrake", xplmType_Float);
+    declare("sim/flightmodel2/gear/deploy_ratio", xplmType_FloatArray, 1, 3);
+    declare("sim/flightmodel/controls/flaprat", xplmType_Float);
+    declare("sim/flightmodel/controls/flaprqst", xplmType_Float);
+    declare("sim/operation/override/override_throttles", xplmType_Int);
+    declare("sim/flightmodel/engine/ENGN_thro_override", xplmType_Float);
+    declare("sim/aircraft/controls/acf_flap_detents", xplmType_Int, 4);
+    declare("sim/aircraft/controls/acf_flap_dn", xplmType_FloatArray, 0, 5);
+    declare("sim/cockpit2/controls/speedbrake_ratio", xplmType_Float);
+
+    Entry* flap_dn = find("sim/aircraft/controls/acf_flap_dn");
+    const float flap_degrees[5] = { 0, 5, 15, 25, 40 };
+    for (unsigned int i = 0 ; i < flap_dn->items.size() ; i++)
+        flap_dn->items[i] = flap_degrees[i];
+}
+
+StandinDataRefs::Entry* StandinDataRefs::find(const std::string& name)
+{
+    std::map<std::string, Entry>::iterator it = m_entries.find(name);
+    if (it == m_entries.end())
+        return 0;
+    return &it->second;
+}
+
+void StandinDataRefs::set(const std::string& name, double value)
+{
+    Entry* entry = find(name);
+    MYASSERT(entry != 0);
+    entry->value = value;
+}
+
+void StandinDataRefs::setItems(const std::string& name, float value)
+{
+    Entry* entry = find(name);
+    MYASSERT(entry != 0);
+    entry->items.assign(entry->items.size(), value);
+}
+
+double StandinDataRefs::value(const std::string& name)
+{
+    Entry* entry = find(name);
+    MYASSERT(entry != 0);
+    return entry->value;
+}
+
+// XPLMDataAccess functions used by SimData
+
+static StandinDataRefs::Entry* entry(XPLMDataRef dataref)
+{
+    MYASSERT(dataref != 0);
+    return static_cast<StandinDataRefs::Entry*>(dataref);
+}
+
+static long getItems(XPLMDataRef dataref, float* values, int offset, int max)
+{
+    std::vector<float>& items = entry(dataref)->items;
+    if (values == 0)
+        return items.size();
+    long n = 0;
+    for (int i = offset ; i < int(items.size()) && n < max ; i++, n++)
+        values[n] = items[i];
+    return n;
+}
+
+XPLMDataRef XPLMFindDataRef(const char* inDataRefName)
+{
+    StandinDataRefs::Entry* entry = StandinDataRefs::instance().find(inDataRefName);
+    if (entry == 0)
+        m_logfile << "XPLMFindDataRef: dataref " << inDataRefName << " was not declared" << std::endl;
+    return entry;
+}
+
+int XPLMCanWriteDataRef(XPLMDataRef inDataRef) { return entry(inDataRef)->writeable ? 1 : 0; }
+int XPLMIsDataRefGood(XPLMDataRef inDataRef) { return inDataRef != 0; }
+XPLMDataTypeID XPLMGetDataRefTypes(XPLMDataRef inDataRef) { return entry(inDataRef)->type; }
+
+int XPLMGetDatai(XPLMDataRef inDataRef) { return int(entry(inDataRef)->value); }
+void XPLMSetDatai(XPLMDataRef inDataRef, int inValue) { entry(inDataRef)->value = inValue; }
+float XPLMGetDataf(XPLMDataRef inDataRef) { return float(entry(inDataRef)->value); }
+void XPLMSetDataf(XPLMDataRef inDataRef, float inValue) { entry(inDataRef)->value = inValue; }
+double XPLMGetDatad(XPLMDataRef inDataRef) { return entry(inDataRef)->value; }
+void XPLMSetDatad(XPLMDataRef inDataRef, double inValue) { entry(inDataRef)->value = inValue; }
+
+long XPLMGetDatavf(XPLMDataRef inDataRef, float* outValues, int inOffset, int inMax)
+{
+    return getItems(inDataRef, outValues, inOffset, inMax);
+}
+
+void XPLMSetDatavf(XPLMDataRef inDataRef, float* inValues, int inoffset, int inCount)
+{
+    std::vector<float>& items = entry(inDataRef)->items;
+    for (int i = 0 ; i < inCount && inoffset + i < int(items.size()) ; i++)
+        items[inoffset + i] = inValues[i];
+}
+
+long XPLMGetDatavi(XPLMDataRef inDataRef, int* outValues, int inOffset, int inMax)
+{
+    std::vector<float>& items = entry(inDataRef)->items;
+    if (outValues == 0)
+        return items.size();
+    long n = 0;
+    for (int i = inOffset ; i < int(items.size()) && n < inMax ; i++, n++)
+        outValues[n] = int(items[i]);
+    return n;
+}
+
+void XPLMSetDatavi(XPLMDataRef inDataRef, int* inValues, int inoffset, int inCount)
+{
+    std::vector<float>& items = entry(inDataRef)->items;
+    for (int i = 0 ; i < inCount && inoffset + i < int(items.size()) ; i++)
+        items[inoffset + i] = float(inValues[i]);
+}
+
+long XPLMGetDatab(XPLMDataRef inDataRef, void* outValue, long inOffset, long inMaxBytes)
+{
+    std::string& bytes = entry(inDataRef)->bytes;
+    if (outValue == 0)
+        return bytes.size() + 1;
+    long n = 0;
+    for (long i = inOffset ; i <= long(bytes.size()) && n < inMaxBytes ; i++, n++)
+        static_cast<char*>(outValue)[n] = (i < long(bytes.size())) ? bytes[i] : 0;
+    return n;
+}
+
+void XPLMSetDatab(XPLMDataRef inDataRef, void* inValue, long inOffset, long inLength)
+{
+    std::string& bytes = entry(inDataRef)->bytes;
+    if (long(bytes.size()) < inOffset + inLength)
+        bytes.resize(inOffset + inLength);
+    memcpy(&bytes[inOffset], inValue, inLength);
+}
@@ -0,0 +1,66 @@
+#ifndef XPLM_STANDIN_H
+#define XPLM_STANDIN_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "XPLMDataAccess.h"
+
+/**
+  * In-memory replacement for the X-Plane dataref access, so SimData and DataContainer
+  * can be used outside of X-Plane. The XPLMDataAccess functions used by SimData are
+  * implemented on top of this table. All datarefs have to be declared with their X-Plane
+  * type before the SimData instances are created, the values are written by the flight script.
+  * @file xplm_standin.h
+  */
+class StandinDataRefs
+{
+public:
+
+    struct Entry
+    {
+        std::string name;
+        XPLMDataTypeID type;
+        bool writeable;
+        double value;
+        std::vector<float> items;
+        std::string bytes;
+    };
+
+    static StandinDataRefs& instance();
+
+    /**
+      * declare a dataref
+      * @param no_of_items number of items for array datarefs
+      */
+    void declare(const std::string& name, XPLMDataTypeID type, double value = 0.0,
+                 unsigned int no_of_items = 0, bool writeable = false);
+
+    /**
+      * declare all datarefs registered by addSimDataRefs() with the values of a parked twin jet
+      */
+    void declareSimDataRefs(unsigned int no_of_engines = 2);
+
+    /**
+      * @return the entry or 0 if the dataref was not declared
+      */
+    Entry* find(const std::string& name);
+
+    void set(const std::string& name, double value);
+
+    /**
+      * set all items of an array dataref
+      */
+    void setItems(const std::string& name, float value);
+
+    double value(const std::string& name);
+
+private:
+
+    StandinDataRefs() {}
+
+    std::map<std::string, Entry> m_entries;
+};
+
+#endif // XPLM_STANDIN_H